@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/cpu.hpp"
+#include "cbgb/memory.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Instructions per run. Pushes take the stack down by 2 KiB at most, and three
+// byte instructions stay well within the ROM.
+constexpr unsigned int STEPS = 1024;
+
+// Every byte of the ROM holds the opcode measured, so operands of longer
+// instructions are that opcode again, and it runs back to back through the
+// jump table. Stack and every register pair used as a pointer point into work
+// RAM, away from the code. Undefined opcodes are skipped.
+TEST_CASE("unsigned int Sm83::step()", "[bench][cpu]")
+{
+    spdlog::logger logger("bench");
+    auto bus = std::make_unique<cbgb::MemoryBus>(logger);
+    cbgb::Sm83 cpu(logger, *bus);
+    cbgb::Sm83Snapshot start = {};
+    cpu.save_state(start);
+    start.pc = 0x0000;
+    start.sp = 0xDFFE;
+    start.b = 0xC1;
+    start.d = 0xC2;
+    start.h = 0xC0;
+
+    for (unsigned int value = 0; value <= 0xFF; ++value) {
+        std::vector<uint8_t> rom(0x8000, static_cast<uint8_t>(value));
+        bus->load(0x0000, rom.data(), rom.size());
+        cpu.load_state(start);
+        try {
+            cpu.step();
+        }
+        catch (const cbgb::UndefinedOpcode&) {
+            continue;
+        }
+
+        BENCHMARK(fmt::format("Opcode {:02X}", value))
+        {
+            cpu.load_state(start);
+            unsigned int mcycles = 0;
+            for (unsigned int i = 0; i < STEPS; ++i)
+                mcycles += cpu.step();
+            return mcycles;
+        };
+    }
+}
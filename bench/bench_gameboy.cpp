@@ -0,0 +1,41 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/gameboy.hpp"
+#include "cbgb/workload.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Every run starts over from right after loading, since no workload lasts more
+// than a few frames before running off the ROM. Restoring the snapshot is a
+// 64 KiB copy, next to nothing beside a frame. Frames per second are the
+// inverse of the time reported.
+static void bench_frames(const char* name, cbgb::WorkloadMix mix)
+{
+    spdlog::logger logger("bench");
+    auto gameboy = std::make_unique<cbgb::GameBoy>(logger);
+    cbgb::WorkloadGenerator generator(cbgb::get_workload_histogram(mix), 1);
+    std::vector<uint8_t> rom = generator.generate_rom();
+    gameboy->load_rom(rom.data(), rom.size());
+    auto start = std::make_unique<cbgb::Snapshot>();
+    gameboy->save_state(*start);
+
+    BENCHMARK(name)
+    {
+        gameboy->load_state(*start);
+        gameboy->step_frame();
+        return gameboy->get_frame_count();
+    };
+}
+
+TEST_CASE("void GameBoy::step_frame()", "[bench][gameboy]")
+{
+    bench_frames("Frame of ALU", cbgb::WorkloadMix::ALU);
+    bench_frames("Frame of loads and stores", cbgb::WorkloadMix::LOAD_STORE);
+    bench_frames("Frame of (HL)", cbgb::WorkloadMix::INDIRECT);
+    bench_frames("Frame of stack", cbgb::WorkloadMix::STACK);
+}
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/gameboy.hpp"
+#include "cbgb/lockstep.hpp"
+#include "cbgb/workload.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Only the register to register instructions that the lockstep interpreter has
+// vector kernels for, other than those the generator leaves out anyway.
+static cbgb::OpcodeHistogram new_register_histogram()
+{
+    cbgb::OpcodeHistogram histogram = {};
+    for (unsigned int dst = 0; dst < 8; ++dst) {
+        for (unsigned int src = 0; src < 8; ++src) {
+            if (dst != 6 && src != 6)
+                histogram[0x40 | (dst << 3) | src] = 1;
+        }
+        if (dst != 6) {
+            histogram[0x04 | (dst << 3)] = 1;
+            histogram[0x05 | (dst << 3)] = 1;
+        }
+    }
+    for (unsigned int op = 0; op < 8; ++op) {
+        for (unsigned int src = 0; src < 8; ++src) {
+            if (src != 6)
+                histogram[0x80 | (op << 3) | src] = 1;
+        }
+    }
+    histogram[0x2F] = 1;
+    histogram[0x37] = 1;
+    histogram[0x3F] = 1;
+    return histogram;
+}
+
+// A full set of lanes runs the same ROM from the same state, which is the case
+// the lockstep interpreter is built for. Both sides restore every machine
+// before each frame, so they only differ in how the CPUs are stepped.
+static void bench_lockstep(const std::string& name, const cbgb::OpcodeHistogram& histogram)
+{
+    spdlog::logger logger("bench");
+    std::vector<uint8_t> rom = cbgb::WorkloadGenerator(histogram, 1).generate_rom();
+    std::vector<std::unique_ptr<cbgb::GameBoy>> machines;
+    std::vector<cbgb::GameBoy*> lanes;
+    for (unsigned int i = 0; i < cbgb::LOCKSTEP_LANES; ++i) {
+        machines.push_back(std::make_unique<cbgb::GameBoy>(logger));
+        machines.back()->load_rom(rom.data(), rom.size());
+        lanes.push_back(machines.back().get());
+    }
+    auto start = std::make_unique<cbgb::Snapshot>();
+    machines.front()->save_state(*start);
+
+    BENCHMARK(name + ", 32 scalar")
+    {
+        for (auto& machine : machines) {
+            machine->load_state(*start);
+            machine->step_frame();
+        }
+        return machines.back()->get_frame_count();
+    };
+
+    BENCHMARK(name + ", 32 lockstep")
+    {
+        for (auto& machine : machines)
+            machine->load_state(*start);
+        cbgb::LockstepSm83 lockstep(lanes);
+        lockstep.step_frame();
+        lockstep.sync();
+        return machines.back()->get_frame_count();
+    };
+}
+
+TEST_CASE("void LockstepSm83::step_frame()", "[bench][lockstep]")
+{
+    bench_lockstep("Register ops", new_register_histogram());
+    bench_lockstep("ALU", cbgb::get_workload_histogram(cbgb::WorkloadMix::ALU));
+}
@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/memory.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Accesses per run, a whole 4 KiB bank of work RAM.
+constexpr size_t ACCESSES = 0x1000;
+
+// Operands come out of memory, so that no loop can be folded into a constant.
+static std::vector<uint8_t> new_operands()
+{
+    std::vector<uint8_t> operands(ACCESSES);
+    for (size_t i = 0; i < operands.size(); ++i)
+        operands[i] = static_cast<uint8_t>(i * 37 + 11);
+    return operands;
+}
+
+TEST_CASE("MemoryBus::read and MemoryBus::write", "[bench][memory]")
+{
+    spdlog::logger logger("bench");
+    auto bus = std::make_unique<cbgb::MemoryBus>(logger);
+    std::vector<uint8_t> operands = new_operands();
+
+    BENCHMARK("Read WRAM")
+    {
+        unsigned int sum = 0;
+        for (size_t i = 0; i < ACCESSES; ++i)
+            sum += bus->read(static_cast<uint16_t>(0xC000 + i));
+        return sum;
+    };
+
+    BENCHMARK("Write WRAM")
+    {
+        for (size_t i = 0; i < ACCESSES; ++i)
+            bus->write(static_cast<uint16_t>(0xC000 + i), operands[i]);
+        return bus->read(0xC000);
+    };
+
+    // Also marks tiles dirty for the caches of the PPU.
+    BENCHMARK("Write VRAM")
+    {
+        for (size_t i = 0; i < ACCESSES; ++i)
+            bus->write(static_cast<uint16_t>(0x8000 + i), operands[i]);
+        return bus->read(0x8000);
+    };
+
+    BENCHMARK("Read HRAM")
+    {
+        unsigned int sum = 0;
+        for (size_t i = 0; i < ACCESSES; ++i)
+            sum += bus->read(static_cast<uint16_t>(0xFF80 + i % 0x7F));
+        return sum;
+    };
+}
+
+// Each wrapper against the same operation on a plain integer, to keep the
+// wrappers honest about being free.
+TEST_CASE("Register wrappers against raw integers", "[bench][register]")
+{
+    std::vector<uint8_t> operands = new_operands();
+
+    BENCHMARK("Register<uint8_t> add")
+    {
+        cbgb::Register<uint8_t> reg(0x00);
+        for (uint8_t operand : operands)
+            reg = static_cast<uint8_t>(reg + operand);
+        return static_cast<uint8_t>(reg);
+    };
+
+    BENCHMARK("uint8_t add")
+    {
+        uint8_t raw = 0x00;
+        for (uint8_t operand : operands)
+            raw = static_cast<uint8_t>(raw + operand);
+        return raw;
+    };
+
+    BENCHMARK("RegisterPair<uint16_t, uint8_t> add")
+    {
+        cbgb::Register<uint8_t> high(0x00);
+        cbgb::Register<uint8_t> low(0x00);
+        cbgb::RegisterPair<uint16_t, uint8_t> pair(high, low);
+        for (uint8_t operand : operands)
+            pair = static_cast<uint16_t>(pair + operand);
+        return static_cast<uint16_t>(pair);
+    };
+
+    BENCHMARK("uint16_t add")
+    {
+        uint16_t raw = 0x0000;
+        for (uint8_t operand : operands)
+            raw = static_cast<uint16_t>(raw + operand);
+        return raw;
+    };
+
+    BENCHMARK("RegisterBitField<4, 1, uint8_t> set and get")
+    {
+        cbgb::Register<uint8_t> reg(0x00);
+        cbgb::RegisterBitField<4, 1, uint8_t> field(reg);
+        unsigned int count = 0;
+        for (uint8_t operand : operands) {
+            field = operand;
+            count += field;
+        }
+        return count;
+    };
+
+    BENCHMARK("uint8_t mask set and get")
+    {
+        uint8_t raw = 0x00;
+        unsigned int count = 0;
+        for (uint8_t operand : operands) {
+            raw = static_cast<uint8_t>((raw & ~0x10) | ((operand & 0x01) << 4));
+            count += (raw >> 4) & 0x01U;
+        }
+        return count;
+    };
+}
@@ -0,0 +1,471 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <spdlog/logger.h>
+
+#include "cbgb-c/cbgb.h"
+#include "cbgb/apu.hpp"
+#include "cbgb/arena.hpp"
+#include "cbgb/cpu.hpp"
+#include "cbgb/gameboy.hpp"
+#include "cbgb/memory.hpp"
+#include "cbgb/thread_pool.hpp"
+#include "cbgb/vector_env.hpp"
+#include "cbgb/video.hpp"
+
+static_assert(CBGB_SCREEN_WIDTH == cbgb::SCREEN_WIDTH);
+static_assert(CBGB_SCREEN_HEIGHT == cbgb::SCREEN_HEIGHT);
+static_assert(CBGB_MEMORY_SIZE == sizeof(cbgb::MemoryImage));
+static_assert(static_cast<int>(CBGB_BUTTON_RIGHT) == static_cast<int>(cbgb::JOYPAD_RIGHT));
+static_assert(static_cast<int>(CBGB_BUTTON_START) == static_cast<int>(cbgb::JOYPAD_START));
+
+// Every instance lives in its own arena, so the machine state of one instance
+// is a single contiguous block.
+struct cbgb_instance {
+    explicit cbgb_instance(spdlog::logger& logger)
+        : memory(cbgb::Arena::required<cbgb::GameBoy>())
+        , arena(memory.data(), memory.size())
+        , gameboy(arena.create<cbgb::GameBoy>(logger))
+        , halted(false)
+    {
+    }
+
+    cbgb::ArenaMemory memory;
+    cbgb::Arena arena;
+    cbgb::ArenaPtr<cbgb::GameBoy> gameboy;
+    std::vector<int16_t> audio;
+    std::string error;
+    bool halted;
+};
+
+namespace {
+// Embedders have no use for the core's log output, so it goes to a logger
+// without any sinks.
+spdlog::logger& core_logger()
+{
+    static spdlog::logger logger("cbgb");
+    return logger;
+}
+
+cbgb::ThreadPool& batch_pool()
+{
+    static cbgb::ThreadPool pool;
+    return pool;
+}
+
+cbgb_status fail(cbgb_instance* instance, cbgb_status status, const char* what)
+{
+    try {
+        instance->error = what;
+    }
+    catch (const std::bad_alloc&) {
+        instance->error.clear();
+    }
+    return status;
+}
+
+// Takes every sample of the frame out of the APU, which only keeps a few
+// frames worth of its own.
+void collect_audio(cbgb_instance* instance)
+{
+    constexpr size_t chunk = 1024;
+    cbgb::Apu& apu = instance->gameboy->get_apu();
+    size_t size = instance->audio.size();
+    size_t count = 0;
+    do {
+        instance->audio.resize(size + chunk * 2);
+        count = apu.read_samples(instance->audio.data() + size, chunk);
+        size += count * 2;
+    } while (count == chunk);
+    instance->audio.resize(size);
+}
+
+cbgb_status step_frames(cbgb_instance* instance, uint32_t frames)
+{
+    instance->audio.clear();
+    if (instance->halted)
+        return CBGB_ERROR_UNDEFINED_OPCODE;
+
+    try {
+        for (uint32_t i = 0; i < frames; ++i) {
+            instance->gameboy->step_frame();
+            collect_audio(instance);
+        }
+    }
+    catch (const cbgb::UndefinedOpcode& error) {
+        instance->halted = true;
+        return fail(instance, CBGB_ERROR_UNDEFINED_OPCODE, error.what());
+    }
+    catch (const std::bad_alloc& error) {
+        return fail(instance, CBGB_ERROR_OUT_OF_MEMORY, error.what());
+    }
+    catch (const std::exception& error) {
+        return fail(instance, CBGB_ERROR_UNKNOWN, error.what());
+    }
+    return CBGB_OK;
+}
+} // namespace
+
+uint32_t cbgb_get_api_version(void)
+{
+    return CBGB_API_VERSION;
+}
+
+cbgb_instance* cbgb_create(void)
+{
+    try {
+        return new cbgb_instance(core_logger());
+    }
+    catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+void cbgb_destroy(cbgb_instance* instance)
+{
+    delete instance;
+}
+
+cbgb_status cbgb_load_rom(cbgb_instance* instance, const uint8_t* data, size_t size)
+{
+    if (instance == nullptr)
+        return CBGB_ERROR_INVALID_ARGUMENT;
+    if (data == nullptr && size != 0)
+        return fail(instance, CBGB_ERROR_INVALID_ARGUMENT, "ROM data is NULL");
+
+    instance->gameboy->load_rom(data, size);
+    return CBGB_OK;
+}
+
+cbgb_status cbgb_step_frames(cbgb_instance* instance, uint32_t frames)
+{
+    if (instance == nullptr)
+        return CBGB_ERROR_INVALID_ARGUMENT;
+    return step_frames(instance, frames);
+}
+
+void cbgb_set_input(cbgb_instance* instance, uint8_t buttons)
+{
+    if (instance != nullptr)
+        instance->gameboy->set_joypad(buttons);
+}
+
+void cbgb_set_pixel_fifo(cbgb_instance* instance, int enabled)
+{
+    if (instance == nullptr)
+        return;
+    instance->gameboy->get_ppu().set_accuracy(
+        enabled != 0 ? cbgb::PpuAccuracy::PIXEL_FIFO : cbgb::PpuAccuracy::SCANLINE
+    );
+}
+
+void cbgb_set_render_skip(cbgb_instance* instance, int enabled)
+{
+    if (instance != nullptr)
+        instance->gameboy->set_render_skip(enabled != 0);
+}
+
+const uint8_t* cbgb_get_framebuffer(const cbgb_instance* instance)
+{
+    if (instance == nullptr)
+        return nullptr;
+    return instance->gameboy->get_frame().data();
+}
+
+const int16_t* cbgb_get_audio(const cbgb_instance* instance, size_t* frames)
+{
+    if (frames != nullptr)
+        *frames = instance != nullptr ? instance->audio.size() / 2 : 0;
+    if (instance == nullptr)
+        return nullptr;
+    return instance->audio.data();
+}
+
+const uint8_t* cbgb_get_memory(const cbgb_instance* instance)
+{
+    if (instance == nullptr)
+        return nullptr;
+    return instance->gameboy->get_memory().get_image().data();
+}
+
+uint64_t cbgb_get_frame_count(const cbgb_instance* instance)
+{
+    if (instance == nullptr)
+        return 0;
+    return instance->gameboy->get_frame_count();
+}
+
+const char* cbgb_get_error(const cbgb_instance* instance)
+{
+    if (instance == nullptr)
+        return "";
+    return instance->error.c_str();
+}
+
+cbgb_status cbgb_create_batch(cbgb_instance** instances, size_t count)
+{
+    if (instances == nullptr && count != 0)
+        return CBGB_ERROR_INVALID_ARGUMENT;
+
+    for (size_t i = 0; i < count; ++i) {
+        instances[i] = cbgb_create();
+        if (instances[i] == nullptr) {
+            cbgb_destroy_batch(instances, i);
+            return CBGB_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    return CBGB_OK;
+}
+
+void cbgb_destroy_batch(cbgb_instance** instances, size_t count)
+{
+    if (instances == nullptr)
+        return;
+
+    for (size_t i = 0; i < count; ++i) {
+        cbgb_destroy(instances[i]);
+        instances[i] = nullptr;
+    }
+}
+
+cbgb_status cbgb_load_rom_batch(
+    cbgb_instance** instances, size_t count, const uint8_t* data, size_t size
+)
+{
+    if (instances == nullptr && count != 0)
+        return CBGB_ERROR_INVALID_ARGUMENT;
+
+    cbgb_status result = CBGB_OK;
+    for (size_t i = 0; i < count; ++i) {
+        cbgb_status status = cbgb_load_rom(instances[i], data, size);
+        if (result == CBGB_OK)
+            result = status;
+    }
+    return result;
+}
+
+// One task per instance. Instances are independent, and a single frame is
+// already tens of thousands of instructions, so finer splitting buys nothing.
+cbgb_status cbgb_step_frames_batch(
+    cbgb_instance** instances, size_t count, uint32_t frames, cbgb_status* statuses
+)
+{
+    if (instances == nullptr && count != 0)
+        return CBGB_ERROR_INVALID_ARGUMENT;
+    for (size_t i = 0; i < count; ++i) {
+        if (instances[i] == nullptr)
+            return CBGB_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::vector<cbgb_status> results;
+    try {
+        results.resize(count, CBGB_OK);
+        cbgb::ThreadPool& pool = batch_pool();
+        for (size_t i = 0; i < count; ++i) {
+            cbgb_instance* instance = instances[i];
+            cbgb_status* result = &results[i];
+            pool.submit([instance, frames, result] { *result = step_frames(instance, frames); });
+        }
+        pool.wait();
+    }
+    catch (const std::bad_alloc&) {
+        return CBGB_ERROR_OUT_OF_MEMORY;
+    }
+    catch (const std::exception&) {
+        return CBGB_ERROR_UNKNOWN;
+    }
+
+    cbgb_status first = CBGB_OK;
+    for (size_t i = 0; i < count; ++i) {
+        if (statuses != nullptr)
+            statuses[i] = results[i];
+        if (first == CBGB_OK)
+            first = results[i];
+    }
+    return first;
+}
+
+void cbgb_set_input_batch(cbgb_instance** instances, size_t count, const uint8_t* buttons)
+{
+    if (instances == nullptr || buttons == nullptr)
+        return;
+
+    for (size_t i = 0; i < count; ++i)
+        cbgb_set_input(instances[i], buttons[i]);
+}
+
+void cbgb_get_framebuffer_batch(
+    cbgb_instance* const* instances, size_t count, const uint8_t** framebuffers
+)
+{
+    if (instances == nullptr || framebuffers == nullptr)
+        return;
+
+    for (size_t i = 0; i < count; ++i)
+        framebuffers[i] = cbgb_get_framebuffer(instances[i]);
+}
+
+struct cbgb_vector_env {
+    cbgb_vector_env(
+        spdlog::logger& logger, size_t count, const uint8_t* data, size_t size, uint32_t threads
+    )
+        : env(logger, count, data, size, threads)
+    {
+    }
+
+    cbgb::VectorEnv env;
+    std::string error;
+};
+
+cbgb_vector_env* cbgb_vector_env_create(
+    size_t count, const uint8_t* data, size_t size, uint32_t threads
+)
+{
+    if (data == nullptr && size != 0)
+        return nullptr;
+
+    try {
+        return new cbgb_vector_env(core_logger(), count, data, size, threads);
+    }
+    catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+void cbgb_vector_env_destroy(cbgb_vector_env* env)
+{
+    delete env;
+}
+
+void cbgb_vector_env_set_callbacks(
+    cbgb_vector_env* env, cbgb_reward_fn reward, cbgb_done_fn done, void* user
+)
+{
+    if (env == nullptr)
+        return;
+
+    if (reward != nullptr) {
+        env->env.set_reward([reward, user](size_t index, const cbgb::MemoryImage& memory) {
+            return reward(index, memory.data(), user);
+        });
+    }
+    else {
+        env->env.set_reward(nullptr);
+    }
+
+    if (done != nullptr) {
+        env->env.set_done([done, user](size_t index, const cbgb::MemoryImage& memory) {
+            return done(index, memory.data(), user) != 0;
+        });
+    }
+    else {
+        env->env.set_done(nullptr);
+    }
+}
+
+void cbgb_vector_env_observe_frame(cbgb_vector_env* env)
+{
+    if (env != nullptr)
+        env->env.observe_frame();
+}
+
+cbgb_status cbgb_vector_env_observe_memory(cbgb_vector_env* env, uint16_t address, size_t size)
+{
+    if (env == nullptr)
+        return CBGB_ERROR_INVALID_ARGUMENT;
+
+    try {
+        env->env.observe_memory(address, size);
+    }
+    catch (const std::out_of_range& error) {
+        env->error = error.what();
+        return CBGB_ERROR_INVALID_ARGUMENT;
+    }
+    return CBGB_OK;
+}
+
+cbgb_status cbgb_vector_env_observe_scaled(
+    cbgb_vector_env* env, uint32_t width, uint32_t height, int grayscale
+)
+{
+    if (env == nullptr)
+        return CBGB_ERROR_INVALID_ARGUMENT;
+
+    try {
+        cbgb::PixelFormat format
+            = grayscale != 0 ? cbgb::PixelFormat::GRAYSCALE : cbgb::PixelFormat::SHADE;
+        env->env.observe_scaled(width, height, format);
+    }
+    catch (const std::invalid_argument& error) {
+        env->error = error.what();
+        return CBGB_ERROR_INVALID_ARGUMENT;
+    }
+    catch (const std::bad_alloc& error) {
+        env->error = error.what();
+        return CBGB_ERROR_OUT_OF_MEMORY;
+    }
+    return CBGB_OK;
+}
+
+size_t cbgb_vector_env_get_observation_size(const cbgb_vector_env* env)
+{
+    if (env == nullptr)
+        return 0;
+    return env->env.get_observation_size();
+}
+
+cbgb_status cbgb_vector_env_reset(cbgb_vector_env* env, uint8_t* observations)
+{
+    if (env == nullptr)
+        return CBGB_ERROR_INVALID_ARGUMENT;
+
+    try {
+        env->env.reset(observations);
+    }
+    catch (const std::exception& error) {
+        env->error = error.what();
+        return CBGB_ERROR_UNKNOWN;
+    }
+    return CBGB_OK;
+}
+
+cbgb_status cbgb_vector_env_step(
+    cbgb_vector_env* env,
+    const uint8_t* actions,
+    uint32_t frames,
+    uint8_t* observations,
+    float* rewards,
+    uint8_t* dones
+)
+{
+    if (env == nullptr)
+        return CBGB_ERROR_INVALID_ARGUMENT;
+
+    try {
+        env->env.step(actions, frames, observations, rewards, dones);
+    }
+    catch (const std::bad_alloc& error) {
+        env->error = error.what();
+        return CBGB_ERROR_OUT_OF_MEMORY;
+    }
+    catch (const std::exception& error) {
+        env->error = error.what();
+        return CBGB_ERROR_UNKNOWN;
+    }
+    return CBGB_OK;
+}
+
+const char* cbgb_vector_env_get_error(const cbgb_vector_env* env)
+{
+    if (env == nullptr)
+        return "";
+    return env->error.c_str();
+}
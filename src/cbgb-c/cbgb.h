@@ -0,0 +1,241 @@
+/* SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file
+ * @brief C interface to the cbgb emulation core.
+ *
+ * Meant for embedding the core into other languages through their C FFI. Every
+ * machine is an opaque #cbgb_instance handle. Frame and memory accessors hand
+ * out pointers straight into the machine, so nothing is copied across the
+ * boundary. Those pointers stay valid until the instance is destroyed, and
+ * their contents change whenever the instance is stepped.
+ *
+ * Functions that can fail return a #cbgb_status, and leave a message that
+ * can be fetched with cbgb_get_error(). No C++ exception ever escapes.
+ *
+ * The batch variants operate on arrays of handles, and step them in parallel
+ * on a thread pool shared by the whole process.
+ */
+
+#ifndef CBGB_H
+#define CBGB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(CBGB_C_BUILD)
+#define CBGB_API __declspec(dllexport)
+#else
+#define CBGB_API __declspec(dllimport)
+#endif
+#elif defined(__GNUC__)
+#define CBGB_API __attribute__((visibility("default")))
+#else
+#define CBGB_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Bumped whenever the interface changes incompatibly. */
+#define CBGB_API_VERSION 1
+
+#define CBGB_SCREEN_WIDTH 160
+#define CBGB_SCREEN_HEIGHT 144
+#define CBGB_MEMORY_SIZE 65536
+
+/** @brief Joypad button bits, a set bit means the button is held down. */
+enum cbgb_button {
+    CBGB_BUTTON_RIGHT = 1 << 0,
+    CBGB_BUTTON_LEFT = 1 << 1,
+    CBGB_BUTTON_UP = 1 << 2,
+    CBGB_BUTTON_DOWN = 1 << 3,
+    CBGB_BUTTON_A = 1 << 4,
+    CBGB_BUTTON_B = 1 << 5,
+    CBGB_BUTTON_SELECT = 1 << 6,
+    CBGB_BUTTON_START = 1 << 7
+};
+
+typedef enum cbgb_status {
+    CBGB_OK = 0,
+    CBGB_ERROR_INVALID_ARGUMENT = 1,
+    CBGB_ERROR_OUT_OF_MEMORY = 2,
+    CBGB_ERROR_UNDEFINED_OPCODE = 3,
+    CBGB_ERROR_UNKNOWN = 4
+} cbgb_status;
+
+typedef struct cbgb_instance cbgb_instance;
+
+CBGB_API uint32_t cbgb_get_api_version(void);
+
+/** @brief Create a powered on machine with no cartridge, NULL on failure. */
+CBGB_API cbgb_instance* cbgb_create(void);
+CBGB_API void cbgb_destroy(cbgb_instance* instance);
+
+/** @brief Map a cartridge ROM image, the buffer is copied. */
+CBGB_API cbgb_status cbgb_load_rom(cbgb_instance* instance, const uint8_t* data, size_t size);
+
+/**
+ * @brief Run the machine for a number of whole frames.
+ *
+ * A machine that hit an undefined opcode stays halted, and keeps failing with
+ * #CBGB_ERROR_UNDEFINED_OPCODE.
+ */
+CBGB_API cbgb_status cbgb_step_frames(cbgb_instance* instance, uint32_t frames);
+
+/** @brief Set held buttons as a mask of #cbgb_button bits. */
+CBGB_API void cbgb_set_input(cbgb_instance* instance, uint8_t buttons);
+
+/**
+ * @brief Draw with the dot accurate pixel FIFO instead of whole scanlines.
+ *
+ * Needed for games that change LCD registers in the middle of a line, at the
+ * cost of speed. Loading a ROM known to need it turns it on by itself.
+ */
+CBGB_API void cbgb_set_pixel_fifo(cbgb_instance* instance, int enabled);
+
+/**
+ * @brief Keep timing and interrupts going without drawing frames.
+ *
+ * For frames that are never looked at, such as fast forward or runs that only
+ * check memory. The framebuffer keeps the last frame drawn before.
+ */
+CBGB_API void cbgb_set_render_skip(cbgb_instance* instance, int enabled);
+
+/**
+ * @brief Shade indices (0-3) of the last frame.
+ *
+ * Row major, CBGB_SCREEN_WIDTH * CBGB_SCREEN_HEIGHT bytes.
+ */
+CBGB_API const uint8_t* cbgb_get_framebuffer(const cbgb_instance* instance);
+
+/**
+ * @brief Interleaved stereo samples produced by the last step.
+ *
+ * Left first, at 48000 Hz. Valid until the instance is stepped again.
+ */
+CBGB_API const int16_t* cbgb_get_audio(const cbgb_instance* instance, size_t* frames);
+
+/** @brief Raw view of the whole 16-bit address space, CBGB_MEMORY_SIZE bytes. */
+CBGB_API const uint8_t* cbgb_get_memory(const cbgb_instance* instance);
+
+CBGB_API uint64_t cbgb_get_frame_count(const cbgb_instance* instance);
+
+/** @brief Message of the last failure on this instance, empty if none. */
+CBGB_API const char* cbgb_get_error(const cbgb_instance* instance);
+
+/**
+ * @brief Create `count` machines into `instances`.
+ *
+ * Either every machine is created, or none are and an error is returned.
+ */
+CBGB_API cbgb_status cbgb_create_batch(cbgb_instance** instances, size_t count);
+CBGB_API void cbgb_destroy_batch(cbgb_instance** instances, size_t count);
+CBGB_API cbgb_status cbgb_load_rom_batch(
+    cbgb_instance** instances, size_t count, const uint8_t* data, size_t size
+);
+
+/**
+ * @brief Run every machine for a number of whole frames in parallel.
+ *
+ * Returns the first failure, if any. Per machine results are written to
+ * `statuses` unless it is NULL.
+ */
+CBGB_API cbgb_status cbgb_step_frames_batch(
+    cbgb_instance** instances, size_t count, uint32_t frames, cbgb_status* statuses
+);
+
+/** @brief Set held buttons of every machine, one mask per machine. */
+CBGB_API void cbgb_set_input_batch(
+    cbgb_instance** instances, size_t count, const uint8_t* buttons
+);
+
+/** @brief Fetch the frame buffer pointer of every machine. */
+CBGB_API void cbgb_get_framebuffer_batch(
+    cbgb_instance* const* instances, size_t count, const uint8_t** framebuffers
+);
+
+/**
+ * @brief Vector environment stepping many machines running one ROM.
+ *
+ * Observations of all machines go to one contiguous caller owned array of
+ * `count * cbgb_vector_env_get_observation_size()` bytes. Frame observations
+ * are laid out as `[machine][row][column]`.
+ */
+typedef struct cbgb_vector_env cbgb_vector_env;
+
+/**
+ * @brief Reward of machine `index`, given its raw address space.
+ *
+ * Called from worker threads, concurrently for different machines.
+ */
+typedef float (*cbgb_reward_fn)(size_t index, const uint8_t* memory, void* user);
+
+/** @brief Nonzero if the episode of machine `index` ended. */
+typedef int (*cbgb_done_fn)(size_t index, const uint8_t* memory, void* user);
+
+/**
+ * @brief Create `count` machines running a copy of the ROM.
+ *
+ * Zero threads means one worker per core. Returns NULL on failure.
+ */
+CBGB_API cbgb_vector_env* cbgb_vector_env_create(
+    size_t count, const uint8_t* data, size_t size, uint32_t threads
+);
+CBGB_API void cbgb_vector_env_destroy(cbgb_vector_env* env);
+
+/** @brief Either callback may be NULL, for no reward or endless episodes. */
+CBGB_API void cbgb_vector_env_set_callbacks(
+    cbgb_vector_env* env, cbgb_reward_fn reward, cbgb_done_fn done, void* user
+);
+
+/** @brief Observe frame buffers, the default. */
+CBGB_API void cbgb_vector_env_observe_frame(cbgb_vector_env* env);
+
+/** @brief Observe `size` bytes of memory starting at `address` instead. */
+CBGB_API cbgb_status cbgb_vector_env_observe_memory(
+    cbgb_vector_env* env, uint16_t address, size_t size
+);
+
+/**
+ * @brief Observe frames downscaled to `width` by `height` instead.
+ *
+ * Grayscale frames are area averaged, with white at 255. Otherwise frames hold
+ * shade indices (0-3) sampled at the nearest source pixel.
+ */
+CBGB_API cbgb_status cbgb_vector_env_observe_scaled(
+    cbgb_vector_env* env, uint32_t width, uint32_t height, int grayscale
+);
+
+CBGB_API size_t cbgb_vector_env_get_observation_size(const cbgb_vector_env* env);
+
+/** @brief Reset every machine to power on, and write its first observation. */
+CBGB_API cbgb_status cbgb_vector_env_reset(cbgb_vector_env* env, uint8_t* observations);
+
+/**
+ * @brief Step every machine with its own joypad mask.
+ *
+ * Machines whose episode ended are reset, and report the first observation of
+ * their next episode. `rewards` and `dones` may be NULL.
+ */
+CBGB_API cbgb_status cbgb_vector_env_step(
+    cbgb_vector_env* env,
+    const uint8_t* actions,
+    uint32_t frames,
+    uint8_t* observations,
+    float* rewards,
+    uint8_t* dones
+);
+
+/** @brief Message of the last failure on this environment, empty if none. */
+CBGB_API const char* cbgb_vector_env_get_error(const cbgb_vector_env* env);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CBGB_H */
@@ -0,0 +1,472 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <spdlog/logger.h>
+
+#include "cbgb/apu.hpp"
+#include "cbgb/blip_buffer.hpp"
+#include "cbgb/memory.hpp"
+#include "cbgb/trace.hpp"
+
+namespace cbgb {
+// The frame sequencer ticks at 512 Hz, and every tick closes a time frame of
+// the blip buffers.
+constexpr uint32_t SEQUENCER_PERIOD = APU_CLOCK_RATE / 512;
+
+// Four channels at full volume on both master volume and amplitude come up to
+// 4 * 15 * 8 * 64 = 30720, just within 16 bits.
+constexpr int32_t LEVEL_SCALE = 64;
+
+// Catches up at least once every video frame, even with nobody reading any
+// samples, to keep the count of cycles pending small.
+constexpr uint32_t MAX_PENDING = 70224;
+
+constexpr size_t NOISE = 3;
+constexpr size_t WAVE = 2;
+constexpr uint8_t APU_ENABLE = 1 << 7;
+constexpr uint8_t LENGTH_ENABLE = 1 << 6;
+constexpr uint8_t TRIGGER = 1 << 7;
+
+// Output of every step of the four duty cycles, one bit per step.
+constexpr std::array<uint8_t, 4> DUTY_CYCLES = { 0x01, 0x81, 0x87, 0x7E };
+
+// Bits of NR10 through $FF2F that always read back as set.
+constexpr std::array<uint8_t, 32> READ_MASKS = {
+    0x80, 0x3F, 0x00, 0xFF, 0xBF, 0xFF, 0x3F, 0x00, 0xFF, 0xBF, 0x7F, 0xFF, 0x9F, 0xFF, 0xBF, 0xFF,
+    0xFF, 0x00, 0x00, 0xBF, 0x00, 0x00, 0x70, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+// Registers as the boot ROM leaves them, once its chime has faded out.
+constexpr std::array<uint8_t, 32> BOOT_REGISTERS = {
+    0x80, 0xBF, 0xF3, 0xFF, 0xBF, 0xFF, 0x3F, 0x00, 0xFF, 0xBF, 0x7F, 0xFF, 0x9F, 0xFF, 0xBF, 0xFF,
+    0xFF, 0x00, 0x00, 0xBF, 0x77, 0xF3, 0xF1, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+// Every channel has five registers, starting at NR10.
+static uint16_t channel_register(size_t index, size_t offset)
+{
+    return static_cast<uint16_t>(NR10 + index * 5 + offset);
+}
+
+Apu::Apu(spdlog::logger& logger, MemoryBus& bus)
+    : m_logger(logger)
+    , m_bus(bus)
+    , m_left(APU_CLOCK_RATE, APU_SAMPLE_RATE)
+    , m_right(APU_CLOCK_RATE, APU_SAMPLE_RATE)
+    , m_channels()
+    , m_clock(0)
+    , m_frame_start(0)
+    , m_pending(0)
+    , m_lfsr(0x7FFF)
+    , m_shadow(0)
+    , m_sweep_timer(0)
+    , m_sequencer_step(0)
+    , m_sweep_enabled(false)
+{
+    for (size_t i = 0; i < BOOT_REGISTERS.size(); ++i)
+        m_bus.store(static_cast<uint16_t>(NR10 + i), BOOT_REGISTERS[i] | READ_MASKS[i]);
+    m_channels[0].enabled = true;
+    m_logger.trace("Construct new APU");
+}
+
+// Only counts the cycles, the channels catch up once it matters.
+void Apu::advance(unsigned int mcycles)
+{
+    m_pending += mcycles * 4;
+    if (m_pending >= MAX_PENDING)
+        sync();
+}
+
+// Runs the channels up to the present, one sequencer tick at a time.
+void Apu::sync()
+{
+    while (m_pending > 0) {
+        uint32_t end = std::min(m_clock + m_pending, SEQUENCER_PERIOD);
+        run_channels(end);
+        m_pending -= end - m_clock;
+        m_clock = end;
+        if (m_clock == SEQUENCER_PERIOD) {
+            clock_sequencer();
+            end_frame();
+            m_clock = 0;
+            m_frame_start = 0;
+        }
+    }
+}
+
+// Catches up first, so that the write lands at the right time. Registers store
+// the value they read back as, the APU keeps its own copy of the rest.
+void Apu::write(uint16_t address, uint8_t value)
+{
+    sync();
+    if (address >= WAVE_RAM) {
+        m_bus.store(address, value);
+        return;
+    }
+
+    const MemoryImage& image = m_bus.get_image();
+    bool powered = (image[NR52] & APU_ENABLE) != 0;
+    if (address == NR52) {
+        if ((value & APU_ENABLE) == 0 && powered)
+            power_off();
+        else if ((value & APU_ENABLE) != 0 && !powered)
+            m_sequencer_step = 0;
+        m_bus.store(NR52, static_cast<uint8_t>((value & APU_ENABLE) | 0x70 | (image[NR52] & 0x0F)));
+        return;
+    }
+
+    // Every other register ignores writes while the APU is off.
+    if (!powered)
+        return;
+    size_t offset = address - NR10;
+    m_bus.store(address, value | READ_MASKS[offset]);
+    if (address == NR50 || address == NR51) {
+        for (size_t i = 0; i < m_channels.size(); ++i)
+            update_levels(i, m_clock);
+        return;
+    }
+    if (address > NR44)
+        return;
+
+    size_t index = offset / 5;
+    ApuChannel& channel = m_channels[index];
+    switch (offset % 5) {
+    case 0:
+        if (index == WAVE && !has_dac(WAVE))
+            set_enabled(WAVE, false);
+        break;
+    case 1:
+        channel.length = static_cast<uint16_t>(index == WAVE ? 256 - value : 64 - (value & 0x3F));
+        break;
+    case 2:
+        if (index != WAVE && !has_dac(index))
+            set_enabled(index, false);
+        break;
+    case 3:
+        if (index != NOISE)
+            channel.frequency = static_cast<uint16_t>((channel.frequency & 0x700) | value);
+        break;
+    case 4:
+        if (index != NOISE) {
+            unsigned int high = (value & 7u) << 8;
+            channel.frequency = static_cast<uint16_t>((channel.frequency & 0xFF) | high);
+        }
+        if ((value & TRIGGER) != 0)
+            trigger(index);
+        break;
+    }
+}
+
+// Reads up to `frames` stereo samples, left first, up to the present.
+size_t Apu::read_samples(int16_t* samples, size_t frames)
+{
+    CBGB_TRACE_SCOPE("APU fill");
+    sync();
+    end_frame();
+    size_t count = m_left.read_samples(samples, frames, 2);
+    m_right.read_samples(samples + 1, count, 2);
+    return count;
+}
+
+// Stereo samples ready to read, without catching up first.
+size_t Apu::get_available_samples() const
+{
+    return m_left.get_available();
+}
+
+// Closes the current time frame first, so that the new rate only applies to
+// what comes after.
+void Apu::set_sample_rate(uint32_t sample_rate)
+{
+    end_frame();
+    m_left.set_sample_rate(sample_rate);
+    m_right.set_sample_rate(sample_rate);
+}
+
+void Apu::save_state(ApuSnapshot& snapshot) const
+{
+    snapshot.channels = m_channels;
+    m_left.save_state(snapshot.left);
+    m_right.save_state(snapshot.right);
+    snapshot.clock = m_clock;
+    snapshot.frame_start = m_frame_start;
+    snapshot.pending = m_pending;
+    snapshot.lfsr = m_lfsr;
+    snapshot.shadow = m_shadow;
+    snapshot.sweep_timer = m_sweep_timer;
+    snapshot.sequencer_step = m_sequencer_step;
+    snapshot.sweep_enabled = m_sweep_enabled;
+}
+
+void Apu::load_state(const ApuSnapshot& snapshot)
+{
+    m_channels = snapshot.channels;
+    m_left.load_state(snapshot.left);
+    m_right.load_state(snapshot.right);
+    m_clock = snapshot.clock;
+    m_frame_start = snapshot.frame_start;
+    m_pending = snapshot.pending;
+    m_lfsr = snapshot.lfsr;
+    m_shadow = snapshot.shadow;
+    m_sweep_timer = snapshot.sweep_timer;
+    m_sequencer_step = snapshot.sequencer_step;
+    m_sweep_enabled = snapshot.sweep_enabled;
+}
+
+void Apu::run_channels(uint32_t end)
+{
+    for (size_t i = 0; i < m_channels.size(); ++i)
+        run_channel(i, end);
+}
+
+// Steps through the waveform up to `end`, adding a band-limited step for
+// every change of amplitude. The steps of a disabled channel make no sound,
+// and are skipped over all at once.
+void Apu::run_channel(size_t index, uint32_t end)
+{
+    ApuChannel& channel = m_channels[index];
+    uint32_t period = get_period(index);
+    uint32_t time = m_clock + channel.timer;
+    uint8_t mask = index == WAVE ? 31 : 7;
+    if (!channel.enabled) {
+        if (time < end) {
+            uint32_t steps = (end - time) / period + 1;
+            time += steps * period;
+            channel.position = static_cast<uint8_t>((channel.position + steps) & mask);
+        }
+        channel.timer = time - end;
+        return;
+    }
+
+    while (time < end) {
+        if (index == NOISE) {
+            bool wide = (m_bus.get_image()[NR43] & 0x08) == 0;
+            unsigned int bit = (m_lfsr ^ (m_lfsr >> 1)) & 1;
+            m_lfsr = static_cast<uint16_t>((m_lfsr >> 1) | (bit << 14));
+            if (!wide)
+                m_lfsr = static_cast<uint16_t>((m_lfsr & ~0x40u) | (bit << 6));
+        }
+        else {
+            channel.position = static_cast<uint8_t>((channel.position + 1) & mask);
+        }
+        set_amplitude(index, time, get_sample(index));
+        time += period;
+    }
+    channel.timer = time - end;
+}
+
+// Lengths are clocked on every other step, the sweep on steps 2 and 6, and
+// envelopes on step 7.
+void Apu::clock_sequencer()
+{
+    uint8_t step = m_sequencer_step;
+    m_sequencer_step = static_cast<uint8_t>((step + 1) & 7);
+    if ((m_bus.get_image()[NR52] & APU_ENABLE) == 0)
+        return;
+
+    if (step % 2 == 0) {
+        for (size_t i = 0; i < m_channels.size(); ++i)
+            clock_length(i);
+    }
+    if (step == 2 || step == 6)
+        clock_sweep();
+    if (step == 7) {
+        clock_envelope(0);
+        clock_envelope(1);
+        clock_envelope(NOISE);
+    }
+}
+
+void Apu::clock_length(size_t index)
+{
+    ApuChannel& channel = m_channels[index];
+    uint8_t control = m_bus.get_image()[channel_register(index, 4)];
+    if ((control & LENGTH_ENABLE) == 0 || channel.length == 0)
+        return;
+    if (--channel.length == 0)
+        set_enabled(index, false);
+}
+
+void Apu::clock_envelope(size_t index)
+{
+    ApuChannel& channel = m_channels[index];
+    uint8_t envelope = m_bus.get_image()[channel_register(index, 2)];
+    uint8_t pace = envelope & 7;
+    if (pace == 0 || !channel.enabled)
+        return;
+    if (channel.envelope_timer > 0)
+        --channel.envelope_timer;
+    if (channel.envelope_timer > 0)
+        return;
+
+    channel.envelope_timer = pace;
+    if ((envelope & 0x08) != 0 && channel.volume < 15)
+        ++channel.volume;
+    else if ((envelope & 0x08) == 0 && channel.volume > 0)
+        --channel.volume;
+    set_amplitude(index, m_clock, get_sample(index));
+}
+
+// Pan Docs: https://gbdev.io/pandocs/Audio_details.html#pulse-channel-with-sweep-ch1
+void Apu::clock_sweep()
+{
+    if (m_sweep_timer > 0)
+        --m_sweep_timer;
+    if (m_sweep_timer > 0)
+        return;
+
+    uint8_t sweep = m_bus.get_image()[NR10];
+    uint8_t pace = (sweep >> 4) & 7;
+    m_sweep_timer = pace != 0 ? pace : 8;
+    if (!m_sweep_enabled || pace == 0)
+        return;
+
+    uint16_t frequency = next_sweep();
+    if (frequency <= 0x7FF && (sweep & 7) != 0) {
+        m_shadow = frequency;
+        m_channels[0].frequency = frequency;
+        next_sweep();
+    }
+}
+
+// Frequency after the next sweep step, which turns channel 1 off on overflow.
+uint16_t Apu::next_sweep()
+{
+    uint8_t sweep = m_bus.get_image()[NR10];
+    unsigned int change = m_shadow >> (sweep & 7);
+    unsigned int frequency = (sweep & 0x08) != 0 ? m_shadow - change : m_shadow + change;
+    if (frequency > 0x7FF)
+        set_enabled(0, false);
+    return static_cast<uint16_t>(frequency);
+}
+
+void Apu::trigger(size_t index)
+{
+    ApuChannel& channel = m_channels[index];
+    uint8_t envelope = m_bus.get_image()[channel_register(index, 2)];
+    if (channel.length == 0)
+        channel.length = index == WAVE ? 256 : 64;
+    channel.timer = get_period(index);
+    channel.volume = static_cast<uint8_t>(envelope >> 4);
+    channel.envelope_timer = envelope & 7;
+    if (index == WAVE)
+        channel.position = 0;
+    if (index == NOISE)
+        m_lfsr = 0x7FFF;
+    set_enabled(index, has_dac(index));
+
+    if (index == 0) {
+        uint8_t sweep = m_bus.get_image()[NR10];
+        uint8_t pace = (sweep >> 4) & 7;
+        m_shadow = channel.frequency;
+        m_sweep_timer = pace != 0 ? pace : 8;
+        m_sweep_enabled = pace != 0 || (sweep & 7) != 0;
+        if ((sweep & 7) != 0)
+            next_sweep();
+    }
+    if (channel.enabled)
+        set_amplitude(index, m_clock, get_sample(index));
+}
+
+// Silences every channel, and clears every register but wave RAM.
+void Apu::power_off()
+{
+    for (size_t i = 0; i < m_channels.size(); ++i)
+        set_enabled(i, false);
+    for (size_t i = 0; i < NR52 - NR10; ++i)
+        m_bus.store(static_cast<uint16_t>(NR10 + i), READ_MASKS[i]);
+    m_channels.fill(ApuChannel());
+    m_sweep_enabled = false;
+}
+
+// T-cycles between two steps of the waveform.
+uint32_t Apu::get_period(size_t index) const
+{
+    if (index == NOISE) {
+        uint8_t noise = m_bus.get_image()[NR43];
+        uint32_t divider = (noise & 7) == 0 ? 8 : (noise & 7) * 16u;
+        return divider << (noise >> 4);
+    }
+    uint32_t steps = 2048u - m_channels[index].frequency;
+    return index == WAVE ? steps * 2 : steps * 4;
+}
+
+// Amplitude of the current step, from 0 to 15.
+uint8_t Apu::get_sample(size_t index) const
+{
+    const ApuChannel& channel = m_channels[index];
+    const MemoryImage& image = m_bus.get_image();
+    if (index == WAVE) {
+        uint8_t samples = image[WAVE_RAM + channel.position / 2];
+        uint8_t sample = (channel.position & 1) == 0 ? samples >> 4 : samples & 0x0F;
+        unsigned int level = (image[NR32] >> 5) & 3;
+        return level == 0 ? 0 : static_cast<uint8_t>(sample >> (level - 1));
+    }
+    if (index == NOISE)
+        return (m_lfsr & 1) == 0 ? channel.volume : 0;
+    unsigned int duty = image[channel_register(index, 1)] >> 6;
+    return ((DUTY_CYCLES[duty] >> channel.position) & 1) != 0 ? channel.volume : 0;
+}
+
+bool Apu::has_dac(size_t index) const
+{
+    const MemoryImage& image = m_bus.get_image();
+    if (index == WAVE)
+        return (image[NR30] & 0x80) != 0;
+    return (image[channel_register(index, 2)] & 0xF8) != 0;
+}
+
+// Keeps the status bits of NR52 in step. A disabled channel outputs nothing.
+void Apu::set_enabled(size_t index, bool enabled)
+{
+    m_channels[index].enabled = enabled;
+    uint8_t status = m_bus.get_image()[NR52];
+    uint8_t bit = static_cast<uint8_t>(1 << index);
+    m_bus.store(NR52, static_cast<uint8_t>(enabled ? status | bit : status & ~bit));
+    if (!enabled)
+        set_amplitude(index, m_clock, 0);
+}
+
+void Apu::set_amplitude(size_t index, uint32_t time, uint8_t amplitude)
+{
+    if (m_channels[index].amplitude == amplitude)
+        return;
+    m_channels[index].amplitude = amplitude;
+    update_levels(index, time);
+}
+
+// Mixes the channel into both sides as NR50 and NR51 say, and adds whatever
+// changed to the blip buffers.
+void Apu::update_levels(size_t index, uint32_t time)
+{
+    ApuChannel& channel = m_channels[index];
+    const MemoryImage& image = m_bus.get_image();
+    uint8_t panning = image[NR51];
+    uint8_t volume = image[NR50];
+    std::array<int32_t, 2> levels = {};
+    if (((panning >> (4 + index)) & 1) != 0)
+        levels[0] = channel.amplitude * (((volume >> 4) & 7) + 1) * LEVEL_SCALE;
+    if (((panning >> index) & 1) != 0)
+        levels[1] = channel.amplitude * ((volume & 7) + 1) * LEVEL_SCALE;
+
+    uint32_t frame_time = time - m_frame_start;
+    if (levels[0] != channel.levels[0])
+        m_left.add_delta(frame_time, levels[0] - channel.levels[0]);
+    if (levels[1] != channel.levels[1])
+        m_right.add_delta(frame_time, levels[1] - channel.levels[1]);
+    channel.levels = levels;
+}
+
+// Makes every sample up to the present available.
+void Apu::end_frame()
+{
+    m_left.end_frame(m_clock - m_frame_start);
+    m_right.end_frame(m_clock - m_frame_start);
+    m_frame_start = m_clock;
+}
+} // namespace cbgb
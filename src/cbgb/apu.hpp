@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief GameBoy audio processing unit.
+//!
+//! The APU mixes four channels into a stereo signal \[[1]\]: two square waves,
+//! the first one with a frequency sweep, a wave channel playing 32 samples out
+//! of wave RAM, and a noise channel driven by an LFSR. Length timers, volume
+//! envelopes and the sweep are clocked by a frame sequencer at 512 Hz.
+//!
+//! Channels are not ticked along with the CPU. The APU only counts how far it
+//! is behind, and catches up the next time its state matters: a write to one
+//! of its registers, a read of NR52, or the frontend asking for samples. When
+//! it does catch up, every channel jumps straight from one step of its
+//! waveform to the next, and only the steps that change its output level end
+//! up in a pair of blip buffers, as band-limited steps at exact clock times.
+//!
+//! [1]: https://gbdev.io/pandocs/Audio.html
+
+#ifndef CBGB_APU_HPP
+#define CBGB_APU_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <spdlog/logger.h>
+
+#include "cbgb/blip_buffer.hpp"
+#include "cbgb/memory.hpp"
+
+namespace cbgb {
+inline constexpr uint16_t NR10 = 0xFF10;
+inline constexpr uint16_t NR11 = 0xFF11;
+inline constexpr uint16_t NR12 = 0xFF12;
+inline constexpr uint16_t NR13 = 0xFF13;
+inline constexpr uint16_t NR14 = 0xFF14;
+inline constexpr uint16_t NR21 = 0xFF16;
+inline constexpr uint16_t NR22 = 0xFF17;
+inline constexpr uint16_t NR23 = 0xFF18;
+inline constexpr uint16_t NR24 = 0xFF19;
+inline constexpr uint16_t NR30 = 0xFF1A;
+inline constexpr uint16_t NR31 = 0xFF1B;
+inline constexpr uint16_t NR32 = 0xFF1C;
+inline constexpr uint16_t NR33 = 0xFF1D;
+inline constexpr uint16_t NR34 = 0xFF1E;
+inline constexpr uint16_t NR41 = 0xFF20;
+inline constexpr uint16_t NR42 = 0xFF21;
+inline constexpr uint16_t NR43 = 0xFF22;
+inline constexpr uint16_t NR44 = 0xFF23;
+inline constexpr uint16_t NR50 = 0xFF24;
+inline constexpr uint16_t NR51 = 0xFF25;
+inline constexpr uint16_t NR52 = 0xFF26;
+inline constexpr uint16_t WAVE_RAM = 0xFF30;
+inline constexpr uint16_t APU_END = 0xFF3F;
+
+/// @brief Rate of the T-cycle clock the APU counts time in.
+inline constexpr uint32_t APU_CLOCK_RATE = 4194304;
+
+/// @brief Nominal rate of the stereo samples the APU outputs.
+inline constexpr uint32_t APU_SAMPLE_RATE = 48000;
+
+/// @brief State of one sound channel.
+///
+/// Not every channel uses every field. The position is the step of the duty
+/// cycle for square channels, and the sample index for the wave channel.
+struct ApuChannel {
+    std::array<int32_t, 2> levels;
+    uint32_t timer;
+    uint16_t frequency;
+    uint16_t length;
+    uint8_t position;
+    uint8_t volume;
+    uint8_t envelope_timer;
+    uint8_t amplitude;
+    bool enabled;
+};
+
+/// @brief Plain copy of APU state, pending output included.
+struct ApuSnapshot {
+    std::array<ApuChannel, 4> channels;
+    BlipState left;
+    BlipState right;
+    uint32_t clock;
+    uint32_t frame_start;
+    uint32_t pending;
+    uint16_t lfsr;
+    uint16_t shadow;
+    uint8_t sweep_timer;
+    uint8_t sequencer_step;
+    bool sweep_enabled;
+};
+
+/// @brief Lazily synthesized APU.
+///
+/// Registers live on the memory bus like those of any other peripheral, but
+/// writes to them go through the APU, which keeps what they read back as. The
+/// samples of a restored state start after the last sample read before saving
+/// it, any samples left unread by then are lost.
+///
+/// The output rate is not part of the machine state. Frontends nudge it to
+/// keep their audio buffer from running dry or filling up.
+class Apu final {
+public:
+    Apu(spdlog::logger& logger, MemoryBus& bus);
+    void advance(unsigned int mcycles);
+    void sync();
+    void write(uint16_t address, uint8_t value);
+    size_t read_samples(int16_t* samples, size_t frames);
+    size_t get_available_samples() const;
+    void set_sample_rate(uint32_t sample_rate);
+    void save_state(ApuSnapshot& snapshot) const;
+    void load_state(const ApuSnapshot& snapshot);
+
+private:
+    void run_channels(uint32_t end);
+    void run_channel(size_t index, uint32_t end);
+    void clock_sequencer();
+    void clock_length(size_t index);
+    void clock_envelope(size_t index);
+    void clock_sweep();
+    uint16_t next_sweep();
+    void trigger(size_t index);
+    void power_off();
+    uint32_t get_period(size_t index) const;
+    uint8_t get_sample(size_t index) const;
+    bool has_dac(size_t index) const;
+    void set_enabled(size_t index, bool enabled);
+    void set_amplitude(size_t index, uint32_t time, uint8_t amplitude);
+    void update_levels(size_t index, uint32_t time);
+    void end_frame();
+
+    spdlog::logger& m_logger;
+    MemoryBus& m_bus;
+    BlipBuffer m_left;
+    BlipBuffer m_right;
+    std::array<ApuChannel, 4> m_channels;
+    uint32_t m_clock;
+    uint32_t m_frame_start;
+    uint32_t m_pending;
+    uint16_t m_lfsr;
+    uint16_t m_shadow;
+    uint8_t m_sweep_timer;
+    uint8_t m_sequencer_step;
+    bool m_sweep_enabled;
+};
+} // namespace cbgb
+
+#endif // CBGB_APU_HPP
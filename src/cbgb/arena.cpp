@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+#include <fmt/format.h>
+
+#include "cbgb/arena.hpp"
+
+namespace cbgb {
+constexpr size_t PAGE_SIZE = 4096;
+
+// Transparent huge pages on x86-64 are 2 MiB. Rounding large arenas up to
+// them wastes little, and lets the kernel back them with huge pages.
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+size_t round_to_pages(size_t size)
+{
+    size_t page = size >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : PAGE_SIZE;
+    return (size + page - 1) / page * page;
+}
+
+Arena::Arena(void* memory, size_t size)
+    : m_base(static_cast<uint8_t*>(memory))
+    , m_size(size)
+    , m_offset(0)
+{
+}
+
+// Bounds are checked against the space left, rather than by adding up to the
+// end, which could wrap around for huge sizes.
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+        throw std::invalid_argument(fmt::format("Alignment {} is not a power of two", alignment));
+
+    uintptr_t base = reinterpret_cast<uintptr_t>(m_base);
+    uintptr_t mask = alignment - 1;
+    size_t padding = (uintptr_t(0) - (base + m_offset)) & mask;
+    if (padding > m_size - m_offset)
+        throw std::bad_alloc();
+    size_t offset = m_offset + padding;
+    if (size > m_size - offset)
+        throw std::bad_alloc();
+
+    m_offset = offset + size;
+    return m_base + offset;
+}
+
+void Arena::reset()
+{
+    m_offset = 0;
+}
+
+size_t Arena::get_used() const
+{
+    return m_offset;
+}
+
+size_t Arena::get_capacity() const
+{
+    return m_size;
+}
+
+ArenaMemory::ArenaMemory(size_t size)
+    : m_data(nullptr)
+    , m_size(round_to_pages(size))
+{
+#if defined(__unix__) || defined(__APPLE__)
+    // mmap only promises page alignment, and the kernel can only back 2 MiB
+    // aligned ranges with huge pages. Map a huge page more than needed, then
+    // unmap the slack on either side of the aligned range.
+    size_t slack = m_size >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : 0;
+    void* data = mmap(nullptr, m_size + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                      -1, 0);
+    if (data == MAP_FAILED)
+        throw std::bad_alloc();
+    uintptr_t start = reinterpret_cast<uintptr_t>(data);
+    uintptr_t aligned = slack == 0 ? start : (start + slack - 1) / slack * slack;
+    if (aligned > start)
+        munmap(data, aligned - start);
+    if (start + slack > aligned)
+        munmap(reinterpret_cast<void*>(aligned + m_size), start + slack - aligned);
+    m_data = reinterpret_cast<void*>(aligned);
+#if defined(MADV_HUGEPAGE)
+    if (slack != 0)
+        madvise(m_data, m_size, MADV_HUGEPAGE);
+#endif
+#elif defined(_WIN32)
+    m_data = VirtualAlloc(nullptr, m_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (m_data == nullptr)
+        throw std::bad_alloc();
+#else
+    m_data = ::operator new(m_size, std::align_val_t(CACHE_LINE_SIZE));
+#endif
+
+    // First touch decides which NUMA node a page lands on.
+    std::memset(m_data, 0, m_size);
+}
+
+ArenaMemory::~ArenaMemory()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    munmap(m_data, m_size);
+#elif defined(_WIN32)
+    VirtualFree(m_data, 0, MEM_RELEASE);
+#else
+    ::operator delete(m_data, std::align_val_t(CACHE_LINE_SIZE));
+#endif
+}
+
+void* ArenaMemory::data()
+{
+    return m_data;
+}
+
+size_t ArenaMemory::size() const
+{
+    return m_size;
+}
+} // namespace cbgb
@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Arena allocation of machine state.
+//!
+//! A single #GameBoy keeps its CPU state, memory bus array (cartridge RAM
+//! included), frame buffer, and audio buffers inline. An arena lets thousands
+//! of them be packed back to back in one block of caller provided memory, each
+//! starting on its own cache line, instead of being scattered across the heap.
+//!
+//! Some state still lives on the heap: the text a game prints through the
+//! serial port, and the render thread of the PPU along with the log of video
+//! memory writes it replays. The former only grows when a game prints
+//! something, and the latter only exists once rendering is moved off thread.
+//!
+//! #ArenaMemory provides suitable backing memory. It hands out whole pages,
+//! asks the kernel for transparent huge pages where supported, and touches
+//! every page up front. Under the usual first-touch NUMA policy, allocating
+//! it from a pinned worker thread therefore keeps the memory local to that
+//! worker's node.
+
+#ifndef CBGB_ARENA_HPP
+#define CBGB_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "cbgb/memory.hpp"
+
+namespace cbgb {
+/// @brief Runs the destructor of an arena object without freeing it.
+template <typename T>
+struct ArenaDestroy final {
+    void operator()(T* object) const
+    {
+        object->~T();
+    }
+};
+
+template <typename T>
+using ArenaPtr = std::unique_ptr<T, ArenaDestroy<T>>;
+
+/// @brief Bump allocator over caller provided memory.
+///
+/// Never frees individual allocations, the whole arena is recycled at once
+/// with #reset after every object in it has been destroyed.
+class Arena final {
+public:
+    Arena(void* memory, size_t size);
+    void* allocate(size_t size, size_t alignment = CACHE_LINE_SIZE);
+    void reset();
+    size_t get_used() const;
+    size_t get_capacity() const;
+
+    template <typename T, typename... Args>
+    ArenaPtr<T> create(Args&&... args)
+    {
+        constexpr size_t alignment
+            = alignof(T) > CACHE_LINE_SIZE ? alignof(T) : CACHE_LINE_SIZE;
+        void* memory = allocate(sizeof(T), alignment);
+        return ArenaPtr<T>(new (memory) T(std::forward<Args>(args)...));
+    }
+
+    /// @brief Bytes needed to create `count` objects of type T.
+    template <typename T>
+    static constexpr size_t required(size_t count = 1)
+    {
+        constexpr size_t alignment
+            = alignof(T) > CACHE_LINE_SIZE ? alignof(T) : CACHE_LINE_SIZE;
+        return count * ((sizeof(T) + alignment - 1) / alignment * alignment);
+    }
+
+private:
+    uint8_t* m_base;
+    size_t m_size;
+    size_t m_offset;
+};
+
+/// @brief Page backed memory to place an #Arena in.
+class ArenaMemory final {
+public:
+    explicit ArenaMemory(size_t size);
+    ~ArenaMemory();
+    ArenaMemory(const ArenaMemory&) = delete;
+    ArenaMemory& operator=(const ArenaMemory&) = delete;
+    void* data();
+    size_t size() const;
+
+private:
+    void* m_data;
+    size_t m_size;
+};
+} // namespace cbgb
+
+#endif // CBGB_ARENA_HPP
@@ -0,0 +1,198 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CBGB_HAVE_SSE2 1
+#include <emmintrin.h>
+#else
+#define CBGB_HAVE_SSE2 0
+#endif
+
+#include <fmt/format.h>
+
+#include "cbgb/blip_buffer.hpp"
+
+namespace cbgb {
+// Steps land on one of 32 positions between two samples, and every kernel sums
+// up to one step in Q15 fixed point.
+constexpr unsigned int PHASE_BITS = 5;
+constexpr size_t PHASES = size_t(1) << PHASE_BITS;
+constexpr int DELTA_BITS = 15;
+constexpr int32_t STEP = 1 << DELTA_BITS;
+
+// The high-pass filter takes away 1/512 of the level every sample, which
+// puts its corner at about 15 Hz for 48 kHz output.
+constexpr int BASS_SHIFT = 9;
+
+constexpr uint32_t MIN_SAMPLE_RATE = 8000;
+constexpr uint32_t MAX_SAMPLE_RATE = 96000;
+
+using Kernel = std::array<std::array<int16_t, BLIP_KERNEL_SIZE>, PHASES>;
+
+// Blackman windowed sinc pulses with the cutoff a little below Nyquist, one
+// per phase, rounded so that each still adds up to exactly one step. Thanks to
+// the cutoff, even the largest tap stays below one step, and fits 16 bits.
+static const Kernel& get_kernel()
+{
+    static const Kernel kernel = [] {
+        constexpr double pi = 3.14159265358979323846;
+        constexpr double cutoff = 0.9;
+        constexpr double half = BLIP_KERNEL_SIZE / 2.0;
+        Kernel table = {};
+        for (size_t phase = 0; phase < PHASES; ++phase) {
+            std::array<double, BLIP_KERNEL_SIZE> taps = {};
+            double sum = 0.0;
+            for (size_t tap = 0; tap < BLIP_KERNEL_SIZE; ++tap) {
+                double x = static_cast<double>(tap) - (half - 1.0)
+                    - static_cast<double>(phase) / static_cast<double>(PHASES);
+                double angle = pi * cutoff * x;
+                double sinc = x == 0.0 ? 1.0 : std::sin(angle) / angle;
+                double window = 0.42 + 0.5 * std::cos(pi * x / half)
+                    + 0.08 * std::cos(2.0 * pi * x / half);
+                taps[tap] = sinc * window;
+                sum += taps[tap];
+            }
+
+            int32_t total = 0;
+            for (size_t tap = 0; tap < BLIP_KERNEL_SIZE; ++tap) {
+                table[phase][tap] = static_cast<int16_t>(std::lround(taps[tap] / sum * STEP));
+                total += table[phase][tap];
+            }
+            int16_t& center = table[phase][BLIP_KERNEL_SIZE / 2 - 1];
+            center = static_cast<int16_t>(center + STEP - total);
+        }
+        return table;
+    }();
+    return kernel;
+}
+
+// Runs the integrator and high-pass filter over `count` deltas, writing the
+// samples out unless there is nowhere to write them to.
+static int32_t integrate(
+    int32_t sum, const int32_t* deltas, size_t count, int16_t* samples, size_t stride
+)
+{
+    for (size_t index = 0; index < count; ++index) {
+        sum += deltas[index];
+        int32_t sample = std::clamp(sum >> DELTA_BITS, -32768, 32767);
+        if (samples != nullptr)
+            samples[index * stride] = static_cast<int16_t>(sample);
+        sum -= sample * (1 << (DELTA_BITS - BASS_SHIFT));
+    }
+    return sum;
+}
+
+BlipBuffer::BlipBuffer(uint32_t clock_rate, uint32_t sample_rate)
+    : m_clock_rate(clock_rate)
+    , m_factor(0)
+    , m_offset(0)
+    , m_deltas()
+    , m_available(0)
+    , m_integrator(0)
+{
+    if (clock_rate == 0)
+        throw std::invalid_argument("Clock rate of blip buffer is zero");
+    set_sample_rate(sample_rate);
+}
+
+// Adds a jump of the signal by `delta` at `time` clocks into the current time
+// frame. Both the delta and every tap of the kernel fit 16 bits, so SSE2
+// scales four taps at once with a multiply-add that widens them to 32 bits.
+void BlipBuffer::add_delta(uint32_t time, int32_t delta)
+{
+    uint64_t position = m_offset + time * m_factor;
+    size_t index = m_available + (position >> 32);
+    size_t phase = (position >> (32 - PHASE_BITS)) & (PHASES - 1);
+    const int16_t* taps = get_kernel()[phase].data();
+    int32_t* deltas = &m_deltas[index];
+#if CBGB_HAVE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i scale = _mm_set1_epi32(static_cast<uint16_t>(delta));
+    for (size_t tap = 0; tap < BLIP_KERNEL_SIZE; tap += 8) {
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(taps + tap));
+        __m128i low = _mm_madd_epi16(_mm_unpacklo_epi16(packed, zero), scale);
+        __m128i high = _mm_madd_epi16(_mm_unpackhi_epi16(packed, zero), scale);
+        __m128i* target = reinterpret_cast<__m128i*>(deltas + tap);
+        _mm_storeu_si128(target, _mm_add_epi32(_mm_loadu_si128(target), low));
+        _mm_storeu_si128(target + 1, _mm_add_epi32(_mm_loadu_si128(target + 1), high));
+    }
+#else
+    for (size_t tap = 0; tap < BLIP_KERNEL_SIZE; ++tap)
+        deltas[tap] += taps[tap] * delta;
+#endif
+}
+
+// Samples nobody reads are dropped, oldest first, once the buffer is full.
+void BlipBuffer::end_frame(uint32_t time)
+{
+    uint64_t position = m_offset + time * m_factor;
+    m_available += position >> 32;
+    m_offset = position & 0xFFFFFFFF;
+
+    if (m_available > BLIP_CAPACITY)
+        remove_samples(m_available - BLIP_CAPACITY);
+}
+
+// Reads up to `count` samples, `stride` apart, for interleaving channels.
+size_t BlipBuffer::read_samples(int16_t* samples, size_t count, size_t stride)
+{
+    count = std::min(count, m_available);
+    m_integrator = integrate(m_integrator, m_deltas.data(), count, samples, stride);
+    auto shift = static_cast<std::ptrdiff_t>(count);
+    std::move(m_deltas.begin() + shift, m_deltas.end(), m_deltas.begin());
+    std::fill(m_deltas.end() - shift, m_deltas.end(), 0);
+    m_available -= count;
+    return count;
+}
+
+void BlipBuffer::remove_samples(size_t count)
+{
+    read_samples(nullptr, count, 0);
+}
+
+// Applies from the next step on, samples already available stay as they are.
+// Rate control changes it by a fraction of a percent at a time, to stretch the
+// output to whatever rate it is actually consumed at.
+void BlipBuffer::set_sample_rate(uint32_t sample_rate)
+{
+    if (sample_rate < MIN_SAMPLE_RATE || sample_rate > MAX_SAMPLE_RATE) {
+        throw std::invalid_argument(fmt::format(
+            "Sample rate {0} Hz is not within {1} Hz to {2} Hz",
+            sample_rate,
+            MIN_SAMPLE_RATE,
+            MAX_SAMPLE_RATE
+        ));
+    }
+    m_factor = (uint64_t(sample_rate) << 32) / m_clock_rate;
+}
+
+size_t BlipBuffer::get_available() const
+{
+    return m_available;
+}
+
+// Samples not read yet count as read, restoring starts from the tail on.
+void BlipBuffer::save_state(BlipState& state) const
+{
+    state.integrator = integrate(m_integrator, m_deltas.data(), m_available, nullptr, 0);
+    auto tail = m_deltas.begin() + static_cast<std::ptrdiff_t>(m_available);
+    std::copy_n(tail, BLIP_TAIL_SIZE, state.tail.begin());
+    state.offset = m_offset;
+}
+
+void BlipBuffer::load_state(const BlipState& state)
+{
+    std::fill(m_deltas.begin(), m_deltas.end(), 0);
+    std::copy(state.tail.begin(), state.tail.end(), m_deltas.begin());
+    m_available = 0;
+    m_offset = state.offset;
+    m_integrator = state.integrator;
+}
+} // namespace cbgb
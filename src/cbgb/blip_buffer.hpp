@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Band-limited step synthesis.
+//!
+//! Every APU channel outputs a signal that only ever jumps between a handful
+//! of levels. Rather than ticking channels at 4 MiHz and filtering down to the
+//! host sample rate, only the jumps are recorded: each one adds a band-limited
+//! step, a windowed sinc pulse, to a buffer of deltas at its exact position
+//! between output samples. Reading samples integrates those deltas, and runs
+//! a gentle high-pass filter to remove DC like the capacitors of the hardware
+//! do. Cost scales with the number of level changes, not with clock cycles.
+//!
+//! The kernel is a polyphase filter, with one set of taps for each of 32
+//! positions between two samples. Mapping clocks to samples through a 32.32
+//! fixed point factor makes the buffer a resampler as well, one whose output
+//! rate can be changed on the fly.
+
+#ifndef CBGB_BLIP_BUFFER_HPP
+#define CBGB_BLIP_BUFFER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace cbgb {
+/// @brief Output samples touched by a single step.
+inline constexpr size_t BLIP_KERNEL_SIZE = 16;
+
+/// @brief Samples kept available for reading, about 170 ms at 48 kHz.
+inline constexpr size_t BLIP_CAPACITY = 8192;
+
+/// @brief Deltas past the samples made available, kept across a restore.
+///
+/// Covers a whole time frame of up to 8192 clocks at the highest supported
+/// sample rate, plus the kernel.
+inline constexpr size_t BLIP_TAIL_SIZE = 208;
+
+/// @brief Part of a blip buffer that outlives a state restore.
+struct BlipState {
+    std::array<int32_t, BLIP_TAIL_SIZE> tail;
+    uint64_t offset;
+    int32_t integrator;
+};
+
+/// @brief Buffer of band-limited steps at one sample rate.
+///
+/// Time is counted in input clocks from the start of the current time frame.
+/// Closing a time frame makes every sample before its end available for
+/// reading, and starts the next time frame at zero. A time frame must not
+/// span more than 8192 clocks. The deltas are kept inline, so a machine in an
+/// arena keeps its audio buffers there as well.
+class BlipBuffer final {
+public:
+    BlipBuffer(uint32_t clock_rate, uint32_t sample_rate);
+    void add_delta(uint32_t time, int32_t delta);
+    void end_frame(uint32_t time);
+    size_t read_samples(int16_t* samples, size_t count, size_t stride);
+    void remove_samples(size_t count);
+    void set_sample_rate(uint32_t sample_rate);
+    size_t get_available() const;
+    void save_state(BlipState& state) const;
+    void load_state(const BlipState& state);
+
+private:
+    uint32_t m_clock_rate;
+    uint64_t m_factor;
+    uint64_t m_offset;
+    std::array<int32_t, BLIP_CAPACITY + BLIP_TAIL_SIZE> m_deltas;
+    size_t m_available;
+    int32_t m_integrator;
+};
+} // namespace cbgb
+
+#endif // CBGB_BLIP_BUFFER_HPP
@@ -1644,6 +1644,13 @@ constexpr std::array<Opcode, 256> new_opcode_jump_table()
 }
 constexpr std::array<Opcode, 256> opcode_jump_table = new_opcode_jump_table();
 
+// Bytes an opcode takes up along with its operands, or zero if it is undefined.
+unsigned int get_opcode_length(uint8_t opcode)
+{
+    const Opcode& entry = opcode_jump_table[opcode];
+    return entry.execute != nullptr ? entry.length : 0;
+}
+
 UndefinedOpcode::UndefinedOpcode(std::string what)
     : m_what(what)
 {
@@ -1677,15 +1684,15 @@ Sm83State::Sm83State(MemoryBus& bus)
 {
 }
 
-Sm83::Sm83(std::shared_ptr<spdlog::logger> log, MemoryBus& bus)
+Sm83::Sm83(spdlog::logger& log, MemoryBus& bus)
     : m_state(bus)
     , m_mcycles(0)
     , m_logger(log)
 {
-    m_logger->trace("Construct new SM83 CPU");
+    m_logger.trace("Construct new SM83 CPU");
 }
 
-void Sm83::step()
+unsigned int Sm83::step()
 {
     uint8_t target = m_state.memory.read(m_state.pc++);
     Opcode opcode = opcode_jump_table[target];
@@ -1696,10 +1703,11 @@ void Sm83::step()
     }
 
     opcode.execute(m_state);
-    m_logger->debug(
+    m_logger.debug(
         "Execute [{0:04X}: {1:02X}] {2}", m_state.pc - opcode.length, target, opcode.mnemonic
     );
     m_mcycles += opcode.mcycle;
+    return opcode.mcycle;
 }
 
 const Sm83State& Sm83::get_state()
@@ -1711,4 +1719,34 @@ unsigned int Sm83::get_mcycle_count()
 {
     return m_mcycles;
 }
+
+void Sm83::save_state(Sm83Snapshot& snapshot) const
+{
+    snapshot.pc = m_state.pc;
+    snapshot.sp = m_state.sp;
+    snapshot.a = m_state.a;
+    snapshot.f = m_state.f;
+    snapshot.b = m_state.b;
+    snapshot.c = m_state.c;
+    snapshot.d = m_state.d;
+    snapshot.e = m_state.e;
+    snapshot.h = m_state.h;
+    snapshot.l = m_state.l;
+    snapshot.mcycles = m_mcycles;
+}
+
+void Sm83::load_state(const Sm83Snapshot& snapshot)
+{
+    m_state.pc = snapshot.pc;
+    m_state.sp = snapshot.sp;
+    m_state.a = snapshot.a;
+    m_state.f = snapshot.f;
+    m_state.b = snapshot.b;
+    m_state.c = snapshot.c;
+    m_state.d = snapshot.d;
+    m_state.e = snapshot.e;
+    m_state.h = snapshot.h;
+    m_state.l = snapshot.l;
+    m_mcycles = snapshot.mcycles;
+}
 } // namespace cbgb
@@ -49,17 +49,39 @@ struct Sm83State {
     Sm83State(MemoryBus& bus);
 };
 
+/// @brief Plain copy of SM83 register file.
+///
+/// Unlike #Sm83State, this type holds no references, so it can be freely
+/// copied around to save and restore the state of the CPU.
+struct Sm83Snapshot {
+    uint16_t pc;
+    uint16_t sp;
+    uint8_t a;
+    uint8_t f;
+    uint8_t b;
+    uint8_t c;
+    uint8_t d;
+    uint8_t e;
+    uint8_t h;
+    uint8_t l;
+    unsigned int mcycles;
+};
+
+unsigned int get_opcode_length(uint8_t opcode);
+
 class Sm83 final {
 public:
-    Sm83(std::shared_ptr<spdlog::logger> log, MemoryBus& bus);
-    void step();
+    Sm83(spdlog::logger& log, MemoryBus& bus);
+    unsigned int step();
     const Sm83State& get_state();
     unsigned int get_mcycle_count();
+    void save_state(Sm83Snapshot& snapshot) const;
+    void load_state(const Sm83Snapshot& snapshot);
 
 private:
     Sm83State m_state;
     unsigned int m_mcycles;
-    std::shared_ptr<spdlog::logger> m_logger;
+    spdlog::logger& m_logger;
 };
 } // namespace cbgb
 
@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "cbgb/game_database.hpp"
+
+namespace cbgb {
+constexpr size_t TITLE_START = 0x0134;
+constexpr size_t TITLE_SIZE = 16;
+
+struct GameEntry {
+    std::string_view title;
+    uint32_t flags;
+};
+
+constexpr std::array<GameEntry, 1> GAMES = {
+    // Changes palettes in the middle of lines to color its intro text.
+    GameEntry { "PREHISTORIK MAN", GAME_PIXEL_FIFO },
+};
+
+// Titles are padded with zeros. Later cartridges reuse the last bytes for
+// other header fields, which never hold printable characters.
+std::string read_game_title(const uint8_t* rom, size_t size)
+{
+    std::string title;
+    for (size_t i = TITLE_START; i < TITLE_START + TITLE_SIZE && i < size; ++i) {
+        if (rom[i] < 0x20 || rom[i] > 0x7E)
+            break;
+        title += static_cast<char>(rom[i]);
+    }
+    return title;
+}
+
+uint32_t lookup_game_flags(const uint8_t* rom, size_t size)
+{
+    std::string title = read_game_title(rom, size);
+    for (const GameEntry& game : GAMES) {
+        if (game.title == title)
+            return game.flags;
+    }
+    return 0;
+}
+} // namespace cbgb
@@ -0,0 +1,29 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Per game emulation settings.
+//!
+//! Most games run fine with the fast defaults of the core, but a handful rely
+//! on hardware details that only slower code paths emulate. Rather than paying
+//! for those everywhere, the games that need them are listed here, and picked
+//! out by the title in their cartridge header \[[1]\].
+//!
+//! [1]: https://gbdev.io/pandocs/The_Cartridge_Header.html
+
+#ifndef CBGB_GAME_DATABASE_HPP
+#define CBGB_GAME_DATABASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cbgb {
+enum GameFlag : uint32_t {
+    GAME_PIXEL_FIFO = 1 << 0,
+};
+
+std::string read_game_title(const uint8_t* rom, size_t size);
+uint32_t lookup_game_flags(const uint8_t* rom, size_t size);
+} // namespace cbgb
+
+#endif // CBGB_GAME_DATABASE_HPP
@@ -0,0 +1,208 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <spdlog/logger.h>
+
+#include "cbgb/apu.hpp"
+#include "cbgb/game_database.hpp"
+#include "cbgb/gameboy.hpp"
+#include "cbgb/ppu.hpp"
+#include "cbgb/serial.hpp"
+#include "cbgb/timer.hpp"
+#include "cbgb/trace.hpp"
+
+namespace cbgb {
+// Only the fixed 32 KiB of cartridge ROM is mapped, no MBC yet.
+constexpr size_t ROM_SIZE = 0x8000;
+
+GameBoy::GameBoy(spdlog::logger& logger)
+    : m_logger(logger)
+    , m_memory(logger)
+    , m_cpu(logger, m_memory)
+    , m_ppu(logger, m_memory)
+    , m_apu(logger, m_memory)
+    , m_timer(logger, m_memory)
+    , m_serial(logger, m_memory)
+    , m_frame_count(0)
+    , m_mcycles(0)
+    , m_instructions(0)
+{
+    m_memory.attach_apu(&m_apu);
+    m_memory.attach_timer(&m_timer);
+    m_memory.attach_serial(&m_serial);
+    m_logger.trace("Construct new GameBoy");
+}
+
+// Games known to need the pixel FIFO get it here. It is never turned off
+// again, so that it can also be asked for before loading any ROM.
+void GameBoy::load_rom(const uint8_t* data, size_t size)
+{
+    if ((lookup_game_flags(data, size) & GAME_PIXEL_FIFO) != 0) {
+        m_logger.info("Game '{}' needs the pixel FIFO PPU", read_game_title(data, size));
+        m_ppu.set_accuracy(PpuAccuracy::PIXEL_FIFO);
+    }
+    if (size > ROM_SIZE) {
+        m_logger.warn("ROM is {0} bytes, only first {1} bytes are mapped", size, ROM_SIZE);
+        size = ROM_SIZE;
+    }
+    m_memory.load(0x0000, data, size);
+}
+
+void GameBoy::set_joypad(uint8_t buttons)
+{
+    m_memory.set_joypad(buttons);
+}
+
+// Optional extra output that every drawn scanline is fed to, null for none.
+// Not part of the machine state, so snapshots leave it alone.
+void GameBoy::set_downscaler(Downscaler* downscaler)
+{
+    m_ppu.set_downscaler(downscaler);
+}
+
+void GameBoy::set_render_skip(bool skip)
+{
+    m_ppu.set_render_skip(skip);
+}
+
+unsigned int GameBoy::step()
+{
+    unsigned int mcycles = m_cpu.step();
+    advance(mcycles);
+    return mcycles;
+}
+
+// Advances everything but the CPU, which has already run the given number of
+// instructions in that many M-cycles. Returns true once a frame has been
+// completed, which the PPU decides. Any overshoot of the last instruction
+// carries over into the next frame, so frames stay aligned to the real
+// refresh rate on average.
+bool GameBoy::advance(unsigned int mcycles, unsigned int instructions)
+{
+    m_instructions += instructions;
+    m_mcycles += mcycles;
+    m_apu.advance(mcycles);
+    m_timer.advance(mcycles);
+    m_serial.advance(mcycles);
+    if (!m_ppu.advance(mcycles))
+        return false;
+
+    ++m_frame_count;
+    return true;
+}
+
+void GameBoy::step_frame()
+{
+    CBGB_TRACE_SCOPE("CPU");
+    while (!advance(m_cpu.step()))
+        continue;
+}
+
+void GameBoy::save_state(Snapshot& snapshot) const
+{
+    m_cpu.save_state(snapshot.cpu);
+    m_memory.save_state(snapshot.memory);
+    m_ppu.save_state(snapshot.ppu);
+    m_apu.save_state(snapshot.apu);
+    m_timer.save_state(snapshot.timer);
+    m_serial.save_state(snapshot.serial);
+    snapshot.frame_count = m_frame_count;
+    snapshot.mcycles = m_mcycles;
+}
+
+void GameBoy::load_state(const Snapshot& snapshot)
+{
+    m_cpu.load_state(snapshot.cpu);
+    m_memory.load_state(snapshot.memory);
+    m_ppu.load_state(snapshot.ppu);
+    m_apu.load_state(snapshot.apu);
+    m_timer.load_state(snapshot.timer);
+    m_serial.load_state(snapshot.serial);
+    m_frame_count = snapshot.frame_count;
+    m_mcycles = snapshot.mcycles;
+}
+
+const FrameBuffer& GameBoy::get_frame() const
+{
+    return m_ppu.get_frame();
+}
+
+uint64_t GameBoy::get_frame_count() const
+{
+    return m_frame_count;
+}
+
+uint64_t GameBoy::get_mcycle_count() const
+{
+    return m_mcycles;
+}
+
+// Instructions executed so far, the ones run-ahead threw away included. Not
+// part of the machine state, so snapshots leave it alone.
+uint64_t GameBoy::get_instruction_count() const
+{
+    return m_instructions;
+}
+
+MemoryBus& GameBoy::get_memory()
+{
+    return m_memory;
+}
+
+Sm83& GameBoy::get_cpu()
+{
+    return m_cpu;
+}
+
+Ppu& GameBoy::get_ppu()
+{
+    return m_ppu;
+}
+
+Apu& GameBoy::get_apu()
+{
+    return m_apu;
+}
+
+Timer& GameBoy::get_timer()
+{
+    return m_timer;
+}
+
+Serial& GameBoy::get_serial()
+{
+    return m_serial;
+}
+
+// 64-bit FNV-1a, cheap and good enough to tell frames apart.
+uint64_t hash_frame(const FrameBuffer& frame)
+{
+    uint64_t hash = 0xCBF29CE484222325;
+    for (uint8_t pixel : frame) {
+        hash ^= pixel;
+        hash *= 0x100000001B3;
+    }
+    return hash;
+}
+
+// Reads a whole ROM file, ready for GameBoy::load_rom.
+std::vector<uint8_t> read_rom(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error(fmt::format("Cannot open ROM '{}'", path));
+    return std::vector<uint8_t>(
+        std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()
+    );
+}
+} // namespace cbgb
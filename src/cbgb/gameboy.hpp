@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Complete GameBoy machine.
+//!
+//! Ties the SM83 CPU, the memory bus, the PPU, the APU, the timer and the
+//! serial port together into a single machine that can be stepped one video
+//! frame at a time. The display refreshes every 70224 dots, which is 17556
+//! M-cycles \[[1]\]. Stepping in whole frames is what frontends, run-ahead,
+//! and batch runners build on.
+//!
+//! [1]: https://gbdev.io/pandocs/Rendering.html
+
+#ifndef CBGB_GAMEBOY_HPP
+#define CBGB_GAMEBOY_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <spdlog/logger.h>
+
+#include "cbgb/apu.hpp"
+#include "cbgb/cpu.hpp"
+#include "cbgb/memory.hpp"
+#include "cbgb/ppu.hpp"
+#include "cbgb/serial.hpp"
+#include "cbgb/timer.hpp"
+
+namespace cbgb {
+/// @brief Full machine state that can be restored later.
+///
+/// Large enough that it should live on the heap rather than the stack.
+struct Snapshot {
+    Sm83Snapshot cpu;
+    MemoryImage memory;
+    PpuSnapshot ppu;
+    ApuSnapshot apu;
+    TimerSnapshot timer;
+    SerialSnapshot serial;
+    uint64_t frame_count;
+    uint64_t mcycles;
+};
+
+/// @brief GameBoy machine.
+///
+/// Owns every peripheral of the SoC, and advances them together.
+class GameBoy final {
+public:
+    explicit GameBoy(spdlog::logger& logger);
+    void load_rom(const uint8_t* data, size_t size);
+    void set_joypad(uint8_t buttons);
+    void set_downscaler(Downscaler* downscaler);
+    void set_render_skip(bool skip);
+    unsigned int step();
+    bool advance(unsigned int mcycles, unsigned int instructions = 1);
+    void step_frame();
+    void save_state(Snapshot& snapshot) const;
+    void load_state(const Snapshot& snapshot);
+    const FrameBuffer& get_frame() const;
+    uint64_t get_frame_count() const;
+    uint64_t get_mcycle_count() const;
+    uint64_t get_instruction_count() const;
+    MemoryBus& get_memory();
+    Sm83& get_cpu();
+    Ppu& get_ppu();
+    Apu& get_apu();
+    Timer& get_timer();
+    Serial& get_serial();
+
+private:
+    spdlog::logger& m_logger;
+    MemoryBus m_memory;
+    Sm83 m_cpu;
+    Ppu m_ppu;
+    Apu m_apu;
+    Timer m_timer;
+    Serial m_serial;
+    uint64_t m_frame_count;
+    uint64_t m_mcycles;
+    uint64_t m_instructions;
+};
+
+uint64_t hash_frame(const FrameBuffer& frame);
+std::vector<uint8_t> read_rom(const std::string& path);
+} // namespace cbgb
+
+#endif // CBGB_GAMEBOY_HPP
@@ -0,0 +1,31 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <string>
+
+#include <fmt/format.h>
+
+#include "cbgb/json.hpp"
+
+namespace cbgb {
+// Escapes text for use inside a JSON string. Only quotes, backslashes, and
+// control characters need it. Anything from 0x80 up passes through untouched,
+// so UTF-8 text, like a ROM path, stays UTF-8.
+std::string escape_json(const std::string& text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char symbol : text) {
+        auto code = static_cast<unsigned char>(symbol);
+        if (symbol == '"' || symbol == '\\')
+            escaped += '\\';
+        if (symbol == '\n')
+            escaped += "\\n";
+        else if (code < 0x20)
+            escaped += fmt::format("\\u{:04x}", static_cast<unsigned int>(code));
+        else
+            escaped += symbol;
+    }
+    return escaped;
+}
+} // namespace cbgb
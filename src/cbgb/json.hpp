@@ -0,0 +1,18 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Helpers for writing JSON by hand.
+//!
+//! The trace exporter and the headless runner's report both write their JSON
+//! with plain format strings, and share how strings are escaped in it.
+
+#ifndef CBGB_JSON_HPP
+#define CBGB_JSON_HPP
+
+#include <string>
+
+namespace cbgb {
+std::string escape_json(const std::string& text);
+} // namespace cbgb
+
+#endif // CBGB_JSON_HPP
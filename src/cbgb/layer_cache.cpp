@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "cbgb/layer_cache.hpp"
+#include "cbgb/memory.hpp"
+#include "cbgb/tile_cache.hpp"
+
+namespace cbgb {
+// Both tile maps, relative to the start of VRAM, right after tile data.
+constexpr size_t MAPS = 0x1800;
+constexpr size_t MAP_SIZE = 0x400;
+constexpr size_t FIRST_MAP_BLOCK = MAPS / 16;
+constexpr size_t VRAM_BLOCKS = 0x2000 / 16;
+
+LayerCache::LayerCache()
+    : m_planes()
+    , m_dirty()
+    , m_unsigned_index(true)
+{
+    m_dirty.fill(~uint32_t(0));
+}
+
+// Takes the record of VRAM writes the tile cache was updated from. A written
+// map block is 16 entries of one tile row, and a written tile affects every
+// entry that points to it.
+void LayerCache::invalidate(const uint8_t* vram, const VramBitmap& dirty)
+{
+    for (size_t block = FIRST_MAP_BLOCK; block < VRAM_BLOCKS; ++block) {
+        if ((dirty[block / 64] & (uint64_t(1) << (block % 64))) == 0)
+            continue;
+        size_t entry = (block - FIRST_MAP_BLOCK) * 16;
+        m_dirty[entry / 32] |= uint32_t(0xFFFF) << (entry % 32);
+    }
+
+    bool tiles = std::any_of(dirty.begin(), dirty.begin() + TILE_COUNT / 64, [](uint64_t word) {
+        return word != 0;
+    });
+    if (!tiles)
+        return;
+    for (size_t entry = 0; entry < 2 * MAP_SIZE; ++entry) {
+        size_t tile = tile_index(vram[MAPS + entry], m_unsigned_index);
+        if ((dirty[tile / 64] & (uint64_t(1) << (tile % 64))) != 0)
+            m_dirty[entry / 32] |= uint32_t(1) << (entry % 32);
+    }
+}
+
+// Map 0 is at $9800, map 1 at $9C00. Any entry of the tile row holding the
+// requested line that is out of date is drawn first, all 8 lines of it.
+const uint8_t* LayerCache::get_row(
+    const uint8_t* vram, const TileCache& tiles, bool unsigned_index, size_t map, unsigned int y
+)
+{
+    if (unsigned_index != m_unsigned_index) {
+        m_unsigned_index = unsigned_index;
+        m_dirty.fill(~uint32_t(0));
+    }
+
+    uint8_t* plane = &m_planes[map * LAYER_SIZE * LAYER_SIZE];
+    size_t tile_row = map * 32 + y / 8;
+    for (uint32_t bits = m_dirty[tile_row]; bits != 0; bits &= bits - 1) {
+        size_t column = 0;
+        while ((bits & (uint32_t(1) << column)) == 0)
+            ++column;
+        size_t tile = tile_index(vram[MAPS + tile_row * 32 + column], unsigned_index);
+        for (unsigned int row = 0; row < 8; ++row) {
+            uint8_t* pixels = plane + ((y / 8) * 8 + row) * LAYER_SIZE + column * 8;
+            std::copy_n(tiles.get_row(tile, row), 8, pixels);
+        }
+    }
+    m_dirty[tile_row] = 0;
+    return plane + static_cast<size_t>(y) * LAYER_SIZE;
+}
+} // namespace cbgb
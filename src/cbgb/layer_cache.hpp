@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Background layer cache.
+//!
+//! Both tile maps describe a 256x256 pixel plane, the background scrolling
+//! across one and the window being drawn from one as well \[[1]\]. This cache
+//! keeps both planes fully drawn as color indices, so that the background of
+//! a scanline is just a copy out of one row, wrapping around at the right
+//! edge.
+//!
+//! Tile map entries that were written, or that point to tiles that were, are
+//! only marked. They are drawn again once a row that holds them is asked for,
+//! so a map rewritten in the middle of a frame costs no more than the rows
+//! that get drawn after it.
+//!
+//! [1]: https://gbdev.io/pandocs/Tile_Maps.html
+
+#ifndef CBGB_LAYER_CACHE_HPP
+#define CBGB_LAYER_CACHE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "cbgb/memory.hpp"
+#include "cbgb/tile_cache.hpp"
+
+namespace cbgb {
+inline constexpr size_t LAYER_SIZE = 256;
+
+/// @brief Both tile maps drawn as 256x256 color indices.
+///
+/// Planes are drawn for one tile addressing mode at a time. Asking for a row
+/// in the other mode redraws both planes from scratch, so a game that flips
+/// LCDC bit 4 often is better served by drawing lines from the tile cache.
+class LayerCache final {
+public:
+    LayerCache();
+    void invalidate(const uint8_t* vram, const VramBitmap& dirty);
+    const uint8_t* get_row(
+        const uint8_t* vram, const TileCache& tiles, bool unsigned_index, size_t map, unsigned int y
+    );
+
+private:
+    alignas(CACHE_LINE_SIZE) std::array<uint8_t, 2 * LAYER_SIZE * LAYER_SIZE> m_planes;
+    std::array<uint32_t, 2 * 32> m_dirty;
+    bool m_unsigned_index;
+};
+} // namespace cbgb
+
+#endif // CBGB_LAYER_CACHE_HPP
@@ -0,0 +1,280 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CBGB_HAVE_UNIX_SOCKETS 1
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#else
+#define CBGB_HAVE_UNIX_SOCKETS 0
+#endif
+
+#include <fmt/format.h>
+
+#include "cbgb/gameboy.hpp"
+#include "cbgb/link.hpp"
+#include "cbgb/serial.hpp"
+
+namespace cbgb {
+// The side that connects may well start before the side that listens.
+constexpr int CONNECT_ATTEMPTS = 100;
+constexpr std::chrono::milliseconds CONNECT_DELAY(50);
+
+// Whole instructions, so a window may overshoot its end a little. The next
+// window still ends where it would have otherwise.
+static void run_until(GameBoy& gameboy, uint64_t end)
+{
+    while (gameboy.get_mcycle_count() < end)
+        gameboy.step();
+}
+
+static void check_window(unsigned int window)
+{
+    if (window == 0)
+        throw std::invalid_argument("Link window is zero M-cycles");
+}
+
+LinkCable::LinkCable(GameBoy& left, GameBoy& right, unsigned int window)
+    : m_left(left)
+    , m_right(right)
+    , m_left_end(left.get_mcycle_count() + window)
+    , m_right_end(right.get_mcycle_count() + window)
+    , m_window(window)
+{
+    check_window(window);
+    m_left.get_serial().set_linked(true);
+    m_right.get_serial().set_linked(true);
+}
+
+LinkCable::~LinkCable()
+{
+    m_left.get_serial().set_linked(false);
+    m_right.get_serial().set_linked(false);
+}
+
+// Both packets are taken before either side settles, as settling changes
+// what the port would report.
+void LinkCable::step_window()
+{
+    run_until(m_left, m_left_end);
+    run_until(m_right, m_right_end);
+    LinkPacket left = m_left.get_serial().get_packet();
+    LinkPacket right = m_right.get_serial().get_packet();
+    m_left.get_serial().receive(right);
+    m_right.get_serial().receive(left);
+    m_left_end += m_window;
+    m_right_end += m_window;
+}
+
+// Runs until both machines completed at least that many more frames.
+void LinkCable::step_frames(uint64_t frames)
+{
+    uint64_t left = m_left.get_frame_count() + frames;
+    uint64_t right = m_right.get_frame_count() + frames;
+    while (m_left.get_frame_count() < left || m_right.get_frame_count() < right)
+        step_window();
+}
+
+#if CBGB_HAVE_UNIX_SOCKETS
+static sockaddr_un make_address(const std::string& path)
+{
+    sockaddr_un address = {};
+    if (path.size() >= sizeof(address.sun_path))
+        throw std::invalid_argument(fmt::format("Link socket path '{}' is too long", path));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+static int open_socket(const std::string& path)
+{
+    int socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socket < 0) {
+        throw std::runtime_error(
+            fmt::format("Cannot create link socket '{0}': {1}", path, std::strerror(errno))
+        );
+    }
+    return socket;
+}
+
+// Waits for the one and only partner, and stops listening right after.
+static int listen_socket(const std::string& path)
+{
+    sockaddr_un address = make_address(path);
+    int listener = open_socket(path);
+    ::unlink(path.c_str());
+    const auto* name = reinterpret_cast<const sockaddr*>(&address);
+    if (::bind(listener, name, sizeof(address)) != 0 || ::listen(listener, 1) != 0) {
+        int error = errno;
+        ::close(listener);
+        throw std::runtime_error(
+            fmt::format("Cannot listen on link socket '{0}': {1}", path, std::strerror(error))
+        );
+    }
+
+    int socket = ::accept(listener, nullptr, nullptr);
+    int error = errno;
+    ::close(listener);
+    ::unlink(path.c_str());
+    if (socket < 0) {
+        throw std::runtime_error(
+            fmt::format("Cannot accept on link socket '{0}': {1}", path, std::strerror(error))
+        );
+    }
+    return socket;
+}
+
+static int connect_socket(const std::string& path)
+{
+    sockaddr_un address = make_address(path);
+    const auto* name = reinterpret_cast<const sockaddr*>(&address);
+    int error = 0;
+    for (int attempt = 0; attempt < CONNECT_ATTEMPTS; ++attempt) {
+        int socket = open_socket(path);
+        if (::connect(socket, name, sizeof(address)) == 0)
+            return socket;
+        error = errno;
+        ::close(socket);
+        if (error != ENOENT && error != ECONNREFUSED)
+            break;
+        std::this_thread::sleep_for(CONNECT_DELAY);
+    }
+    throw std::runtime_error(
+        fmt::format("Cannot connect to link socket '{0}': {1}", path, std::strerror(error))
+    );
+}
+
+static void send_all(int socket, const void* data, size_t size)
+{
+#if defined(MSG_NOSIGNAL)
+    constexpr int flags = MSG_NOSIGNAL;
+#else
+    constexpr int flags = 0;
+#endif
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t sent = ::send(socket, bytes, size, flags);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            throw std::runtime_error(fmt::format("Link send failed: {}", std::strerror(errno)));
+        bytes += sent;
+        size -= static_cast<size_t>(sent);
+    }
+}
+
+static void receive_all(int socket, void* data, size_t size)
+{
+    auto* bytes = static_cast<uint8_t*>(data);
+    while (size > 0) {
+        ssize_t received = ::recv(socket, bytes, size, 0);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received == 0)
+            throw std::runtime_error("Link partner hung up");
+        if (received < 0)
+            throw std::runtime_error(fmt::format("Link receive failed: {}", std::strerror(errno)));
+        bytes += received;
+        size -= static_cast<size_t>(received);
+    }
+}
+
+static int open_link(const std::string& path, LinkRole role)
+{
+    return role == LinkRole::LISTEN ? listen_socket(path) : connect_socket(path);
+}
+#else
+static int open_link(const std::string& path, LinkRole)
+{
+    throw std::runtime_error(fmt::format("Link socket '{}' needs Unix domain sockets", path));
+}
+#endif
+
+// Both sides send before they receive, which never blocks on such small
+// messages. Windows are compared first thing, as sides that disagree on them
+// would settle transfers at different times.
+LinkSocket::LinkSocket(
+    GameBoy& gameboy, const std::string& path, LinkRole role, unsigned int window
+)
+    : m_gameboy(gameboy)
+    , m_end(gameboy.get_mcycle_count() + window)
+    , m_window(window)
+    , m_socket(-1)
+{
+    check_window(window);
+    m_socket = open_link(path, role);
+#if CBGB_HAVE_UNIX_SOCKETS
+    uint32_t own = m_window;
+    uint32_t partner = 0;
+    try {
+        send_all(m_socket, &own, sizeof(own));
+        receive_all(m_socket, &partner, sizeof(partner));
+    }
+    catch (...) {
+        ::close(m_socket);
+        throw;
+    }
+    if (partner != m_window) {
+        ::close(m_socket);
+        throw std::runtime_error(fmt::format(
+            "Link partner runs windows of {0} M-cycles, not {1}", partner, m_window
+        ));
+    }
+#endif
+    m_gameboy.get_serial().set_linked(true);
+}
+
+LinkSocket::~LinkSocket()
+{
+    m_gameboy.get_serial().set_linked(false);
+#if CBGB_HAVE_UNIX_SOCKETS
+    ::close(m_socket);
+#endif
+}
+
+void LinkSocket::step_window()
+{
+    run_until(m_gameboy, m_end);
+    settle(0);
+}
+
+// Only the frames of this side count, the other side runs until its own.
+// Whichever gets there first keeps the link going until both are done.
+void LinkSocket::step_frames(uint64_t frames)
+{
+    uint64_t target = m_gameboy.get_frame_count() + frames;
+    while (true) {
+        run_until(m_gameboy, m_end);
+        bool done = m_gameboy.get_frame_count() >= target;
+        uint8_t partner = settle(done ? LINK_DONE : 0);
+        if (done && (partner & LINK_DONE) != 0)
+            return;
+    }
+}
+
+// Ends the window with the packet of this side, plus any extra flags, and
+// hands back the flags of the other side.
+uint8_t LinkSocket::settle(uint8_t flags)
+{
+    LinkPacket packet = m_gameboy.get_serial().get_packet();
+    uint8_t message[2] = { packet.data, static_cast<uint8_t>(packet.flags | flags) };
+#if CBGB_HAVE_UNIX_SOCKETS
+    send_all(m_socket, message, sizeof(message));
+    receive_all(m_socket, message, sizeof(message));
+#endif
+    LinkPacket partner = { message[0], message[1] };
+    m_gameboy.get_serial().receive(partner);
+    m_end += m_window;
+    return partner.flags;
+}
+} // namespace cbgb
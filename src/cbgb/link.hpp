@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Link cable between two machines.
+//!
+//! Linked machines are synchronized in windows of a fixed number of M-cycles,
+//! rather than every time a bit goes over the cable. Each side runs through a
+//! whole window on its own, then both exchange one #LinkPacket that settles
+//! every transfer of that window. A transfer takes one window at the least,
+//! and gets through in the window its 1024 T-cycles run out in. With windows
+//! of a quarter frame, that is quick enough for the handshakes of trades and
+//! battles, which poll and retry anyway.
+//!
+//! Since both sides only ever see each other at the end of a window, how far
+//! apart they run in between makes no difference to either of them. Two
+//! machines in one process are simply stepped one after another. Machines in
+//! different processes exchange their packets over a Unix domain socket, and
+//! stay just as deterministic, as long as both use the same window.
+
+#ifndef CBGB_LINK_HPP
+#define CBGB_LINK_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "cbgb/gameboy.hpp"
+#include "cbgb/serial.hpp"
+
+namespace cbgb {
+/// @brief Default window in M-cycles, a quarter frame.
+inline constexpr unsigned int LINK_WINDOW = MCYCLES_PER_FRAME / 4;
+
+/// @brief Link cable between two machines in the same process.
+///
+/// Machines are linked for as long as the cable exists. Stepping either of
+/// them other than through the cable leaves transfers hanging.
+class LinkCable final {
+public:
+    LinkCable(GameBoy& left, GameBoy& right, unsigned int window = LINK_WINDOW);
+    ~LinkCable();
+    LinkCable(const LinkCable&) = delete;
+    LinkCable& operator=(const LinkCable&) = delete;
+    void step_window();
+    void step_frames(uint64_t frames);
+
+private:
+    GameBoy& m_left;
+    GameBoy& m_right;
+    uint64_t m_left_end;
+    uint64_t m_right_end;
+    unsigned int m_window;
+};
+
+/// @brief How a #LinkSocket gets to the other side.
+enum class LinkRole {
+    LISTEN,
+    CONNECT,
+};
+
+/// @brief Link cable to a machine in another process.
+///
+/// One side listens on a socket path, the other connects to it, and both
+/// block until then. Both sides have to agree on the window, or they refuse
+/// to link.
+class LinkSocket final {
+public:
+    LinkSocket(
+        GameBoy& gameboy,
+        const std::string& path,
+        LinkRole role,
+        unsigned int window = LINK_WINDOW
+    );
+    ~LinkSocket();
+    LinkSocket(const LinkSocket&) = delete;
+    LinkSocket& operator=(const LinkSocket&) = delete;
+    void step_window();
+    void step_frames(uint64_t frames);
+
+private:
+    uint8_t settle(uint8_t flags);
+
+    GameBoy& m_gameboy;
+    uint64_t m_end;
+    unsigned int m_window;
+    int m_socket;
+};
+} // namespace cbgb
+
+#endif // CBGB_LINK_HPP
@@ -0,0 +1,592 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CBGB_HAVE_AVX2 1
+#include <immintrin.h>
+#else
+#define CBGB_HAVE_AVX2 0
+#endif
+
+#include "cbgb/cpu.hpp"
+#include "cbgb/gameboy.hpp"
+#include "cbgb/lockstep.hpp"
+
+namespace cbgb {
+// Start of the I/O registers. Reading anything below them is free of side
+// effects, so lanes fetch their opcodes and immediates straight from the
+// memory image there.
+constexpr uint16_t IO_START = 0xFF00;
+
+using LaneBytes = std::array<uint8_t, LOCKSTEP_LANES>;
+
+// Opcodes with a vector kernel. All of them only touch registers, and take as
+// many M-cycles as they are bytes long. Arithmetic kernels set flags by the
+// same rules as #Sm83, so a lane ends up with the same flags on either path.
+// That includes taking the half carry from the result and the operand after
+// A is written, which differs from the operand itself when it is A.
+enum class VectorOp : uint8_t {
+    None,
+    Load,
+    Add,
+    Adc,
+    Sub,
+    Sbc,
+    And,
+    Xor,
+    Or,
+    Cp,
+    Inc,
+    Dec,
+    Cpl,
+    Scf,
+    Ccf,
+};
+
+constexpr std::array<VectorOp, 256> new_vector_op_table()
+{
+    std::array<VectorOp, 256> table = {};
+    for (unsigned int dst = 0; dst < 8; ++dst) {
+        for (unsigned int src = 0; src < 8; ++src) {
+            if (dst != 6 && src != 6)
+                table[0x40 | (dst << 3) | src] = VectorOp::Load;
+        }
+        if (dst != 6) {
+            table[0x04 | (dst << 3)] = VectorOp::Inc;
+            table[0x05 | (dst << 3)] = VectorOp::Dec;
+        }
+    }
+
+    // Index 6 of the ALU block reads (HL), and is taken by the immediate forms
+    // instead, which read their operand from the byte after the opcode.
+    constexpr std::array<VectorOp, 8> alu = {
+        VectorOp::Add, VectorOp::Adc, VectorOp::Sub, VectorOp::Sbc,
+        VectorOp::And, VectorOp::Xor, VectorOp::Or,  VectorOp::Cp,
+    };
+    for (unsigned int op = 0; op < 8; ++op) {
+        for (unsigned int src = 0; src < 8; ++src) {
+            if (src != 6)
+                table[0x80 | (op << 3) | src] = alu[op];
+        }
+        table[0xC6 | (op << 3)] = alu[op];
+    }
+
+    // Sm83 runs AND n as XOR n, so that one is left to it.
+    table[0xE6] = VectorOp::None;
+    table[0x2F] = VectorOp::Cpl;
+    table[0x37] = VectorOp::Scf;
+    table[0x3F] = VectorOp::Ccf;
+    return table;
+}
+constexpr std::array<VectorOp, 256> vector_op_table = new_vector_op_table();
+
+constexpr bool is_immediate(uint8_t opcode)
+{
+    return (opcode & 0xC7) == 0xC6;
+}
+
+// Picks the operand lanes of an instruction, which are the immediates fetched
+// for each lane when it has one.
+inline const uint8_t* source_lanes(const Sm83Lanes& lanes, uint8_t opcode, const LaneBytes& immediates)
+{
+    return is_immediate(opcode) ? immediates.data() : lanes.regs[opcode & 7].data();
+}
+
+void execute_portable(
+    Sm83Lanes& lanes, uint8_t opcode, const LaneBytes& mask, const LaneBytes& immediates
+)
+{
+    auto& a = lanes.regs[LANE_A];
+    auto& f = lanes.regs[LANE_F];
+    auto& dst = lanes.regs[(opcode >> 3) & 7];
+    const uint8_t* src = source_lanes(lanes, opcode, immediates);
+    VectorOp kind = vector_op_table[opcode];
+
+    for (unsigned int i = 0; i < LOCKSTEP_LANES; ++i) {
+        if (mask[i] == 0)
+            continue;
+
+        uint8_t result = 0;
+        uint8_t operand = 0;
+        uint8_t carry = (f[i] >> 4) & 1;
+        switch (kind) {
+        case VectorOp::Load:
+            dst[i] = src[i];
+            break;
+        case VectorOp::Add:
+        case VectorOp::Adc:
+            carry = kind == VectorOp::Adc ? carry : 0;
+            result = static_cast<uint8_t>(a[i] + src[i] + carry);
+            a[i] = result;
+            operand = static_cast<uint8_t>(src[i] + carry);
+            f[i] = static_cast<uint8_t>(
+                (f[i] & 0x0F) | (result == 0 ? 0x80 : 0x00)
+                | ((((result & 0x0F) + (operand & 0x0F)) & 0x10) << 1)
+            );
+            break;
+        case VectorOp::Sub:
+        case VectorOp::Sbc:
+            carry = kind == VectorOp::Sbc ? carry : 0;
+            result = static_cast<uint8_t>(a[i] - src[i] - carry);
+            a[i] = result;
+            operand = static_cast<uint8_t>(src[i] - carry);
+            f[i] = static_cast<uint8_t>(
+                (f[i] & 0x0F) | (result == 0 ? 0x80 : 0x00) | 0x40
+                | ((((result & 0x0F) - (operand & 0x0F)) & 0x10) << 1)
+            );
+            break;
+        case VectorOp::And:
+            result = a[i] & src[i];
+            a[i] = result;
+            f[i] = static_cast<uint8_t>((f[i] & 0x0F) | (result == 0 ? 0x80 : 0x00) | 0x20);
+            break;
+        case VectorOp::Xor:
+            result = a[i] ^ src[i];
+            a[i] = result;
+            f[i] = static_cast<uint8_t>((f[i] & 0x0F) | (result == 0 ? 0x80 : 0x00));
+            break;
+        case VectorOp::Or:
+            result = a[i] | src[i];
+            a[i] = result;
+            f[i] = static_cast<uint8_t>((f[i] & 0x0F) | (result == 0 ? 0x80 : 0x00));
+            break;
+        case VectorOp::Cp:
+            result = static_cast<uint8_t>(a[i] - src[i]);
+            f[i] = static_cast<uint8_t>(
+                (f[i] & 0x0F) | (result == 0 ? 0x80 : 0x00) | 0x40
+                | ((a[i] & 0x0F) < (src[i] & 0x0F) ? 0x20 : 0x00) | (a[i] < src[i] ? 0x10 : 0x00)
+            );
+            break;
+        case VectorOp::Inc:
+            result = static_cast<uint8_t>(dst[i] + 1);
+            dst[i] = result;
+            f[i] = static_cast<uint8_t>(
+                (f[i] & 0x1F) | (result == 0 ? 0x80 : 0x00) | ((result & 0x0F) == 0 ? 0x20 : 0x00)
+            );
+            break;
+        case VectorOp::Dec:
+            result = static_cast<uint8_t>(dst[i] - 1);
+            dst[i] = result;
+            f[i] = static_cast<uint8_t>(
+                (f[i] & 0x1F) | (result == 0 ? 0x80 : 0x00)
+                | ((result & 0x0F) == 0x0F ? 0x20 : 0x00)
+            );
+            break;
+        case VectorOp::Cpl:
+            a[i] = static_cast<uint8_t>(~a[i]);
+            f[i] |= 0x60;
+            break;
+        case VectorOp::Scf:
+            f[i] = static_cast<uint8_t>((f[i] & 0x8F) | 0x10);
+            break;
+        case VectorOp::Ccf:
+            f[i] = static_cast<uint8_t>((f[i] & 0x8F) | (~f[i] & 0x10));
+            break;
+        case VectorOp::None:
+            break;
+        }
+    }
+}
+
+#if CBGB_HAVE_AVX2
+#define CBGB_AVX2 __attribute__((target("avx2")))
+
+CBGB_AVX2 inline __m256i load_lanes(const uint8_t* lanes)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes));
+}
+
+CBGB_AVX2 inline void store_lanes(uint8_t* lanes, __m256i value, __m256i mask)
+{
+    __m256i old = load_lanes(lanes);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), _mm256_blendv_epi8(old, value, mask));
+}
+
+CBGB_AVX2 inline __m256i splat(uint8_t value)
+{
+    return _mm256_set1_epi8(static_cast<char>(value));
+}
+
+// Yields `flag` in every lane where value is zero, and zero elsewhere.
+CBGB_AVX2 inline __m256i flag_if_zero(__m256i value, uint8_t flag)
+{
+    return _mm256_and_si256(_mm256_cmpeq_epi8(value, _mm256_setzero_si256()), splat(flag));
+}
+
+// Moves the half carry out of bit 4 of every lane into the H flag at bit 5.
+CBGB_AVX2 inline __m256i half_carry(__m256i nibble_sum)
+{
+    __m256i carry = _mm256_and_si256(nibble_sum, splat(0x10));
+    return _mm256_add_epi8(carry, carry);
+}
+
+CBGB_AVX2 inline __m256i low_nibble(__m256i value)
+{
+    return _mm256_and_si256(value, splat(0x0F));
+}
+
+CBGB_AVX2 void execute_avx2(
+    Sm83Lanes& lanes, uint8_t opcode, const LaneBytes& lane_mask, const LaneBytes& immediates
+)
+{
+    uint8_t* a_lanes = lanes.regs[LANE_A].data();
+    uint8_t* f_lanes = lanes.regs[LANE_F].data();
+    uint8_t* dst_lanes = lanes.regs[(opcode >> 3) & 7].data();
+    const uint8_t* src_lanes = source_lanes(lanes, opcode, immediates);
+    __m256i mask = load_lanes(lane_mask.data());
+    __m256i a = load_lanes(a_lanes);
+    __m256i f = load_lanes(f_lanes);
+    __m256i carry = _mm256_and_si256(_mm256_srli_epi16(f, 4), splat(0x01));
+    __m256i src;
+    __m256i operand;
+    __m256i result;
+
+    switch (vector_op_table[opcode]) {
+    case VectorOp::Load:
+        store_lanes(dst_lanes, load_lanes(src_lanes), mask);
+        break;
+    case VectorOp::Add:
+    case VectorOp::Adc:
+        if (vector_op_table[opcode] != VectorOp::Adc)
+            carry = _mm256_setzero_si256();
+        result = _mm256_add_epi8(_mm256_add_epi8(a, load_lanes(src_lanes)), carry);
+        store_lanes(a_lanes, result, mask);
+        operand = _mm256_add_epi8(load_lanes(src_lanes), carry);
+        f = _mm256_or_si256(_mm256_and_si256(f, splat(0x0F)), flag_if_zero(result, 0x80));
+        f = _mm256_or_si256(
+            f, half_carry(_mm256_add_epi8(low_nibble(result), low_nibble(operand)))
+        );
+        store_lanes(f_lanes, f, mask);
+        break;
+    case VectorOp::Sub:
+    case VectorOp::Sbc:
+        if (vector_op_table[opcode] != VectorOp::Sbc)
+            carry = _mm256_setzero_si256();
+        result = _mm256_sub_epi8(_mm256_sub_epi8(a, load_lanes(src_lanes)), carry);
+        store_lanes(a_lanes, result, mask);
+        operand = _mm256_sub_epi8(load_lanes(src_lanes), carry);
+        f = _mm256_or_si256(_mm256_and_si256(f, splat(0x0F)), flag_if_zero(result, 0x80));
+        f = _mm256_or_si256(f, splat(0x40));
+        f = _mm256_or_si256(
+            f, half_carry(_mm256_sub_epi8(low_nibble(result), low_nibble(operand)))
+        );
+        store_lanes(f_lanes, f, mask);
+        break;
+    case VectorOp::And:
+        result = _mm256_and_si256(a, load_lanes(src_lanes));
+        f = _mm256_or_si256(_mm256_and_si256(f, splat(0x0F)), flag_if_zero(result, 0x80));
+        store_lanes(a_lanes, result, mask);
+        store_lanes(f_lanes, _mm256_or_si256(f, splat(0x20)), mask);
+        break;
+    case VectorOp::Xor:
+        result = _mm256_xor_si256(a, load_lanes(src_lanes));
+        f = _mm256_or_si256(_mm256_and_si256(f, splat(0x0F)), flag_if_zero(result, 0x80));
+        store_lanes(a_lanes, result, mask);
+        store_lanes(f_lanes, f, mask);
+        break;
+    case VectorOp::Or:
+        result = _mm256_or_si256(a, load_lanes(src_lanes));
+        f = _mm256_or_si256(_mm256_and_si256(f, splat(0x0F)), flag_if_zero(result, 0x80));
+        store_lanes(a_lanes, result, mask);
+        store_lanes(f_lanes, f, mask);
+        break;
+    case VectorOp::Cp:
+        // Carry is set where A is below the operand, so their maximum is not A.
+        src = load_lanes(src_lanes);
+        result = _mm256_sub_epi8(a, src);
+        f = _mm256_or_si256(_mm256_and_si256(f, splat(0x0F)), flag_if_zero(result, 0x80));
+        f = _mm256_or_si256(f, splat(0x40));
+        f = _mm256_or_si256(f, half_carry(_mm256_sub_epi8(low_nibble(a), low_nibble(src))));
+        f = _mm256_or_si256(
+            f, _mm256_andnot_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(a, src), a), splat(0x10))
+        );
+        store_lanes(f_lanes, f, mask);
+        break;
+    case VectorOp::Inc:
+        result = _mm256_add_epi8(load_lanes(dst_lanes), splat(0x01));
+        f = _mm256_or_si256(_mm256_and_si256(f, splat(0x1F)), flag_if_zero(result, 0x80));
+        f = _mm256_or_si256(f, flag_if_zero(low_nibble(result), 0x20));
+        store_lanes(dst_lanes, result, mask);
+        store_lanes(f_lanes, f, mask);
+        break;
+    case VectorOp::Dec:
+        result = _mm256_sub_epi8(load_lanes(dst_lanes), splat(0x01));
+        f = _mm256_or_si256(_mm256_and_si256(f, splat(0x1F)), flag_if_zero(result, 0x80));
+        f = _mm256_or_si256(
+            f, _mm256_and_si256(_mm256_cmpeq_epi8(low_nibble(result), splat(0x0F)), splat(0x20))
+        );
+        store_lanes(dst_lanes, result, mask);
+        store_lanes(f_lanes, f, mask);
+        break;
+    case VectorOp::Cpl:
+        store_lanes(a_lanes, _mm256_xor_si256(a, splat(0xFF)), mask);
+        store_lanes(f_lanes, _mm256_or_si256(f, splat(0x60)), mask);
+        break;
+    case VectorOp::Scf:
+        f = _mm256_or_si256(_mm256_and_si256(f, splat(0x8F)), splat(0x10));
+        store_lanes(f_lanes, f, mask);
+        break;
+    case VectorOp::Ccf:
+        result = _mm256_andnot_si256(f, splat(0x10));
+        f = _mm256_or_si256(_mm256_and_si256(f, splat(0x8F)), result);
+        store_lanes(f_lanes, f, mask);
+        break;
+    case VectorOp::None:
+        break;
+    }
+}
+#endif
+
+using VectorKernel = void (*)(Sm83Lanes&, uint8_t, const LaneBytes&, const LaneBytes&);
+
+VectorKernel select_vector_kernel()
+{
+#if CBGB_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2"))
+        return execute_avx2;
+#endif
+    return execute_portable;
+}
+const VectorKernel execute_vector = select_vector_kernel();
+
+LockstepSm83::LockstepSm83(const std::vector<GameBoy*>& machines)
+    : m_lanes()
+    , m_machines(machines)
+    , m_pending()
+    , m_pending_instructions()
+    , m_frame_left()
+    , m_scalar_lanes(0)
+    , m_vector_count(0)
+    , m_scalar_count(0)
+{
+    if (m_machines.size() > LOCKSTEP_LANES)
+        throw std::invalid_argument("Too many machines for lockstep interpreter");
+
+    for (unsigned int lane = 0; lane < size(); ++lane) {
+        Sm83Snapshot cpu = {};
+        m_machines[lane]->get_cpu().save_state(cpu);
+        load_lane(lane, cpu);
+    }
+}
+
+void LockstepSm83::step()
+{
+    step_lanes(all_lanes());
+    for (unsigned int lane = 0; lane < size(); ++lane)
+        catch_up(lane);
+}
+
+// Lanes that finish their frame early sit idle until every lane is done, so
+// all machines stay on the same frame.
+void LockstepSm83::step_frame()
+{
+    uint32_t active = all_lanes();
+    while (active != 0)
+        active &= ~step_lanes(active);
+}
+
+// Lanes on the scalar path come back to the vector side as well, so that both
+// sides hold the same registers afterwards.
+void LockstepSm83::sync()
+{
+    for (unsigned int lane = 0; lane < size(); ++lane) {
+        Sm83Snapshot cpu = {};
+        save_lane(lane, cpu);
+        load_lane(lane, cpu);
+        m_machines[lane]->get_cpu().load_state(cpu);
+    }
+}
+
+void LockstepSm83::save_lane(unsigned int lane, Sm83Snapshot& cpu) const
+{
+    if ((m_scalar_lanes & (uint32_t(1) << lane)) != 0) {
+        m_machines[lane]->get_cpu().save_state(cpu);
+        return;
+    }
+
+    cpu.a = m_lanes.regs[LANE_A][lane];
+    cpu.f = m_lanes.regs[LANE_F][lane];
+    cpu.b = m_lanes.regs[LANE_B][lane];
+    cpu.c = m_lanes.regs[LANE_C][lane];
+    cpu.d = m_lanes.regs[LANE_D][lane];
+    cpu.e = m_lanes.regs[LANE_E][lane];
+    cpu.h = m_lanes.regs[LANE_H][lane];
+    cpu.l = m_lanes.regs[LANE_L][lane];
+    cpu.pc = m_lanes.pc[lane];
+    cpu.sp = m_lanes.sp[lane];
+    cpu.mcycles = m_lanes.mcycles[lane];
+}
+
+void LockstepSm83::load_lane(unsigned int lane, const Sm83Snapshot& cpu)
+{
+    m_lanes.regs[LANE_A][lane] = cpu.a;
+    m_lanes.regs[LANE_F][lane] = cpu.f;
+    m_lanes.regs[LANE_B][lane] = cpu.b;
+    m_lanes.regs[LANE_C][lane] = cpu.c;
+    m_lanes.regs[LANE_D][lane] = cpu.d;
+    m_lanes.regs[LANE_E][lane] = cpu.e;
+    m_lanes.regs[LANE_H][lane] = cpu.h;
+    m_lanes.regs[LANE_L][lane] = cpu.l;
+    m_lanes.pc[lane] = cpu.pc;
+    m_lanes.sp[lane] = cpu.sp;
+    m_lanes.mcycles[lane] = cpu.mcycles;
+    m_scalar_lanes &= ~(uint32_t(1) << lane);
+}
+
+unsigned int LockstepSm83::size() const
+{
+    return static_cast<unsigned int>(m_machines.size());
+}
+
+const Sm83Lanes& LockstepSm83::get_lanes() const
+{
+    return m_lanes;
+}
+
+uint64_t LockstepSm83::get_vector_count() const
+{
+    return m_vector_count;
+}
+
+uint64_t LockstepSm83::get_scalar_count() const
+{
+    return m_scalar_count;
+}
+
+uint32_t LockstepSm83::all_lanes() const
+{
+    return size() == LOCKSTEP_LANES ? ~uint32_t(0) : (uint32_t(1) << size()) - 1;
+}
+
+// Executes one instruction on every active lane, and returns the lanes that
+// completed a frame while doing so. A lane has run out its frame once its
+// vector instructions took as many M-cycles as were left in it.
+uint32_t LockstepSm83::step_lanes(uint32_t active)
+{
+    LaneBytes opcodes = {};
+    alignas(32) LaneBytes immediates = {};
+    uint32_t vector_lanes = 0;
+    uint32_t finished = 0;
+    unsigned int count = size();
+
+    for (unsigned int lane = 0; lane < count; ++lane) {
+        uint32_t bit = uint32_t(1) << lane;
+        if ((active & bit) == 0)
+            continue;
+
+        uint8_t opcode = 0;
+        if (fetch_vector(lane, opcode, immediates[lane])) {
+            opcodes[lane] = opcode;
+            vector_lanes |= bit;
+            continue;
+        }
+
+        if (step_scalar(lane))
+            finished |= bit;
+    }
+
+    uint32_t pending = vector_lanes;
+    for (unsigned int leader = 0; leader < count && pending != 0; ++leader) {
+        uint32_t leader_bit = uint32_t(1) << leader;
+        if ((pending & leader_bit) == 0)
+            continue;
+
+        uint32_t group = 0;
+        alignas(32) LaneBytes mask = {};
+        for (unsigned int lane = leader; lane < count; ++lane) {
+            if ((pending & (uint32_t(1) << lane)) != 0 && opcodes[lane] == opcodes[leader]) {
+                mask[lane] = 0xFF;
+                group |= uint32_t(1) << lane;
+            }
+        }
+        pending &= ~group;
+
+        // A lane on the scalar path only comes back for a kernel it shares.
+        if (group == leader_bit && (m_scalar_lanes & leader_bit) != 0) {
+            if (step_scalar(leader))
+                finished |= leader_bit;
+            continue;
+        }
+
+        for (unsigned int lane = leader; lane < count; ++lane) {
+            uint32_t bit = uint32_t(1) << lane;
+            if ((group & m_scalar_lanes & bit) != 0) {
+                Sm83Snapshot cpu = {};
+                save_lane(lane, cpu);
+                load_lane(lane, cpu);
+            }
+        }
+        uint8_t opcode = opcodes[leader];
+        unsigned int length = get_opcode_length(opcode);
+        execute_vector(m_lanes, opcode, mask, immediates);
+        ++m_vector_count;
+
+        for (unsigned int lane = leader; lane < count; ++lane) {
+            uint32_t bit = uint32_t(1) << lane;
+            if ((group & bit) == 0)
+                continue;
+
+            if (m_pending[lane] == 0)
+                m_frame_left[lane] = m_machines[lane]->get_ppu().get_mcycles_to_frame();
+            m_lanes.pc[lane] = static_cast<uint16_t>(m_lanes.pc[lane] + length);
+            m_lanes.mcycles[lane] += length;
+            m_pending[lane] += length;
+            ++m_pending_instructions[lane];
+            if (m_pending[lane] >= m_frame_left[lane] && catch_up(lane))
+                finished |= bit;
+        }
+    }
+    return finished;
+}
+
+// Fetches the next opcode of a lane, along with its immediate if it has one,
+// and returns whether it has a kernel.
+bool LockstepSm83::fetch_vector(unsigned int lane, uint8_t& opcode, uint8_t& immediate)
+{
+    GameBoy& machine = *m_machines[lane];
+    bool scalar = (m_scalar_lanes & (uint32_t(1) << lane)) != 0;
+    uint16_t pc = scalar ? machine.get_cpu().get_state().pc : m_lanes.pc[lane];
+    if (pc >= IO_START - 1)
+        return false;
+    const MemoryImage& image = machine.get_memory().get_image();
+    opcode = image[pc];
+    immediate = image[pc + 1];
+    return vector_op_table[opcode] != VectorOp::None;
+}
+
+// Moves a lane onto the scalar path of its own machine if it is not there yet,
+// and runs one instruction there. Anything the instruction does might depend
+// on the rest of the machine, which catches up on the lane first.
+bool LockstepSm83::step_scalar(unsigned int lane)
+{
+    uint32_t bit = uint32_t(1) << lane;
+    GameBoy& machine = *m_machines[lane];
+    if (m_pending[lane] != 0)
+        catch_up(lane);
+    if ((m_scalar_lanes & bit) == 0) {
+        Sm83Snapshot cpu = {};
+        save_lane(lane, cpu);
+        machine.get_cpu().load_state(cpu);
+        m_scalar_lanes |= bit;
+    }
+
+    ++m_scalar_count;
+    return machine.advance(machine.get_cpu().step());
+}
+
+// Advances the machine of a lane by the vector instructions it ran since it
+// last did, and returns true if that completed a frame.
+bool LockstepSm83::catch_up(unsigned int lane)
+{
+    unsigned int mcycles = m_pending[lane];
+    unsigned int instructions = m_pending_instructions[lane];
+    m_pending[lane] = 0;
+    m_pending_instructions[lane] = 0;
+    return mcycles != 0 && m_machines[lane]->advance(mcycles, instructions);
+}
+} // namespace cbgb
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Lockstep multi-instance SM83 interpreter.
+//!
+//! Steps up to 32 independent machines one instruction at a time, all at
+//! once. Register files are kept structure-of-arrays, so one 256-bit AVX2
+//! register holds, say, the A register of every lane. Lanes that fetched the
+//! same opcode execute it together with a masked vector kernel. Lanes whose
+//! opcode has no vector kernel, like anything touching memory, are peeled off
+//! onto the scalar #Sm83 of their own machine. They stay there, registers and
+//! all, until they fetch an opcode they can share a kernel with again.
+//!
+//! Vector kernels never touch memory, so the rest of a machine only has to
+//! catch up on them before its next scalar instruction, or right when its
+//! frame runs out, rather than after every single one.
+//!
+//! Lanes running the same program tend to stay on the same opcode, which is
+//! exactly the case reinforcement learning style workloads produce.
+
+#ifndef CBGB_LOCKSTEP_HPP
+#define CBGB_LOCKSTEP_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "cbgb/cpu.hpp"
+#include "cbgb/gameboy.hpp"
+
+namespace cbgb {
+inline constexpr unsigned int LOCKSTEP_LANES = 32;
+
+/// @brief Structure-of-arrays SM83 register file.
+///
+/// The 8-bit registers are indexed by their SM83 operand encoding, so that
+/// `regs[opcode & 7]` picks the source operand of most instructions. Index 6
+/// encodes (HL), which is not a register, so F is kept there instead.
+struct alignas(32) Sm83Lanes {
+    std::array<std::array<uint8_t, LOCKSTEP_LANES>, 8> regs;
+    std::array<uint16_t, LOCKSTEP_LANES> pc;
+    std::array<uint16_t, LOCKSTEP_LANES> sp;
+    std::array<unsigned int, LOCKSTEP_LANES> mcycles;
+};
+
+enum LaneRegister : unsigned int {
+    LANE_B = 0,
+    LANE_C = 1,
+    LANE_D = 2,
+    LANE_E = 3,
+    LANE_H = 4,
+    LANE_L = 5,
+    LANE_F = 6,
+    LANE_A = 7,
+};
+
+/// @brief Lockstep interpreter over a set of machines.
+///
+/// Takes over the CPU state of every machine on construction. Changes only
+/// show up in the machines' own #Sm83, and in #get_lanes, after calling #sync.
+class LockstepSm83 final {
+public:
+    explicit LockstepSm83(const std::vector<GameBoy*>& machines);
+    void step();
+    void step_frame();
+    void sync();
+    void save_lane(unsigned int lane, Sm83Snapshot& cpu) const;
+    void load_lane(unsigned int lane, const Sm83Snapshot& cpu);
+    unsigned int size() const;
+    const Sm83Lanes& get_lanes() const;
+    uint64_t get_vector_count() const;
+    uint64_t get_scalar_count() const;
+
+private:
+    uint32_t all_lanes() const;
+    uint32_t step_lanes(uint32_t active);
+    bool fetch_vector(unsigned int lane, uint8_t& opcode, uint8_t& immediate);
+    bool step_scalar(unsigned int lane);
+    bool catch_up(unsigned int lane);
+
+    Sm83Lanes m_lanes;
+    std::vector<GameBoy*> m_machines;
+    std::array<unsigned int, LOCKSTEP_LANES> m_pending;
+    std::array<unsigned int, LOCKSTEP_LANES> m_pending_instructions;
+    std::array<unsigned int, LOCKSTEP_LANES> m_frame_left;
+    uint32_t m_scalar_lanes;
+    uint64_t m_vector_count;
+    uint64_t m_scalar_count;
+};
+} // namespace cbgb
+
+#endif // CBGB_LOCKSTEP_HPP
@@ -1,29 +1,236 @@
 // SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
 // SPDX-License-Identifier: MIT
 
+#include <algorithm>
 #include <memory>
+#include <utility>
 
 #include <spdlog/spdlog.h>
 
+#include "cbgb/apu.hpp"
 #include "cbgb/memory.hpp"
+#include "cbgb/ppu.hpp"
+#include "cbgb/serial.hpp"
+#include "cbgb/timer.hpp"
 
 namespace cbgb {
-MemoryBus::MemoryBus(std::shared_ptr<spdlog::logger> logger)
+constexpr uint16_t JOYP = 0xFF00;
+constexpr size_t OAM_SIZE = 0xA0;
+constexpr uint64_t ALL_OBJECTS = (uint64_t(1) << (OAM_SIZE / 4)) - 1;
+constexpr size_t VRAM_SIZE = 0x2000;
+constexpr size_t VRAM_BLOCK = 16;
+
+MemoryBus::MemoryBus(spdlog::logger& logger)
     : m_logger(logger)
+    , m_ram()
+    , m_dirty_vram()
+    , m_dirty_oam(ALL_OBJECTS)
+    , m_video_log(nullptr)
+    , m_apu(nullptr)
+    , m_timer(nullptr)
+    , m_serial(nullptr)
+    , m_joypad(0x00)
 {
-    m_logger->trace("Construct new memory bus");
+    // Nothing has seen VRAM yet.
+    m_dirty_vram.fill(~uint64_t(0));
+    m_logger.trace("Construct new memory bus");
 }
 
 uint8_t MemoryBus::read(uint16_t address)
 {
-    uint8_t value = m_ram[address];
-    m_logger->debug("Read {0:04X}: {1:02X}", address, value);
+    // Channels turn themselves off as their length runs out.
+    if (address == NR52 && m_apu != nullptr)
+        m_apu->sync();
+
+    // Timer registers only exist as a function of time.
+    if (address >= DIV && address <= TAC && m_timer != nullptr) {
+        uint8_t value = m_timer->read(address);
+        m_logger.debug("Read {0:04X}: {1:02X}", address, value);
+        return value;
+    }
+    uint8_t value = address == JOYP ? read_joypad() : m_ram[address];
+    m_logger.debug("Read {0:04X}: {1:02X}", address, value);
     return value;
 }
 
 void MemoryBus::write(uint16_t address, uint8_t value)
 {
-    m_logger->debug("Write {0:04X}: {1:02X}", address, value);
+    m_logger.debug("Write {0:04X}: {1:02X}", address, value);
+    if (address >= NR10 && address <= APU_END && m_apu != nullptr) {
+        m_apu->write(address, value);
+        return;
+    }
+    if (address >= DIV && address <= TAC && m_timer != nullptr) {
+        m_timer->write(address, value);
+        return;
+    }
+    if ((address == SB || address == SC) && m_serial != nullptr) {
+        m_serial->write(address, value);
+        return;
+    }
+
+    switch (address) {
+    case LY:
+        // Driven by the PPU alone.
+        return;
+    case STAT:
+        // Mode and coincidence bits are driven by the PPU, bit 7 is unused.
+        m_ram[STAT] = static_cast<uint8_t>(0x80 | (value & 0x78) | (m_ram[STAT] & 0x07));
+        return;
+    case DMA: {
+        // Copies the whole page to OAM at once, rather than over 160 M-cycles.
+        // Pages past work RAM are clamped instead of mirrored.
+        m_ram[DMA] = value;
+        size_t source = static_cast<size_t>(std::min<uint8_t>(value, 0xDF)) << 8;
+        std::copy_n(m_ram.begin() + source, OAM_SIZE, m_ram.begin() + OAM);
+        m_dirty_oam = ALL_OBJECTS;
+        if (m_video_log != nullptr)
+            log_video(OAM, OAM_SIZE);
+        return;
+    }
+    default:
+        m_ram[address] = value;
+        if (m_video_log != nullptr)
+            log_video(address, 1);
+        if ((address & 0xE000) == VRAM) {
+            size_t block = (address - VRAM) / VRAM_BLOCK;
+            m_dirty_vram[block / 64] |= uint64_t(1) << (block % 64);
+        }
+        else if (address >= OAM && address < OAM + OAM_SIZE) {
+            m_dirty_oam |= uint64_t(1) << ((address - OAM) / 4);
+        }
+        break;
+    }
+}
+
+// Writes without any side effects, for peripherals updating their own
+// registers.
+void MemoryBus::store(uint16_t address, uint8_t value)
+{
     m_ram[address] = value;
 }
+
+void MemoryBus::request_interrupt(uint8_t interrupt)
+{
+    m_ram[IF] |= interrupt;
+}
+
+void MemoryBus::load(uint16_t address, const uint8_t* data, size_t size)
+{
+    size = std::min(size, m_ram.size() - address);
+    std::copy_n(data, size, m_ram.begin() + address);
+    mark_vram(address, size);
+    if (address < OAM + OAM_SIZE && address + size > OAM)
+        m_dirty_oam = ALL_OBJECTS;
+    if (m_video_log != nullptr)
+        log_video(address, size);
+    m_logger.trace("Load {0} bytes at {1:04X}", size, address);
+}
+
+void MemoryBus::set_joypad(uint8_t buttons)
+{
+    m_joypad = buttons;
+}
+
+// Raw view of the address space, without the side effects a read through the
+// bus may have on memory mapped registers.
+const MemoryImage& MemoryBus::get_image() const
+{
+    return m_ram;
+}
+
+void MemoryBus::save_state(MemoryImage& image) const
+{
+    image = m_ram;
+}
+
+// Hands out which parts of VRAM were written since the last call, and starts
+// over. Meant for a single consumer, which is the PPU.
+VramBitmap MemoryBus::take_dirty_vram()
+{
+    VramBitmap dirty = m_dirty_vram;
+    m_dirty_vram.fill(0);
+    return dirty;
+}
+
+// Same for OAM, one bit per object.
+uint64_t MemoryBus::take_dirty_oam()
+{
+    uint64_t dirty = m_dirty_oam;
+    m_dirty_oam = 0;
+    return dirty;
+}
+
+// Logs video writes from now on, or stops at a null log. Restored state is
+// never logged, readers of the log start over from a copy of memory instead.
+void MemoryBus::set_video_log(VideoLog* log)
+{
+    m_video_log = log;
+}
+
+// Routes writes to sound registers and wave RAM through the APU from now on,
+// or stores them as they are at a null APU.
+void MemoryBus::attach_apu(Apu* apu)
+{
+    m_apu = apu;
+}
+
+// Same for the timer, whose registers are also read through it.
+void MemoryBus::attach_timer(Timer* timer)
+{
+    m_timer = timer;
+}
+
+// Same for the serial port, which decides when transfers complete.
+void MemoryBus::attach_serial(Serial* serial)
+{
+    m_serial = serial;
+}
+
+void MemoryBus::load_state(const MemoryImage& image)
+{
+    m_ram = image;
+    m_dirty_vram.fill(~uint64_t(0));
+    m_dirty_oam = ALL_OBJECTS;
+}
+
+// Marks every block of VRAM that overlaps the given range.
+void MemoryBus::mark_vram(size_t address, size_t size)
+{
+    size_t begin = std::max<size_t>(address, VRAM);
+    size_t end = std::min(address + size, VRAM + VRAM_SIZE);
+    if (begin >= end)
+        return;
+    size_t last = (end - 1 - VRAM) / VRAM_BLOCK;
+    for (size_t block = (begin - VRAM) / VRAM_BLOCK; block <= last; ++block)
+        m_dirty_vram[block / 64] |= uint64_t(1) << (block % 64);
+}
+
+// Appends the current contents of every byte of the range the PPU draws from.
+void MemoryBus::log_video(size_t address, size_t size)
+{
+    constexpr std::array<std::pair<size_t, size_t>, 3> ranges = {
+        { { VRAM, VRAM + VRAM_SIZE }, { OAM, OAM + OAM_SIZE }, { LCDC, WX + 1 } }
+    };
+    VideoLog& log = *m_video_log;
+    for (const auto& [first, last] : ranges) {
+        size_t begin = std::max(address, first);
+        size_t end = std::min(address + size, last);
+        for (size_t i = begin; i < end; ++i)
+            log.writes.push_back({ static_cast<uint16_t>(i), m_ram[i], log.line, log.dot });
+    }
+}
+
+// Buttons are active low, and only the selected group(s) show up in the lower
+// nibble of P1. Bits 4 and 5 select the d-pad and action buttons respectively.
+uint8_t MemoryBus::read_joypad() const
+{
+    uint8_t select = m_ram[JOYP] & 0x30;
+    uint8_t pressed = 0x00;
+    if ((select & 0x10) == 0)
+        pressed |= m_joypad & 0x0F;
+    if ((select & 0x20) == 0)
+        pressed |= static_cast<uint8_t>(m_joypad >> 4);
+    return static_cast<uint8_t>(0xC0 | select | (~pressed & 0x0F));
+}
 } // namespace cbgb
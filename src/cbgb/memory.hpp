@@ -48,13 +48,74 @@
 #define CBGB_MEMORY_HPP
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 
 namespace cbgb {
+class Apu;
+class Serial;
+class Timer;
+
+/// @brief Joypad button bits.
+///
+/// Lower nibble holds the directional pad, upper nibble holds the action
+/// buttons. A set bit means the button is held down.
+enum JoypadButton : uint8_t {
+    JOYPAD_RIGHT = 1 << 0,
+    JOYPAD_LEFT = 1 << 1,
+    JOYPAD_UP = 1 << 2,
+    JOYPAD_DOWN = 1 << 3,
+    JOYPAD_A = 1 << 4,
+    JOYPAD_B = 1 << 5,
+    JOYPAD_SELECT = 1 << 6,
+    JOYPAD_START = 1 << 7,
+};
+
+/// @brief Interrupt flag register, peripherals raise their requests here.
+inline constexpr uint16_t IF = 0xFF0F;
+
+/// @brief Interrupt request bits of #IF.
+enum Interrupt : uint8_t {
+    INTERRUPT_VBLANK = 1 << 0,
+    INTERRUPT_LCD = 1 << 1,
+    INTERRUPT_TIMER = 1 << 2,
+    INTERRUPT_SERIAL = 1 << 3,
+    INTERRUPT_JOYPAD = 1 << 4,
+};
+
+/// @brief Size of a host cache line, which hot machine state is aligned to.
+inline constexpr size_t CACHE_LINE_SIZE = 64;
+
+/// @brief Raw contents of the entire 16-bit address space.
+using MemoryImage = std::array<uint8_t, std::numeric_limits<uint16_t>::max() + 1>;
+
+/// @brief One bit per 16 bytes of VRAM, set when any of them is written.
+///
+/// 16 bytes is exactly one tile in tile data, and half a row of a tile map.
+using VramBitmap = std::array<uint64_t, 8>;
+
+/// @brief Write to VRAM, OAM or an LCD register, stamped with the line and dot
+/// the PPU was on when it happened.
+struct VideoWrite {
+    uint16_t address;
+    uint8_t value;
+    uint8_t line;
+    uint16_t dot;
+};
+
+/// @brief Video writes in the order they happened, for a renderer that runs
+/// behind the CPU. The PPU keeps the stamp for new writes up to date.
+struct VideoLog {
+    std::vector<VideoWrite> writes;
+    uint8_t line;
+    uint16_t dot;
+};
+
 /// @brief Shared physical system memory.
 ///
 /// This type emulates the behaviour of the GameBoy memory bus, and is meant
@@ -62,13 +123,37 @@ namespace cbgb {
 /// SoC.
 class MemoryBus final {
 public:
-    explicit MemoryBus(std::shared_ptr<spdlog::logger> logger);
+    explicit MemoryBus(spdlog::logger& logger);
     uint8_t read(uint16_t address);
     void write(uint16_t address, uint8_t value);
+    void store(uint16_t address, uint8_t value);
+    void request_interrupt(uint8_t interrupt);
+    void load(uint16_t address, const uint8_t* data, size_t size);
+    void set_joypad(uint8_t buttons);
+    const MemoryImage& get_image() const;
+    VramBitmap take_dirty_vram();
+    uint64_t take_dirty_oam();
+    void set_video_log(VideoLog* log);
+    void attach_apu(Apu* apu);
+    void attach_timer(Timer* timer);
+    void attach_serial(Serial* serial);
+    void save_state(MemoryImage& image) const;
+    void load_state(const MemoryImage& image);
 
 private:
-    std::shared_ptr<spdlog::logger> m_logger;
-    std::array<uint8_t, std::numeric_limits<uint16_t>::max()> m_ram;
+    uint8_t read_joypad() const;
+    void mark_vram(size_t address, size_t size);
+    void log_video(size_t address, size_t size);
+
+    spdlog::logger& m_logger;
+    alignas(CACHE_LINE_SIZE) MemoryImage m_ram;
+    VramBitmap m_dirty_vram;
+    uint64_t m_dirty_oam;
+    VideoLog* m_video_log;
+    Apu* m_apu;
+    Timer* m_timer;
+    Serial* m_serial;
+    uint8_t m_joypad;
 };
 
 /// @brief Hardware register.
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+#include <fmt/format.h>
+
+#include "cbgb/pacing.hpp"
+
+namespace cbgb {
+// Most schedulers wake a sleeping thread within a millisecond or two. The
+// margin starts out there, and never spins for less than a tenth of that, or
+// for more than a quarter of a 60 Hz frame.
+constexpr std::chrono::nanoseconds INITIAL_MARGIN = std::chrono::microseconds(2000);
+constexpr std::chrono::nanoseconds MIN_MARGIN = std::chrono::microseconds(200);
+constexpr std::chrono::nanoseconds MAX_MARGIN = std::chrono::microseconds(4000);
+
+FramePacer::FramePacer(std::chrono::nanoseconds period)
+    : m_period(period)
+    , m_margin(INITIAL_MARGIN)
+    , m_next(Clock::now())
+    , m_speed(1.0)
+{
+    if (period.count() <= 0)
+        throw std::invalid_argument("Frame period is not positive");
+}
+
+// Waits for the end of the current frame. The margin jumps up to half again
+// the latest oversleep right away, but only comes down by a sixteenth of
+// itself per frame, so a single quick wakeup does not make the next late one
+// miss its deadline.
+void FramePacer::wait()
+{
+    if (m_speed <= 0.0) {
+        m_next = Clock::now();
+        return;
+    }
+
+    auto period = std::chrono::duration_cast<std::chrono::nanoseconds>(m_period / m_speed);
+    m_next += period;
+    Clock::time_point now = Clock::now();
+    if (now - m_next > period * MAX_LAG_FRAMES) {
+        m_next = now;
+        return;
+    }
+
+    Clock::time_point wake = m_next - m_margin;
+    if (now < wake) {
+        std::this_thread::sleep_until(wake);
+        auto late = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - wake);
+        auto margin = std::max(late + late / 2, m_margin - m_margin / 16);
+        m_margin = std::clamp(margin, MIN_MARGIN, MAX_MARGIN);
+    }
+    while (Clock::now() < m_next)
+        std::this_thread::yield();
+}
+
+// Starts the next frame from the present.
+void FramePacer::reset()
+{
+    m_next = Clock::now();
+}
+
+// Multiple of the normal rate, or zero to run as fast as the host can.
+void FramePacer::set_speed(double speed)
+{
+    if (speed < 0.0)
+        throw std::invalid_argument(fmt::format("Pacing speed {} is negative", speed));
+    m_speed = speed;
+    reset();
+}
+
+double FramePacer::get_speed() const
+{
+    return m_speed;
+}
+
+// How long before a deadline the pacer currently wakes up to spin.
+std::chrono::nanoseconds FramePacer::get_margin() const
+{
+    return m_margin;
+}
+
+SpeedMeter::SpeedMeter(std::chrono::nanoseconds interval)
+    : m_interval(interval)
+    , m_start()
+    , m_frames(0)
+    , m_mcycles(0)
+    , m_instructions(0)
+    , m_started(false)
+    , m_speed()
+{
+}
+
+// Counters are running totals, as kept by the machine. Returns true whenever
+// the interval is up, and the speed has a new reading.
+bool SpeedMeter::add_frame(Clock::time_point time, uint64_t mcycles, uint64_t instructions)
+{
+    if (!m_started) {
+        m_start = time;
+        m_frames = 0;
+        m_mcycles = mcycles;
+        m_instructions = instructions;
+        m_started = true;
+        return false;
+    }
+
+    ++m_frames;
+    double seconds = std::chrono::duration<double>(time - m_start).count();
+    if (time - m_start < m_interval || seconds <= 0.0)
+        return false;
+
+    double emulated = static_cast<double>(mcycles - m_mcycles) / MCYCLE_RATE;
+    m_speed.percent = emulated / seconds * 100.0;
+    m_speed.frames_per_second = static_cast<double>(m_frames) / seconds;
+    m_speed.mips = static_cast<double>(instructions - m_instructions) / seconds / 1e6;
+    m_start = time;
+    m_frames = 0;
+    m_mcycles = mcycles;
+    m_instructions = instructions;
+    return true;
+}
+
+// Starts measuring over with the next frame, keeping the last reading.
+void SpeedMeter::reset()
+{
+    m_started = false;
+}
+
+const EmulationSpeed& SpeedMeter::get_speed() const
+{
+    return m_speed;
+}
+} // namespace cbgb
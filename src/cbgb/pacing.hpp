@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Frame pacing and speed measurement.
+//!
+//! Sleeping alone cannot hit a deadline exactly, since the scheduler wakes a
+//! thread up whenever it gets around to it, often a millisecond or more late.
+//! Spinning alone hits it to the microsecond, but burns a core the whole time.
+//! The pacer does both, sleeping until shortly before the deadline, and
+//! spinning for the rest. How early it wakes up follows how late sleeps have
+//! come back lately, so that the spin stays short on hosts with a precise
+//! scheduler, and still makes it on hosts without.
+//!
+//! The speed meter compares emulated time against time on the host, which is
+//! what tells how much headroom a host has left when running uncapped.
+
+#ifndef CBGB_PACING_HPP
+#define CBGB_PACING_HPP
+
+#include <chrono>
+#include <cstdint>
+
+namespace cbgb {
+/// @brief Rate of the M-cycle clock, a quarter of the 4 MiHz dot clock.
+inline constexpr double MCYCLE_RATE = 1048576.0;
+
+/// @brief Frames pacing may fall behind, after a debugger break or a suspended
+/// laptop, before it starts over from the present instead of racing to catch up.
+inline constexpr int MAX_LAG_FRAMES = 4;
+
+/// @brief Hybrid sleep and spin frame limiter.
+///
+/// Runs at a multiple of the given frame period, or not at all at a speed of
+/// zero. Falling more than #MAX_LAG_FRAMES behind starts over from the present.
+class FramePacer final {
+public:
+    explicit FramePacer(std::chrono::nanoseconds period);
+    void wait();
+    void reset();
+    void set_speed(double speed);
+    double get_speed() const;
+    std::chrono::nanoseconds get_margin() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::chrono::nanoseconds m_period;
+    std::chrono::nanoseconds m_margin;
+    Clock::time_point m_next;
+    double m_speed;
+};
+
+/// @brief Emulation speed over the last measured interval.
+struct EmulationSpeed {
+    /// Emulated time per host time, 100 at full speed.
+    double percent;
+    double frames_per_second;
+    /// Millions of SM83 instructions per host second.
+    double mips;
+};
+
+/// @brief Measures emulation speed from running totals, one frame at a time.
+///
+/// Takes the time of every frame from the caller, which keeps it from ever
+/// reading the clock more often than it has to.
+class SpeedMeter final {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit SpeedMeter(std::chrono::nanoseconds interval = std::chrono::milliseconds(500));
+    bool add_frame(Clock::time_point time, uint64_t mcycles, uint64_t instructions);
+    void reset();
+    const EmulationSpeed& get_speed() const;
+
+private:
+    std::chrono::nanoseconds m_interval;
+    Clock::time_point m_start;
+    uint64_t m_frames;
+    uint64_t m_mcycles;
+    uint64_t m_instructions;
+    bool m_started;
+    EmulationSpeed m_speed;
+};
+} // namespace cbgb
+
+#endif // CBGB_PACING_HPP
@@ -0,0 +1,837 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <spdlog/logger.h>
+
+#include "cbgb/layer_cache.hpp"
+#include "cbgb/memory.hpp"
+#include "cbgb/ppu.hpp"
+#include "cbgb/render_thread.hpp"
+#include "cbgb/tile_cache.hpp"
+#include "cbgb/trace.hpp"
+#include "cbgb/video.hpp"
+
+namespace cbgb {
+constexpr unsigned int OAM_SCAN_DOTS = 80;
+constexpr unsigned int DRAWING_DOTS = 172;
+constexpr unsigned int HBLANK_DOT = OAM_SCAN_DOTS + DRAWING_DOTS;
+constexpr unsigned int OBJECT_FETCH_DOTS = 6;
+
+// LCDC bits.
+constexpr uint8_t BG_ENABLE = 1 << 0;
+constexpr uint8_t OBJ_ENABLE = 1 << 1;
+constexpr uint8_t OBJ_TALL = 1 << 2;
+constexpr uint8_t BG_MAP_HIGH = 1 << 3;
+constexpr uint8_t TILE_DATA_LOW = 1 << 4;
+constexpr uint8_t WINDOW_ENABLE = 1 << 5;
+constexpr uint8_t WINDOW_MAP_HIGH = 1 << 6;
+constexpr uint8_t LCD_ENABLE = 1 << 7;
+
+// STAT interrupt source bits.
+constexpr uint8_t STAT_HBLANK = 1 << 3;
+constexpr uint8_t STAT_VBLANK = 1 << 4;
+constexpr uint8_t STAT_OAM_SCAN = 1 << 5;
+constexpr uint8_t STAT_LYC = 1 << 6;
+
+// Object attribute bits.
+constexpr uint8_t OBJ_PALETTE = 1 << 4;
+constexpr uint8_t OBJ_FLIP_X = 1 << 5;
+constexpr uint8_t OBJ_FLIP_Y = 1 << 6;
+constexpr uint8_t OBJ_BEHIND = 1 << 7;
+
+// Both tile maps, relative to the start of VRAM.
+constexpr size_t MAP_LOW = 0x1800;
+constexpr size_t MAP_HIGH = 0x1C00;
+
+// Steps of the pixel FIFO's background fetcher, two dots each except for the
+// push, which is retried every dot until the FIFO has room.
+enum FetchStep : uint8_t {
+    FETCH_TILE,
+    FETCH_LOW,
+    FETCH_HIGH,
+    FETCH_PUSH,
+};
+
+static void start_fifo_line(
+    PixelFifoState& fifo,
+    const MemoryImage& memory,
+    const LineObjects& objects,
+    unsigned int line,
+    unsigned int window_line
+);
+static bool tick_fifo(
+    PixelFifoState& fifo, const MemoryImage& memory, const TileCache& tiles, uint8_t* shades
+);
+static bool shows_window(const PpuRegisters& registers, unsigned int line);
+
+Ppu::Ppu(spdlog::logger& logger, MemoryBus& bus)
+    : m_logger(logger)
+    , m_bus(bus)
+    , m_downscaler(nullptr)
+    , m_frame()
+    , m_tiles()
+    , m_layers()
+    , m_objects()
+    , m_fifo()
+    , m_thread()
+    , m_accuracy(PpuAccuracy::SCANLINE)
+    , m_line(0)
+    , m_dot(0)
+    , m_window_line(0)
+    , m_mode(PPU_OAM_SCAN)
+    , m_line_lcdc(0)
+    , m_stat_line(false)
+    , m_enabled(true)
+    , m_fifo_line(false)
+    , m_raster(false)
+    , m_layered(true)
+    , m_skip_render(false)
+{
+    // What the DMG boot ROM leaves behind.
+    m_bus.store(LCDC, 0x91);
+    m_bus.store(BGP, 0xFC);
+    m_bus.store(DMA, 0xFF);
+    m_bus.store(LY, 0);
+    update_stat();
+
+    // Decode everything once, the bus may already have handed its record of
+    // VRAM writes to someone else.
+    VramBitmap all = {};
+    all.fill(~uint64_t(0));
+    m_tiles.update(&m_bus.get_image()[VRAM], all);
+    m_logger.trace("Construct new PPU");
+}
+
+Ppu::~Ppu()
+{
+    set_render_thread(false);
+}
+
+// Runs up to every point of the current line where something happens, in
+// turn: the start of mode 3, the start of mode 0 where the line is drawn, and
+// the start of the next line. Lines drawn by the pixel FIFO go through mode 3
+// one dot at a time instead. Returns true if vertical blank was entered.
+bool Ppu::advance(unsigned int mcycles)
+{
+    bool enabled = (m_bus.get_image()[LCDC] & LCD_ENABLE) != 0;
+    if (enabled != m_enabled) {
+        m_enabled = enabled;
+        m_line = 0;
+        m_dot = 0;
+        m_window_line = 0;
+        m_bus.store(LY, 0);
+        if (enabled) {
+            set_mode(PPU_OAM_SCAN);
+        }
+        else {
+            m_frame.fill(0);
+            if (m_downscaler != nullptr)
+                m_downscaler->scale_frame(m_frame.data());
+            if (m_thread != nullptr)
+                m_thread->clear();
+            set_mode(PPU_HBLANK);
+        }
+    }
+
+    bool frame = false;
+    unsigned int dots = mcycles * 4;
+    while (dots > 0) {
+        bool visible = m_enabled && m_line < SCREEN_HEIGHT;
+        unsigned int target = DOTS_PER_LINE;
+        if (visible && m_dot < OAM_SCAN_DOTS)
+            target = OAM_SCAN_DOTS;
+        else if (visible && m_mode == PPU_DRAWING)
+            target = m_fifo_line ? m_dot + 1 : HBLANK_DOT;
+
+        unsigned int step = std::min(dots, target - m_dot);
+        m_dot += step;
+        dots -= step;
+        if (m_dot == DOTS_PER_LINE) {
+            frame = next_line() || frame;
+        }
+        else if (visible && m_dot == OAM_SCAN_DOTS) {
+            m_fifo_line = m_accuracy == PpuAccuracy::PIXEL_FIFO;
+            if (m_fifo_line) {
+                sync_caches();
+                const MemoryImage& memory = m_bus.get_image();
+                const LineObjects& objects = m_objects.get_line(&memory[OAM], m_line);
+                start_fifo_line(m_fifo, memory, objects, m_line, m_window_line);
+            }
+            set_mode(PPU_DRAWING);
+        }
+        else if (visible && m_mode == PPU_DRAWING && m_fifo_line) {
+            uint8_t* shades = &m_frame[static_cast<size_t>(m_line) * SCREEN_WIDTH];
+            if (tick_fifo(m_fifo, m_bus.get_image(), m_tiles, shades)) {
+                finish_line(m_fifo.window);
+                set_mode(PPU_HBLANK);
+            }
+        }
+        else if (visible && m_mode == PPU_DRAWING && m_dot == HBLANK_DOT) {
+            draw_line();
+            set_mode(PPU_HBLANK);
+        }
+    }
+    if (m_thread != nullptr)
+        m_thread->set_time(m_line, m_dot);
+    return frame;
+}
+
+void Ppu::set_accuracy(PpuAccuracy accuracy)
+{
+    m_accuracy = accuracy;
+}
+
+// M-cycles from now until #advance completes a frame, as long as nothing but
+// time goes by. Turning the LCD on or off restarts the frame at the next
+// advance, so a pending switch counts from the top already.
+unsigned int Ppu::get_mcycles_to_frame() const
+{
+    bool enabled = (m_bus.get_image()[LCDC] & LCD_ENABLE) != 0;
+    unsigned int line = enabled == m_enabled ? m_line : 0;
+    unsigned int dot = enabled == m_enabled ? m_dot : 0;
+    unsigned int lines = (SCREEN_HEIGHT - 1 + LINES_PER_FRAME - line) % LINES_PER_FRAME;
+    return (lines * DOTS_PER_LINE + DOTS_PER_LINE - dot) / 4;
+}
+
+PpuAccuracy Ppu::get_accuracy() const
+{
+    return m_accuracy;
+}
+
+void Ppu::set_downscaler(Downscaler* downscaler)
+{
+    m_downscaler = downscaler;
+}
+
+void Ppu::set_render_skip(bool skip)
+{
+    m_skip_render = skip;
+}
+
+bool Ppu::get_render_skip() const
+{
+    return m_skip_render;
+}
+
+// Starting takes a copy of video memory for the worker. Stopping waits for it
+// to draw what is left, so no line of the current frame goes missing.
+void Ppu::set_render_thread(bool enabled)
+{
+    if (enabled == (m_thread != nullptr))
+        return;
+
+    if (enabled) {
+        m_thread = std::make_unique<RenderThread>();
+        m_thread->reset(m_bus.get_image(), m_frame);
+        m_thread->set_time(m_line, m_dot);
+        m_bus.set_video_log(&m_thread->get_log());
+    }
+    else {
+        m_thread->finish(m_frame);
+        m_bus.set_video_log(nullptr);
+        m_thread.reset();
+    }
+}
+
+bool Ppu::get_render_thread() const
+{
+    return m_thread != nullptr;
+}
+
+const FrameBuffer& Ppu::get_frame() const
+{
+    return m_frame;
+}
+
+// Tiles as of the last line drawn, for debug views.
+const TileCache& Ppu::get_tiles() const
+{
+    return m_tiles;
+}
+
+void Ppu::save_state(PpuSnapshot& snapshot) const
+{
+    snapshot.frame = m_frame;
+    snapshot.fifo = m_fifo;
+    snapshot.line = m_line;
+    snapshot.dot = m_dot;
+    snapshot.window_line = m_window_line;
+    snapshot.mode = m_mode;
+    snapshot.stat_line = m_stat_line;
+    snapshot.enabled = m_enabled;
+    snapshot.fifo_line = m_fifo_line;
+}
+
+void Ppu::load_state(const PpuSnapshot& snapshot)
+{
+    m_frame = snapshot.frame;
+    m_fifo = snapshot.fifo;
+    m_line = snapshot.line;
+    m_dot = snapshot.dot;
+    m_window_line = snapshot.window_line;
+    m_mode = snapshot.mode;
+    m_stat_line = snapshot.stat_line;
+    m_enabled = snapshot.enabled;
+    m_fifo_line = snapshot.fifo_line;
+    if (m_thread != nullptr) {
+        m_thread->reset(m_bus.get_image(), m_frame);
+        m_thread->set_time(m_line, m_dot);
+    }
+}
+
+// With the LCD off, lines are still counted to keep frames coming, but LY
+// stays at zero and nothing gets drawn.
+bool Ppu::next_line()
+{
+    m_dot = 0;
+    if (++m_line == LINES_PER_FRAME) {
+        m_line = 0;
+        m_window_line = 0;
+    }
+    if (!m_enabled) {
+        if (m_line != SCREEN_HEIGHT)
+            return false;
+        present_frame();
+        return true;
+    }
+
+    m_bus.store(LY, static_cast<uint8_t>(m_line));
+    if (m_line == SCREEN_HEIGHT) {
+        present_frame();
+        m_layered = !m_raster;
+        m_raster = false;
+        m_bus.request_interrupt(INTERRUPT_VBLANK);
+        set_mode(PPU_VBLANK);
+        return true;
+    }
+    if (m_line < SCREEN_HEIGHT)
+        set_mode(PPU_OAM_SCAN);
+    else
+        update_stat();
+    return false;
+}
+
+void Ppu::set_mode(uint8_t mode)
+{
+    m_mode = mode;
+    update_stat();
+}
+
+// The STAT interrupt fires on the rising edge of all enabled sources OR'd
+// together, so a source going high while another one already is stays silent.
+void Ppu::update_stat()
+{
+    const MemoryImage& memory = m_bus.get_image();
+    uint8_t stat = memory[STAT];
+    bool coincidence = m_enabled && memory[LY] == memory[LYC];
+    m_bus.store(
+        STAT, static_cast<uint8_t>(0x80 | (stat & 0x78) | (coincidence ? 0x04 : 0x00) | m_mode)
+    );
+
+    bool line = m_enabled
+        && ((coincidence && (stat & STAT_LYC) != 0)
+            || (m_mode == PPU_HBLANK && (stat & STAT_HBLANK) != 0)
+            || (m_mode == PPU_VBLANK && (stat & STAT_VBLANK) != 0)
+            || (m_mode == PPU_OAM_SCAN && (stat & STAT_OAM_SCAN) != 0));
+    if (line && !m_stat_line)
+        m_bus.request_interrupt(INTERRUPT_LCD);
+    m_stat_line = line;
+}
+
+// Caches are derived from VRAM and OAM alone, so snapshots leave them out.
+// Restoring memory marks all of both as written, which has them rebuilt here.
+void Ppu::sync_caches()
+{
+    const MemoryImage& memory = m_bus.get_image();
+    VramBitmap dirty = m_bus.take_dirty_vram();
+    m_tiles.update(&memory[VRAM], dirty);
+    m_layers.invalidate(&memory[VRAM], dirty);
+    m_objects.update(&memory[OAM], m_bus.take_dirty_oam(), memory[LCDC]);
+}
+
+// Layer planes are skipped once tile addressing changes between two lines of
+// a frame, caught here after the fact, and for all of the following frame.
+// Layered or not, lines come out the same.
+void Ppu::draw_line()
+{
+    const MemoryImage& memory = m_bus.get_image();
+    PpuRegisters registers = read_ppu_registers(memory);
+    if (m_line != 0 && ((registers.lcdc ^ m_line_lcdc) & TILE_DATA_LOW) != 0)
+        m_raster = true;
+    m_line_lcdc = registers.lcdc;
+
+    // Skipped lines leave caches to catch up on the next drawn one, but still
+    // count window lines so that the next drawn frame picks up where it should.
+    // Lines for the render thread only need counting here as well.
+    if (m_skip_render || m_thread != nullptr) {
+        if (!m_skip_render)
+            m_thread->draw_line(m_window_line);
+        if (shows_window(registers, m_line))
+            ++m_window_line;
+        return;
+    }
+
+    CBGB_TRACE_SCOPE("PPU line");
+    sync_caches();
+    uint8_t* shades = &m_frame[static_cast<size_t>(m_line) * SCREEN_WIDTH];
+
+    LayerCache* layers = m_layered && !m_raster ? &m_layers : nullptr;
+    const LineObjects& objects = m_objects.get_line(&memory[OAM], m_line);
+    finish_line(render_scanline(
+        &memory[VRAM],
+        m_tiles,
+        &memory[OAM],
+        registers,
+        m_line,
+        m_window_line,
+        shades,
+        layers,
+        &objects
+    ));
+}
+
+void Ppu::finish_line(bool window)
+{
+    if (window)
+        ++m_window_line;
+    if (m_downscaler != nullptr && m_thread == nullptr)
+        m_downscaler->push_line(m_line, &m_frame[static_cast<size_t>(m_line) * SCREEN_WIDTH]);
+}
+
+// Collects what the render thread drew at the start of vertical blank, and
+// catches up on caches for debug views and a switch back to drawing here.
+void Ppu::present_frame()
+{
+    if (m_thread == nullptr)
+        return;
+    m_thread->finish(m_frame);
+    sync_caches();
+    if (m_downscaler != nullptr)
+        m_downscaler->scale_frame(m_frame.data());
+}
+
+PpuRegisters read_ppu_registers(const MemoryImage& memory)
+{
+    return PpuRegisters { memory[LCDC], memory[SCY],  memory[SCX], memory[BGP],
+                          memory[OBP0], memory[OBP1], memory[WY],  memory[WX] };
+}
+
+// Whether the window covers part of a line, on DMG only with the background.
+static bool shows_window(const PpuRegisters& registers, unsigned int line)
+{
+    uint8_t lcdc = registers.lcdc;
+    return (lcdc & BG_ENABLE) != 0 && (lcdc & WINDOW_ENABLE) != 0 && line >= registers.wy
+        && registers.wx < 167;
+}
+
+// Copies one row of `count` consecutive tiles of a tile map out of the tile
+// cache, wrapping around after 32 tiles like the hardware does.
+static void read_map_row(
+    const uint8_t* vram,
+    const TileCache& tiles,
+    uint8_t lcdc,
+    size_t map,
+    unsigned int y,
+    unsigned int first,
+    size_t count,
+    uint8_t* colors
+)
+{
+    size_t row = map + static_cast<size_t>(y / 8) * 32;
+    bool unsigned_index = (lcdc & TILE_DATA_LOW) != 0;
+    for (size_t tile = 0; tile < count; ++tile) {
+        size_t index = tile_index(vram[row + ((first + tile) & 31)], unsigned_index);
+        std::copy_n(tiles.get_row(index, y % 8), 8, colors + tile * 8);
+    }
+}
+
+// Objects with the smaller X win, which a stable sort of a list in OAM order
+// turns into the order of the list.
+static void sort_by_x(const uint8_t* oam, LineObjects& objects)
+{
+    auto by_x = [oam](uint8_t lhs, uint8_t rhs) { return oam[lhs * 4 + 1] < oam[rhs * 4 + 1]; };
+    auto end = objects.indices.begin() + objects.count;
+    std::stable_sort(objects.indices.begin(), end, by_x);
+}
+
+ObjectLists::ObjectLists()
+    : m_masks()
+    , m_lines()
+    , m_stale()
+    , m_tops()
+    , m_height(0)
+{
+}
+
+// Object height is not known until the first update, which thus starts from
+// scratch, as does any change of it.
+void ObjectLists::update(const uint8_t* oam, uint64_t dirty, uint8_t lcdc)
+{
+    int height = (lcdc & OBJ_TALL) != 0 ? 16 : 8;
+    if (height != m_height) {
+        m_height = height;
+        m_masks.fill(0);
+        m_stale.fill(~uint64_t(0));
+        for (size_t index = 0; index < OBJECT_COUNT; ++index) {
+            m_tops[index] = oam[index * 4];
+            mark(index, true);
+        }
+        return;
+    }
+
+    for (size_t index = 0; dirty != 0; ++index, dirty >>= 1) {
+        if ((dirty & 1) == 0)
+            continue;
+        mark(index, false);
+        m_tops[index] = oam[index * 4];
+        mark(index, true);
+    }
+}
+
+const LineObjects& ObjectLists::get_line(const uint8_t* oam, unsigned int line)
+{
+    LineObjects& objects = m_lines[line];
+    uint64_t bit = uint64_t(1) << (line % 64);
+    if ((m_stale[line / 64] & bit) == 0)
+        return objects;
+
+    m_stale[line / 64] &= ~bit;
+    objects.count = 0;
+    uint64_t mask = m_masks[line];
+    for (size_t index = 0; mask != 0 && objects.count < OBJECTS_PER_LINE; ++index, mask >>= 1) {
+        if ((mask & 1) != 0)
+            objects.indices[objects.count++] = static_cast<uint8_t>(index);
+    }
+    sort_by_x(oam, objects);
+    return objects;
+}
+
+// Adds or removes an object from the lines it covers, as of the Y it was
+// last seen at, and marks those lines for a rebuild either way.
+void ObjectLists::mark(size_t index, bool covering)
+{
+    int top = m_tops[index] - 16;
+    int first = std::max(top, 0);
+    int last = std::min(top + m_height, static_cast<int>(SCREEN_HEIGHT));
+    uint64_t bit = uint64_t(1) << index;
+    for (int line = first; line < last; ++line) {
+        auto row = static_cast<size_t>(line);
+        if (covering)
+            m_masks[row] |= bit;
+        else
+            m_masks[row] &= ~bit;
+        m_stale[row / 64] |= uint64_t(1) << (row % 64);
+    }
+}
+
+// Mode 2 picks the first 10 objects in OAM order that cover the line. This
+// searches all of OAM, for callers that keep no lists.
+LineObjects select_objects(const uint8_t* oam, uint8_t lcdc, unsigned int line)
+{
+    int height = (lcdc & OBJ_TALL) != 0 ? 16 : 8;
+    LineObjects objects = {};
+    for (size_t index = 0; index < OBJECT_COUNT && objects.count < OBJECTS_PER_LINE; ++index) {
+        int top = oam[index * 4] - 16;
+        if (static_cast<int>(line) >= top && static_cast<int>(line) < top + height)
+            objects.indices[objects.count++] = static_cast<uint8_t>(index);
+    }
+    sort_by_x(oam, objects);
+    return objects;
+}
+
+// Returns the row of an object that falls on the line, flipped vertically if
+// need be, but not horizontally. Tall objects span two consecutive tiles.
+static const uint8_t* read_object(
+    const TileCache& tiles, const uint8_t* object, uint8_t lcdc, unsigned int line
+)
+{
+    int height = (lcdc & OBJ_TALL) != 0 ? 16 : 8;
+    int row = static_cast<int>(line) - (object[0] - 16);
+    if ((object[3] & OBJ_FLIP_Y) != 0)
+        row = height - 1 - row;
+    uint8_t tile = height == 16 ? static_cast<uint8_t>(object[2] & 0xFE) : object[2];
+    auto offset = static_cast<unsigned int>(row);
+    return tiles.get_row(tile_index(tile, true) + offset / 8, offset % 8);
+}
+
+// Objects hidden behind the background still win over objects below them.
+static void draw_objects(
+    const TileCache& tiles,
+    const uint8_t* oam,
+    const PpuRegisters& registers,
+    unsigned int line,
+    const LineObjects& objects,
+    const uint8_t* colors,
+    uint8_t* shades
+)
+{
+    std::array<bool, SCREEN_WIDTH> claimed = {};
+    for (size_t i = 0; i < objects.count; ++i) {
+        const uint8_t* object = oam + objects.indices[i] * 4;
+        uint8_t attributes = object[3];
+        const uint8_t* pixels = read_object(tiles, object, registers.lcdc, line);
+        uint8_t palette = (attributes & OBJ_PALETTE) != 0 ? registers.obp1 : registers.obp0;
+        for (int pixel = 0; pixel < 8; ++pixel) {
+            int x = object[1] - 8 + ((attributes & OBJ_FLIP_X) != 0 ? 7 - pixel : pixel);
+            uint8_t color = pixels[static_cast<size_t>(pixel)];
+            if (x < 0 || x >= static_cast<int>(SCREEN_WIDTH) || color == 0)
+                continue;
+            auto column = static_cast<size_t>(x);
+            if (claimed[column])
+                continue;
+            claimed[column] = true;
+            if ((attributes & OBJ_BEHIND) == 0 || colors[column] == 0)
+                shades[column] = static_cast<uint8_t>((palette >> (2 * color)) & 3);
+        }
+    }
+}
+
+// Returns whether the window was drawn, which advances its own line counter.
+bool render_scanline(
+    const uint8_t* vram,
+    const TileCache& tiles,
+    const uint8_t* oam,
+    const PpuRegisters& registers,
+    unsigned int line,
+    unsigned int window_line,
+    uint8_t* shades,
+    LayerCache* layers,
+    const LineObjects* objects
+)
+{
+    // 21 tiles cover the line at any fine scroll, or window offset.
+    std::array<uint8_t, 21 * 8> decoded = {};
+    std::array<uint8_t, SCREEN_WIDTH> colors = {};
+    uint8_t lcdc = registers.lcdc;
+    bool unsigned_index = (lcdc & TILE_DATA_LOW) != 0;
+    bool window = false;
+
+    // On DMG, clearing LCDC bit 0 blanks both background and window.
+    if ((lcdc & BG_ENABLE) != 0) {
+        unsigned int y = (line + registers.scy) & 0xFF;
+        bool high = (lcdc & BG_MAP_HIGH) != 0;
+        if (layers != nullptr) {
+            // Wraps around the right edge of the plane.
+            const uint8_t* row = layers->get_row(vram, tiles, unsigned_index, high ? 1 : 0, y);
+            size_t right = std::min<size_t>(LAYER_SIZE - registers.scx, SCREEN_WIDTH);
+            std::copy_n(row + registers.scx, right, colors.begin());
+            std::copy_n(row, SCREEN_WIDTH - right, colors.begin() + right);
+        }
+        else {
+            size_t map = high ? MAP_HIGH : MAP_LOW;
+            read_map_row(vram, tiles, lcdc, map, y, registers.scx / 8U, 21, decoded.data());
+            std::copy_n(decoded.begin() + (registers.scx % 8), SCREEN_WIDTH, colors.begin());
+        }
+
+        window = shows_window(registers, line);
+        if (window) {
+            int start = registers.wx - 7;
+            unsigned int left = start < 0 ? 0 : static_cast<unsigned int>(start);
+            unsigned int skip = static_cast<unsigned int>(static_cast<int>(left) - start);
+            unsigned int width = SCREEN_WIDTH - left;
+            bool window_high = (lcdc & WINDOW_MAP_HIGH) != 0;
+            const uint8_t* row = decoded.data();
+            if (layers != nullptr) {
+                size_t map = window_high ? 1 : 0;
+                row = layers->get_row(vram, tiles, unsigned_index, map, window_line);
+            }
+            else {
+                size_t map = window_high ? MAP_HIGH : MAP_LOW;
+                size_t count = (skip + width + 7) / 8;
+                read_map_row(vram, tiles, lcdc, map, window_line, 0, count, decoded.data());
+            }
+            std::copy_n(row + skip, width, colors.begin() + left);
+        }
+    }
+
+    apply_palette(colors.data(), registers.bgp, shades, SCREEN_WIDTH);
+    if ((lcdc & OBJ_ENABLE) != 0) {
+        LineObjects selected = {};
+        if (objects == nullptr) {
+            selected = select_objects(oam, lcdc, line);
+            objects = &selected;
+        }
+        draw_objects(tiles, oam, registers, line, *objects, colors.data(), shades);
+    }
+    return window;
+}
+
+// Mode 3 starts with fetching a tile that is thrown away, after which the
+// first SCX % 8 pixels are shifted out without being drawn.
+static void start_fifo_line(
+    PixelFifoState& fifo,
+    const MemoryImage& memory,
+    const LineObjects& objects,
+    unsigned int line,
+    unsigned int window_line
+)
+{
+    fifo = PixelFifoState {};
+    fifo.objects = objects;
+    fifo.line = line;
+    fifo.window_line = window_line;
+    fifo.discard = memory[SCX] % 8;
+    fifo.first_fetch = true;
+}
+
+// Runs the background fetcher for one dot. Scroll registers and LCDC are read
+// as the step that needs them comes up, so changes to them apply mid-line.
+static void fetch_background(PixelFifoState& fifo, const MemoryImage& memory)
+{
+    if (fifo.fetch_step != FETCH_PUSH) {
+        if (++fifo.fetch_dot < 2)
+            return;
+        fifo.fetch_dot = 0;
+
+        uint8_t lcdc = memory[LCDC];
+        unsigned int y = fifo.window ? fifo.window_line : (fifo.line + memory[SCY]) & 0xFF;
+        if (fifo.fetch_step == FETCH_TILE) {
+            size_t map = 0;
+            unsigned int column = 0;
+            if (fifo.window) {
+                map = (lcdc & WINDOW_MAP_HIGH) != 0 ? MAP_HIGH : MAP_LOW;
+                column = fifo.fetch_x & 31U;
+            }
+            else {
+                map = (lcdc & BG_MAP_HIGH) != 0 ? MAP_HIGH : MAP_LOW;
+                column = (memory[SCX] / 8U + fifo.fetch_x) & 31U;
+            }
+            fifo.tile = memory[VRAM + map + (y / 8) * 32 + column];
+        }
+        else {
+            size_t address = VRAM + tile_index(fifo.tile, (lcdc & TILE_DATA_LOW) != 0) * 16
+                + (y % 8) * 2;
+            if (fifo.fetch_step == FETCH_LOW)
+                fifo.low = memory[address];
+            else
+                fifo.high = memory[address + 1];
+        }
+        if (++fifo.fetch_step != FETCH_PUSH)
+            return;
+    }
+
+    if (fifo.background_count != 0)
+        return;
+    fifo.fetch_step = FETCH_TILE;
+    if (fifo.first_fetch) {
+        fifo.first_fetch = false;
+        return;
+    }
+    decode_tiles(&fifo.low, &fifo.high, 1, fifo.background.data());
+    fifo.background_count = 8;
+    ++fifo.fetch_x;
+}
+
+// Mixes an object into the object FIFO. Pixels already there win, which is
+// what gives objects fetched earlier, with a smaller X, priority.
+static void fetch_object(
+    PixelFifoState& fifo, const MemoryImage& memory, const TileCache& tiles, const uint8_t* object
+)
+{
+    const uint8_t* pixels = read_object(tiles, object, memory[LCDC], fifo.line);
+    bool flip = (object[3] & OBJ_FLIP_X) != 0;
+    for (int pixel = 0; pixel < 8; ++pixel) {
+        int x = object[1] - 8 + pixel;
+        uint8_t color = pixels[static_cast<size_t>(flip ? 7 - pixel : pixel)];
+        if (x < fifo.x || color == 0)
+            continue;
+        size_t slot = static_cast<size_t>(x) % 8;
+        if (fifo.object_colors[slot] != 0)
+            continue;
+        fifo.object_colors[slot] = color;
+        fifo.object_attributes[slot] = object[3];
+    }
+}
+
+// Finds the next object to fetch at the current pixel. Lists are sorted by X,
+// so that is the first one not fetched yet, if it starts here. Only objects
+// hanging off the left edge can start before the current pixel.
+static int find_object(const PixelFifoState& fifo, const MemoryImage& memory)
+{
+    for (int i = 0; i < fifo.objects.count; ++i) {
+        if ((fifo.fetched & (1U << i)) != 0)
+            continue;
+        uint8_t x = memory[OAM + fifo.objects.indices[static_cast<size_t>(i)] * 4U + 1];
+        return x <= fifo.x + 8 ? i : -1;
+    }
+    return -1;
+}
+
+// Pixels leave the FIFO before the fetcher runs, so a freshly pushed tile is
+// only drawn from the next dot on. With no window and no objects, the first
+// pixel comes out on the 13th dot, which makes for the shortest mode 3 of 172
+// dots. Returns true once all 160 pixels of the line are out.
+static bool tick_fifo(
+    PixelFifoState& fifo, const MemoryImage& memory, const TileCache& tiles, uint8_t* shades
+)
+{
+    uint8_t lcdc = memory[LCDC];
+    uint8_t wx = memory[WX];
+    if (!fifo.window && (lcdc & WINDOW_ENABLE) != 0 && fifo.line >= memory[WY] && wx < 167
+        && fifo.x + 7 >= wx) {
+        // The window restarts the fetcher, and hides what is left of the
+        // background tile. With WX below 7 its first pixels are off-screen.
+        fifo.window = true;
+        fifo.background_count = 0;
+        fifo.fetch_step = FETCH_TILE;
+        fifo.fetch_dot = 0;
+        fifo.fetch_x = 0;
+        fifo.discard = static_cast<uint8_t>(wx < 7 ? 7 - wx : 0);
+    }
+
+    if (fifo.discard == 0 && (lcdc & OBJ_ENABLE) != 0) {
+        int index = find_object(fifo, memory);
+        if (index >= 0) {
+            // Drawing stalls while the fetcher finishes its current tile,
+            // then spends 6 more dots on the object.
+            bool ready = fifo.fetch_step == FETCH_PUSH && fifo.background_count != 0;
+            if (!ready)
+                fetch_background(fifo, memory);
+            ready = fifo.fetch_step == FETCH_PUSH && fifo.background_count != 0;
+            if (ready && ++fifo.object_dots == OBJECT_FETCH_DOTS) {
+                fifo.object_dots = 0;
+                fifo.fetched = static_cast<uint16_t>(fifo.fetched | (1U << index));
+                uint8_t object = fifo.objects.indices[static_cast<size_t>(index)];
+                fetch_object(fifo, memory, tiles, &memory[OAM + object * 4U]);
+            }
+            return false;
+        }
+    }
+
+    if (fifo.background_count != 0) {
+        uint8_t color = fifo.background[8U - fifo.background_count--];
+        if (fifo.discard != 0) {
+            --fifo.discard;
+        }
+        else {
+            size_t slot = fifo.x % 8U;
+            uint8_t object = fifo.object_colors[slot];
+            uint8_t attributes = fifo.object_attributes[slot];
+            fifo.object_colors[slot] = 0;
+
+            // On DMG, clearing LCDC bit 0 blanks both background and window.
+            if ((lcdc & BG_ENABLE) == 0)
+                color = 0;
+            bool visible = object != 0 && (lcdc & OBJ_ENABLE) != 0
+                && ((attributes & OBJ_BEHIND) == 0 || color == 0);
+            if (visible) {
+                uint8_t palette = (attributes & OBJ_PALETTE) != 0 ? memory[OBP1] : memory[OBP0];
+                shades[fifo.x] = static_cast<uint8_t>((palette >> (2 * object)) & 3);
+            }
+            else {
+                shades[fifo.x] = static_cast<uint8_t>((memory[BGP] >> (2 * color)) & 3);
+            }
+            ++fifo.x;
+        }
+    }
+
+    fetch_background(fifo, memory);
+    return fifo.x == SCREEN_WIDTH;
+}
+} // namespace cbgb
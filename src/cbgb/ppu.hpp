@@ -0,0 +1,256 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief GameBoy picture processing unit.
+//!
+//! The PPU draws 144 visible lines, followed by 10 lines of vertical blank.
+//! Every line takes 456 dots, and visible lines step through OAM scan (mode
+//! 2), drawing (mode 3), and horizontal blank (mode 0) \[[1]\]. A full frame
+//! is 70224 dots, which is 17556 M-cycles.
+//!
+//! By default this PPU renders whole scanlines at once, at the end of mode 3,
+//! from the contents of VRAM, OAM and the LCD registers at that moment. Raster
+//! effects that change registers between lines show up, while changes in the
+//! middle of a line do not. Mode 3 always lasts 172 dots.
+//!
+//! The scanline renderer itself is a free function over VRAM, OAM, the decoded
+//! tile cache and a copy of the registers, so it does not care whether it is
+//! handed live memory or a snapshot of it. Given the layer cache as well, it
+//! copies the background out of fully drawn tile map planes. The PPU does so
+//! unless LCDC switches tile addressing between lines, which would have the
+//! planes redrawn over and over. Such frames, and the one after them, compose
+//! each line from the tile cache instead. Objects of every line are likewise
+//! kept in lists that follow OAM writes, rather than searched for every line.
+//!
+//! For the few games and test ROMs that write registers in the middle of a
+//! line, the PPU can instead run a pixel FIFO one dot at a time \[[2]\]. That
+//! mode reads registers as the hardware does, pixel by pixel, and stretches
+//! mode 3 for fine scrolling, the window, and objects. It is several times
+//! slower, so it is chosen per machine, or per game through the game database.
+//! The CPU still runs whole instructions between PPU updates, so a register
+//! write lands within a few dots of where it would on hardware.
+//!
+//! [1]: https://gbdev.io/pandocs/Rendering.html
+//! [2]: https://gbdev.io/pandocs/pixel_fifo.html
+
+#ifndef CBGB_PPU_HPP
+#define CBGB_PPU_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <spdlog/logger.h>
+
+#include "cbgb/layer_cache.hpp"
+#include "cbgb/memory.hpp"
+#include "cbgb/tile_cache.hpp"
+
+namespace cbgb {
+class Downscaler;
+class RenderThread;
+
+inline constexpr unsigned int SCREEN_WIDTH = 160;
+inline constexpr unsigned int SCREEN_HEIGHT = 144;
+inline constexpr unsigned int DOTS_PER_LINE = 456;
+inline constexpr unsigned int LINES_PER_FRAME = 154;
+inline constexpr unsigned int MCYCLES_PER_FRAME = DOTS_PER_LINE * LINES_PER_FRAME / 4;
+
+inline constexpr size_t OBJECT_COUNT = 40;
+inline constexpr size_t OBJECTS_PER_LINE = 10;
+
+inline constexpr uint16_t VRAM = 0x8000;
+inline constexpr uint16_t OAM = 0xFE00;
+inline constexpr uint16_t LCDC = 0xFF40;
+inline constexpr uint16_t STAT = 0xFF41;
+inline constexpr uint16_t SCY = 0xFF42;
+inline constexpr uint16_t SCX = 0xFF43;
+inline constexpr uint16_t LY = 0xFF44;
+inline constexpr uint16_t LYC = 0xFF45;
+inline constexpr uint16_t DMA = 0xFF46;
+inline constexpr uint16_t BGP = 0xFF47;
+inline constexpr uint16_t OBP0 = 0xFF48;
+inline constexpr uint16_t OBP1 = 0xFF49;
+inline constexpr uint16_t WY = 0xFF4A;
+inline constexpr uint16_t WX = 0xFF4B;
+
+/// @brief Shade indices of every visible pixel, row by row.
+using FrameBuffer = std::array<uint8_t, SCREEN_WIDTH * SCREEN_HEIGHT>;
+
+enum PpuMode : uint8_t {
+    PPU_HBLANK = 0,
+    PPU_VBLANK = 1,
+    PPU_OAM_SCAN = 2,
+    PPU_DRAWING = 3,
+};
+
+/// @brief How the PPU turns VRAM into pixels.
+enum class PpuAccuracy {
+    SCANLINE,
+    PIXEL_FIFO,
+};
+
+/// @brief LCD registers the renderer needs for one scanline.
+struct PpuRegisters {
+    uint8_t lcdc;
+    uint8_t scy;
+    uint8_t scx;
+    uint8_t bgp;
+    uint8_t obp0;
+    uint8_t obp1;
+    uint8_t wy;
+    uint8_t wx;
+};
+
+/// @brief Objects drawn on one line by OAM index, highest priority first.
+///
+/// Those are the first 10 objects in OAM order that cover the line, sorted by
+/// X, with OAM order breaking ties.
+struct LineObjects {
+    std::array<uint8_t, OBJECTS_PER_LINE> indices;
+    uint8_t count;
+};
+
+/// @brief Objects of every visible line, kept up to date with OAM writes.
+///
+/// Every line keeps a mask of the objects covering it. Updates only move the
+/// objects that were written since the last one, and mark the lines they left
+/// or entered. The list of a marked line is rebuilt from its mask the next
+/// time it is asked for, so that OAM is not searched again every line.
+class ObjectLists final {
+public:
+    ObjectLists();
+    void update(const uint8_t* oam, uint64_t dirty, uint8_t lcdc);
+    const LineObjects& get_line(const uint8_t* oam, unsigned int line);
+
+private:
+    void mark(size_t index, bool covering);
+
+    std::array<uint64_t, SCREEN_HEIGHT> m_masks;
+    std::array<LineObjects, SCREEN_HEIGHT> m_lines;
+    std::array<uint64_t, (SCREEN_HEIGHT + 63) / 64> m_stale;
+    std::array<uint8_t, OBJECT_COUNT> m_tops;
+    int m_height;
+};
+
+/// @brief Pixel FIFO and fetcher state partway through mode 3.
+///
+/// Object pixels are kept by screen column modulo 8, which lines them up with
+/// the background pixels they get mixed with.
+struct PixelFifoState {
+    LineObjects objects;
+    std::array<uint8_t, 8> background;
+    std::array<uint8_t, 8> object_colors;
+    std::array<uint8_t, 8> object_attributes;
+    unsigned int line;
+    unsigned int window_line;
+    uint16_t fetched;
+    uint8_t object_dots;
+    uint8_t background_count;
+    uint8_t fetch_step;
+    uint8_t fetch_dot;
+    uint8_t fetch_x;
+    uint8_t tile;
+    uint8_t low;
+    uint8_t high;
+    uint8_t x;
+    uint8_t discard;
+    bool first_fetch;
+    bool window;
+};
+
+/// @brief Plain copy of PPU state, frame included.
+struct PpuSnapshot {
+    FrameBuffer frame;
+    PixelFifoState fifo;
+    unsigned int line;
+    unsigned int dot;
+    unsigned int window_line;
+    uint8_t mode;
+    bool stat_line;
+    bool enabled;
+    bool fifo_line;
+};
+
+/// @brief Scanline or pixel FIFO based PPU.
+///
+/// Keeps time for the whole machine, a frame being complete once the PPU
+/// enters vertical blank. While the LCD is off the same timing keeps running,
+/// so that frames still complete at the usual rate, just blank ones.
+///
+/// A change of accuracy takes effect from the next line on.
+///
+/// With render skip on, modes, LY, interrupts and the window line counter go
+/// on as usual, but scanline lines are not composed, leaving the frame buffer
+/// as it was. Pixel FIFO lines are still drawn, as their timing depends on it.
+/// Meant for frames nobody looks at, like fast forward and run-ahead.
+///
+/// With the render thread on, scanline lines are drawn on a worker thread
+/// instead, and the frame only comes up to date at the start of vertical blank.
+class Ppu final {
+public:
+    Ppu(spdlog::logger& logger, MemoryBus& bus);
+    ~Ppu();
+    bool advance(unsigned int mcycles);
+    unsigned int get_mcycles_to_frame() const;
+    void set_accuracy(PpuAccuracy accuracy);
+    PpuAccuracy get_accuracy() const;
+    void set_downscaler(Downscaler* downscaler);
+    void set_render_skip(bool skip);
+    bool get_render_skip() const;
+    void set_render_thread(bool enabled);
+    bool get_render_thread() const;
+    const FrameBuffer& get_frame() const;
+    const TileCache& get_tiles() const;
+    void save_state(PpuSnapshot& snapshot) const;
+    void load_state(const PpuSnapshot& snapshot);
+
+private:
+    bool next_line();
+    void set_mode(uint8_t mode);
+    void update_stat();
+    void sync_caches();
+    void draw_line();
+    void finish_line(bool window);
+    void present_frame();
+
+    spdlog::logger& m_logger;
+    MemoryBus& m_bus;
+    Downscaler* m_downscaler;
+    alignas(CACHE_LINE_SIZE) FrameBuffer m_frame;
+    TileCache m_tiles;
+    LayerCache m_layers;
+    ObjectLists m_objects;
+    PixelFifoState m_fifo;
+    std::unique_ptr<RenderThread> m_thread;
+    PpuAccuracy m_accuracy;
+    unsigned int m_line;
+    unsigned int m_dot;
+    unsigned int m_window_line;
+    uint8_t m_mode;
+    uint8_t m_line_lcdc;
+    bool m_stat_line;
+    bool m_enabled;
+    bool m_fifo_line;
+    bool m_raster;
+    bool m_layered;
+    bool m_skip_render;
+};
+
+PpuRegisters read_ppu_registers(const MemoryImage& memory);
+bool render_scanline(
+    const uint8_t* vram,
+    const TileCache& tiles,
+    const uint8_t* oam,
+    const PpuRegisters& registers,
+    unsigned int line,
+    unsigned int window_line,
+    uint8_t* shades,
+    LayerCache* layers = nullptr,
+    const LineObjects* objects = nullptr
+);
+LineObjects select_objects(const uint8_t* oam, uint8_t lcdc, unsigned int line);
+} // namespace cbgb
+
+#endif // CBGB_PPU_HPP
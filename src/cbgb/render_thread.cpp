@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cbgb/memory.hpp"
+#include "cbgb/ppu.hpp"
+#include "cbgb/render_thread.hpp"
+#include "cbgb/tile_cache.hpp"
+#include "cbgb/trace.hpp"
+
+namespace cbgb {
+// Often enough for the worker to keep up with the CPU, rarely enough for the
+// hand over to cost next to nothing.
+constexpr unsigned int LINES_PER_SUBMIT = 8;
+
+RenderThread::RenderThread()
+    : m_log()
+    , m_lock()
+    , m_wake()
+    , m_idle()
+    , m_pending()
+    , m_working()
+    , m_memory(std::make_unique<MemoryImage>())
+    , m_tiles(std::make_unique<TileCache>())
+    , m_dirty()
+    , m_frame()
+    , m_drawn()
+    , m_busy(false)
+    , m_stop(false)
+    , m_thread(&RenderThread::run, this)
+{
+}
+
+RenderThread::~RenderThread()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+}
+
+// Log the memory bus writes into, from the emulation thread only.
+VideoLog& RenderThread::get_log()
+{
+    return m_log;
+}
+
+void RenderThread::set_time(unsigned int line, unsigned int dot)
+{
+    m_log.line = static_cast<uint8_t>(line);
+    m_log.dot = static_cast<uint16_t>(dot);
+}
+
+// Marks the current line to be drawn once every write before it is in.
+void RenderThread::draw_line(unsigned int window_line)
+{
+    auto value = static_cast<uint8_t>(window_line);
+    m_log.writes.push_back({ VIDEO_DRAW, value, m_log.line, m_log.dot });
+    if (m_log.line % LINES_PER_SUBMIT == LINES_PER_SUBMIT - 1)
+        submit();
+}
+
+void RenderThread::clear()
+{
+    m_log.writes.push_back({ VIDEO_CLEAR, 0, m_log.line, m_log.dot });
+}
+
+// Copies rather than swaps the log, so that both sides keep their capacity and
+// stop allocating after the first few frames.
+void RenderThread::submit()
+{
+    if (m_log.writes.empty())
+        return;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_pending.insert(m_pending.end(), m_log.writes.begin(), m_log.writes.end());
+    }
+    m_log.writes.clear();
+    m_wake.notify_one();
+}
+
+// Waits for every line logged so far, and copies them into the frame.
+void RenderThread::finish(FrameBuffer& frame)
+{
+    submit();
+    std::unique_lock<std::mutex> lock(m_lock);
+    wait_idle(lock);
+    for (size_t line = 0; line < SCREEN_HEIGHT; ++line) {
+        if (!m_drawn[line])
+            continue;
+        size_t offset = line * SCREEN_WIDTH;
+        std::copy_n(m_frame.begin() + offset, SCREEN_WIDTH, frame.begin() + offset);
+    }
+    m_drawn.fill(false);
+}
+
+// Drops whatever is still logged, and starts over from a copy of memory.
+void RenderThread::reset(const MemoryImage& memory, const FrameBuffer& frame)
+{
+    m_log.writes.clear();
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_pending.clear();
+    wait_idle(lock);
+    *m_memory = memory;
+    VramBitmap all = {};
+    all.fill(~uint64_t(0));
+    m_tiles->update(&memory[VRAM], all);
+    m_dirty.fill(0);
+    m_frame = frame;
+    m_drawn.fill(false);
+}
+
+void RenderThread::run()
+{
+    CBGB_TRACE_THREAD("Render");
+    std::unique_lock<std::mutex> lock(m_lock);
+    while (true) {
+        m_wake.wait(lock, [this] { return m_stop || !m_pending.empty(); });
+        if (m_stop)
+            return;
+
+        m_working.swap(m_pending);
+        m_busy = true;
+        lock.unlock();
+        replay(m_working);
+        m_working.clear();
+        lock.lock();
+        m_busy = false;
+        if (m_pending.empty())
+            m_idle.notify_all();
+    }
+}
+
+void RenderThread::replay(const std::vector<VideoWrite>& writes)
+{
+    MemoryImage& memory = *m_memory;
+    for (const VideoWrite& write : writes) {
+        if (write.address == VIDEO_DRAW) {
+            CBGB_TRACE_SCOPE("PPU line");
+            m_tiles->update(&memory[VRAM], m_dirty);
+            m_dirty.fill(0);
+            size_t offset = static_cast<size_t>(write.line) * SCREEN_WIDTH;
+            render_scanline(
+                &memory[VRAM],
+                *m_tiles,
+                &memory[OAM],
+                read_ppu_registers(memory),
+                write.line,
+                write.value,
+                &m_frame[offset]
+            );
+            m_drawn[write.line] = true;
+        }
+        else if (write.address == VIDEO_CLEAR) {
+            m_frame.fill(0);
+            m_drawn.fill(true);
+        }
+        else {
+            memory[write.address] = write.value;
+            if ((write.address & 0xE000) == VRAM) {
+                size_t block = (write.address - VRAM) / 16U;
+                m_dirty[block / 64] |= uint64_t(1) << (block % 64);
+            }
+        }
+    }
+}
+
+void RenderThread::wait_idle(std::unique_lock<std::mutex>& lock)
+{
+    m_idle.wait(lock, [this] { return m_pending.empty() && !m_busy; });
+}
+} // namespace cbgb
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Scanline rendering on a thread of its own.
+//!
+//! The scanline renderer only needs VRAM, OAM and a few LCD registers as they
+//! were at the end of mode 3 of every line. Rather than drawing on the thread
+//! emulating the CPU, the memory bus logs every write to those, stamped with
+//! the line and dot it happened on, and the PPU adds a marker wherever a line
+//! would have been drawn. A worker thread keeps its own copy of video memory,
+//! replays the log onto it in order, and draws every marked line from that
+//! copy, while the CPU has long moved on.
+//!
+//! The log is handed over every few lines, and the frame is collected at the
+//! start of vertical blank, which is the only point where the emulation
+//! thread waits on the worker. Most of the time the worker is done by then.
+
+#ifndef CBGB_RENDER_THREAD_HPP
+#define CBGB_RENDER_THREAD_HPP
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cbgb/memory.hpp"
+#include "cbgb/ppu.hpp"
+#include "cbgb/tile_cache.hpp"
+
+namespace cbgb {
+/// @brief Log entry address of a line to draw, its value being the window line.
+inline constexpr uint16_t VIDEO_DRAW = 0x0000;
+
+/// @brief Log entry address of the LCD being switched off, which blanks it.
+inline constexpr uint16_t VIDEO_CLEAR = 0x0001;
+
+/// @brief Worker thread drawing scanlines from a log of video writes.
+///
+/// Only lines drawn through the log are handed back, so lines the PPU draws
+/// itself, like those of the pixel FIFO, are left alone.
+class RenderThread final {
+public:
+    RenderThread();
+    ~RenderThread();
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+    VideoLog& get_log();
+    void set_time(unsigned int line, unsigned int dot);
+    void draw_line(unsigned int window_line);
+    void clear();
+    void submit();
+    void finish(FrameBuffer& frame);
+    void reset(const MemoryImage& memory, const FrameBuffer& frame);
+
+private:
+    void run();
+    void replay(const std::vector<VideoWrite>& writes);
+    void wait_idle(std::unique_lock<std::mutex>& lock);
+
+    VideoLog m_log;
+    std::mutex m_lock;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::vector<VideoWrite> m_pending;
+    std::vector<VideoWrite> m_working;
+    std::unique_ptr<MemoryImage> m_memory;
+    std::unique_ptr<TileCache> m_tiles;
+    VramBitmap m_dirty;
+    FrameBuffer m_frame;
+    std::array<bool, SCREEN_HEIGHT> m_drawn;
+    bool m_busy;
+    bool m_stop;
+    std::thread m_thread;
+};
+} // namespace cbgb
+
+#endif // CBGB_RENDER_THREAD_HPP
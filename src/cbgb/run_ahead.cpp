@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <memory>
+
+#include "cbgb/gameboy.hpp"
+#include "cbgb/run_ahead.hpp"
+
+namespace cbgb {
+RunAhead::RunAhead(unsigned int frames)
+    : m_frames(frames)
+    , m_snapshot(std::make_unique<Snapshot>())
+    , m_frame()
+{
+}
+
+const FrameBuffer& RunAhead::step_frame(GameBoy& gameboy)
+{
+    if (m_frames == 0) {
+        gameboy.step_frame();
+        return gameboy.get_frame();
+    }
+
+    // The real frame is committed first, so that the one presented lies the
+    // full frame count past it. Only the presented frame gets drawn, the ones
+    // leading up to it are thrown away anyway.
+    bool skip = gameboy.get_ppu().get_render_skip();
+    gameboy.set_render_skip(true);
+    gameboy.step_frame();
+    gameboy.save_state(*m_snapshot);
+    for (unsigned int i = 0; i < m_frames; ++i) {
+        gameboy.set_render_skip(skip || i + 1 < m_frames);
+        gameboy.step_frame();
+    }
+    m_frame = gameboy.get_frame();
+    gameboy.load_state(*m_snapshot);
+    gameboy.set_render_skip(skip);
+    return m_frame;
+}
+
+void RunAhead::set_frames(unsigned int frames)
+{
+    m_frames = frames;
+}
+
+unsigned int RunAhead::get_frames() const
+{
+    return m_frames;
+}
+} // namespace cbgb
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Run-ahead input latency reduction.
+//!
+//! Most games take one or more frames to react to a button press, because
+//! they poll the joypad during one frame and only draw the result in a later
+//! one. Run-ahead hides that internal lag by committing the real frame, then
+//! emulating a few more frames into the future with the current input,
+//! presenting the last of those, and rewinding to the committed frame. With
+//! N frames of run-ahead, a host frame shows what plain stepping would only
+//! show N host frames later.
+
+#ifndef CBGB_RUN_AHEAD_HPP
+#define CBGB_RUN_AHEAD_HPP
+
+#include <memory>
+
+#include "cbgb/gameboy.hpp"
+
+namespace cbgb {
+/// @brief Run-ahead frame stepper.
+///
+/// Costs one snapshot, one restore, and `frames + 1` emulated frames per host
+/// frame: the committed one, then `frames` run ahead of it, of which only the
+/// last is drawn. A frame count of zero disables run-ahead
+/// entirely. The machine's own frame buffer is left behind by run-ahead, only
+/// the returned frame is current.
+class RunAhead final {
+public:
+    explicit RunAhead(unsigned int frames = 0);
+    const FrameBuffer& step_frame(GameBoy& gameboy);
+    void set_frames(unsigned int frames);
+    unsigned int get_frames() const;
+
+private:
+    unsigned int m_frames;
+    std::unique_ptr<Snapshot> m_snapshot;
+    FrameBuffer m_frame;
+};
+} // namespace cbgb
+
+#endif // CBGB_RUN_AHEAD_HPP
@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <spdlog/logger.h>
+
+#include "cbgb/memory.hpp"
+#include "cbgb/serial.hpp"
+
+namespace cbgb {
+constexpr uint8_t SERIAL_START = 1 << 7;
+constexpr uint8_t SERIAL_INTERNAL = 1 << 0;
+constexpr uint8_t SC_UNUSED = 0x7E;
+constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+Serial::Serial(spdlog::logger& logger, MemoryBus& bus)
+    : m_logger(logger)
+    , m_bus(bus)
+    , m_output()
+    , m_clock(0)
+    , m_start(0)
+    , m_event(NEVER)
+    , m_linked(false)
+{
+    m_bus.store(SC, SC_UNUSED);
+    m_logger.trace("Construct new serial port");
+}
+
+// Only an open line ever finishes a transfer in between windows.
+void Serial::advance(unsigned int mcycles)
+{
+    m_clock += mcycles * 4;
+    if (m_clock >= m_event)
+        complete(0xFF);
+}
+
+void Serial::write(uint16_t address, uint8_t value)
+{
+    if (address == SB) {
+        m_bus.store(SB, value);
+        return;
+    }
+
+    m_bus.store(SC, static_cast<uint8_t>(SC_UNUSED | value));
+    if ((value & SERIAL_START) != 0) {
+        m_start = m_clock;
+        if ((value & SERIAL_INTERNAL) != 0)
+            m_output.push_back(static_cast<char>(m_bus.get_image()[SB]));
+    }
+    schedule();
+}
+
+// Transfers wait for the other side from now on, or shift in ones again.
+void Serial::set_linked(bool linked)
+{
+    m_linked = linked;
+    schedule();
+}
+
+LinkPacket Serial::get_packet() const
+{
+    uint8_t control = m_bus.get_image()[SC];
+    LinkPacket packet = { m_bus.get_image()[SB], 0 };
+    if ((control & SERIAL_START) == 0)
+        return packet;
+
+    if ((control & SERIAL_INTERNAL) == 0)
+        packet.flags = LINK_READY;
+    else if (m_clock - m_start >= SERIAL_TRANSFER_CYCLES)
+        packet.flags = LINK_CLOCK;
+    return packet;
+}
+
+// Settles this side of the window that just ended. A side driving the clock
+// shifts in ones from a partner that does not wait for it, just like from an
+// open line. Both sides driving the clock at once never see each other.
+void Serial::receive(const LinkPacket& partner)
+{
+    LinkPacket own = get_packet();
+    if ((own.flags & LINK_CLOCK) != 0)
+        complete((partner.flags & LINK_READY) != 0 ? partner.data : 0xFF);
+    else if ((own.flags & LINK_READY) != 0 && (partner.flags & LINK_CLOCK) != 0)
+        complete(partner.data);
+}
+
+const std::string& Serial::get_output() const
+{
+    return m_output;
+}
+
+void Serial::save_state(SerialSnapshot& snapshot) const
+{
+    snapshot.clock = m_clock;
+    snapshot.start = m_start;
+}
+
+// Output already sent stays, like anything else that left the machine.
+void Serial::load_state(const SerialSnapshot& snapshot)
+{
+    m_clock = snapshot.clock;
+    m_start = snapshot.start;
+    schedule();
+}
+
+void Serial::complete(uint8_t data)
+{
+    m_bus.store(SB, data);
+    m_bus.store(SC, static_cast<uint8_t>(m_bus.get_image()[SC] & ~SERIAL_START));
+    m_bus.request_interrupt(INTERRUPT_SERIAL);
+    m_event = NEVER;
+}
+
+void Serial::schedule()
+{
+    uint8_t control = m_bus.get_image()[SC];
+    bool clocked = (control & SERIAL_START) != 0 && (control & SERIAL_INTERNAL) != 0;
+    m_event = clocked && !m_linked ? m_start + SERIAL_TRANSFER_CYCLES : NEVER;
+}
+} // namespace cbgb
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief GameBoy serial port.
+//!
+//! A transfer shifts the 8 bits of SB out to the other side of the link cable,
+//! while shifting in the 8 bits the other side had in its own SB \[[1]\]. The
+//! side using its internal clock drives the transfer at 8192 Hz, taking 1024
+//! T-cycles for the whole byte. The side waiting on the external clock only
+//! moves along with it.
+//!
+//! Bits are not shifted one at a time. Linked machines run on their own for a
+//! window of thousands of cycles, and only tell each other what their port is
+//! up to at the end of it: whether a transfer it clocks has had the time to
+//! finish, and whether it waits for one. Both sides settle their transfers
+//! from that, and move on to the next window. Without a link, transfers on
+//! the internal clock shift in all ones from the open line.
+//!
+//! [1]: https://gbdev.io/pandocs/Serial_Data_Transfer_(Link_Cable).html
+
+#ifndef CBGB_SERIAL_HPP
+#define CBGB_SERIAL_HPP
+
+#include <cstdint>
+#include <string>
+
+#include <spdlog/logger.h>
+
+#include "cbgb/memory.hpp"
+
+namespace cbgb {
+inline constexpr uint16_t SB = 0xFF01;
+inline constexpr uint16_t SC = 0xFF02;
+
+/// @brief T-cycles to shift a whole byte on the internal clock.
+inline constexpr uint64_t SERIAL_TRANSFER_CYCLES = 1024;
+
+/// @brief What a serial port tells the other side of the link.
+enum LinkFlag : uint8_t {
+    /// Drives a transfer that has had the time to finish.
+    LINK_CLOCK = 1 << 0,
+    /// Waits for a transfer on the external clock.
+    LINK_READY = 1 << 1,
+    /// Has run as far as it was asked to, for links across processes.
+    LINK_DONE = 1 << 2,
+};
+
+/// @brief State of one side of the link at the end of a window.
+struct LinkPacket {
+    uint8_t data;
+    uint8_t flags;
+};
+
+/// @brief Plain copy of serial port state. SB and SC live in memory.
+struct SerialSnapshot {
+    uint64_t clock;
+    uint64_t start;
+};
+
+/// @brief Serial port, either linked window by window, or left open.
+///
+/// Clocks are counted in T-cycles. Every byte sent is also kept as text, which
+/// is how test ROMs report their results.
+class Serial final {
+public:
+    Serial(spdlog::logger& logger, MemoryBus& bus);
+    void advance(unsigned int mcycles);
+    void write(uint16_t address, uint8_t value);
+    void set_linked(bool linked);
+    LinkPacket get_packet() const;
+    void receive(const LinkPacket& partner);
+    const std::string& get_output() const;
+    void save_state(SerialSnapshot& snapshot) const;
+    void load_state(const SerialSnapshot& snapshot);
+
+private:
+    void complete(uint8_t data);
+    void schedule();
+
+    spdlog::logger& m_logger;
+    MemoryBus& m_bus;
+    std::string m_output;
+    uint64_t m_clock;
+    uint64_t m_start;
+    uint64_t m_event;
+    bool m_linked;
+};
+} // namespace cbgb
+
+#endif // CBGB_SERIAL_HPP
@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Lock-free single producer, single consumer queue.
+//!
+//! Fixed size ring buffer for handing small messages from one thread to
+//! another, such as input from a frontend to its emulation thread, without
+//! either side ever blocking. Each side only writes its own index, and reads
+//! the other one, so two atomics with acquire and release ordering suffice.
+
+#ifndef CBGB_SPSC_QUEUE_HPP
+#define CBGB_SPSC_QUEUE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include "cbgb/memory.hpp"
+
+namespace cbgb {
+/// @brief Bounded queue between exactly one producer and one consumer thread.
+///
+/// Holds up to `Capacity - 1` items, with `Capacity` a power of two.
+template <typename T, size_t Capacity>
+class SpscQueue final {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0);
+
+public:
+    SpscQueue()
+        : m_items()
+        , m_head(0)
+        , m_tail(0)
+    {
+    }
+
+    /// @brief Adds an item, unless the queue is full. Producer only.
+    bool push(const T& item)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) & (Capacity - 1);
+        if (next == m_head.load(std::memory_order_acquire))
+            return false;
+        m_items[tail] = item;
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Takes the oldest item, unless the queue is empty. Consumer only.
+    bool pop(T& item)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+        item = m_items[head];
+        m_head.store((head + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Adds as many of the items as fit, and returns how many did.
+    /// Producer only.
+    size_t push(const T* items, size_t count)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t head = m_head.load(std::memory_order_acquire);
+        count = std::min(count, (head - tail - 1) & (Capacity - 1));
+        for (size_t i = 0; i < count; ++i)
+            m_items[(tail + i) & (Capacity - 1)] = items[i];
+        m_tail.store((tail + count) & (Capacity - 1), std::memory_order_release);
+        return count;
+    }
+
+    /// @brief Takes up to `count` of the oldest items, and returns how many it
+    /// took. Consumer only.
+    size_t pop(T* items, size_t count)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        size_t tail = m_tail.load(std::memory_order_acquire);
+        count = std::min(count, (tail - head) & (Capacity - 1));
+        for (size_t i = 0; i < count; ++i)
+            items[i] = m_items[(head + i) & (Capacity - 1)];
+        m_head.store((head + count) & (Capacity - 1), std::memory_order_release);
+        return count;
+    }
+
+    /// @brief Items in the queue. Exact from either side while the other one
+    /// is idle, a snapshot that may already be out of date otherwise.
+    size_t size() const
+    {
+        size_t head = m_head.load(std::memory_order_acquire);
+        size_t tail = m_tail.load(std::memory_order_acquire);
+        return (tail - head) & (Capacity - 1);
+    }
+
+private:
+    std::array<T, Capacity> m_items;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail;
+};
+} // namespace cbgb
+
+#endif // CBGB_SPSC_QUEUE_HPP
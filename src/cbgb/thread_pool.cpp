@@ -0,0 +1,205 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include "cbgb/thread_pool.hpp"
+
+namespace cbgb {
+// Index of the worker owning the current thread, or -1 outside of any pool.
+thread_local int current_worker = -1;
+thread_local const ThreadPool* current_pool = nullptr;
+
+// Cores the calling thread may run on, which under `taskset` or a cgroup
+// cpuset need not be the first few, nor as many as the machine has. Falls back
+// to every core of the machine where the affinity mask cannot be read.
+std::vector<unsigned int> get_allowed_cores()
+{
+    std::vector<unsigned int> cores;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (unsigned int core = 0; core < CPU_SETSIZE; ++core) {
+            if (CPU_ISSET(core, &set))
+                cores.push_back(core);
+        }
+    }
+#endif
+    if (cores.empty()) {
+        unsigned int count = std::max(1U, std::thread::hardware_concurrency());
+        for (unsigned int core = 0; core < count; ++core)
+            cores.push_back(core);
+    }
+    return cores;
+}
+
+bool pin_current_thread(unsigned int core)
+{
+#if defined(__linux__)
+    if (core >= CPU_SETSIZE)
+        return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)core;
+    return false;
+#endif
+}
+
+// Pinning failures are logged to the given logger, or to spdlog's default one
+// if there is none.
+ThreadPool::ThreadPool(unsigned int threads, bool pin, spdlog::logger* logger)
+    : m_cores(pin ? get_allowed_cores() : std::vector<unsigned int>())
+    , m_logger(logger != nullptr ? *logger : *spdlog::default_logger_raw())
+    , m_next(0)
+    , m_queued(0)
+    , m_pending(0)
+    , m_stop(false)
+{
+    if (threads == 0)
+        threads = std::max(1U, std::thread::hardware_concurrency());
+
+    for (unsigned int i = 0; i < threads; ++i)
+        m_workers.push_back(std::make_unique<Worker>());
+    for (unsigned int i = 0; i < threads; ++i)
+        m_threads.emplace_back(&ThreadPool::run, this, i, pin);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads)
+        thread.join();
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    unsigned int index = current_pool == this
+        ? static_cast<unsigned int>(current_worker)
+        : m_next.fetch_add(1, std::memory_order_relaxed) % size();
+    // Count the task before it becomes visible, so a thief can never pop it
+    // ahead of the counters. Worst case a woken worker spins once or twice.
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        ++m_queued;
+        ++m_pending;
+    }
+    {
+        std::lock_guard<std::mutex> guard(m_workers[index]->lock);
+        m_workers[index]->tasks.push_back(std::move(task));
+    }
+    m_wake.notify_one();
+}
+
+// Rethrows the first exception any task threw since the last wait.
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+    m_idle.wait(guard, [this] { return m_pending == 0; });
+    if (m_error) {
+        std::exception_ptr error = std::exchange(m_error, nullptr);
+        std::rethrow_exception(error);
+    }
+}
+
+unsigned int ThreadPool::size() const
+{
+    return static_cast<unsigned int>(m_workers.size());
+}
+
+void ThreadPool::run(unsigned int index, bool pin)
+{
+    current_worker = static_cast<int>(index);
+    current_pool = this;
+    if (pin)
+        pin_worker(index);
+
+    std::function<void()> task;
+    for (;;) {
+        if (try_pop(index, task)) {
+            std::exception_ptr error = nullptr;
+            try {
+                task();
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+            task = nullptr;
+            finish_task(error);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(m_lock);
+        m_wake.wait(guard, [this] { return m_queued != 0 || m_stop; });
+        if (m_stop && m_queued == 0)
+            return;
+    }
+}
+
+// Workers are dealt out over the allowed cores in turn, wrapping around when
+// there are more workers than cores.
+void ThreadPool::pin_worker(unsigned int index)
+{
+    unsigned int core = m_cores[index % m_cores.size()];
+    if (!pin_current_thread(core))
+        m_logger.warn("Cannot pin worker {0} to core {1}, running it unpinned", index, core);
+}
+
+bool ThreadPool::try_pop(unsigned int index, std::function<void()>& task)
+{
+    unsigned int count = size();
+    bool found = false;
+    for (unsigned int i = 0; i < count && !found; ++i) {
+        Worker& worker = *m_workers[(index + i) % count];
+        std::lock_guard<std::mutex> guard(worker.lock);
+        if (worker.tasks.empty())
+            continue;
+
+        if (i == 0) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        }
+        else {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+        }
+        found = true;
+    }
+
+    if (found) {
+        std::lock_guard<std::mutex> guard(m_lock);
+        --m_queued;
+    }
+    return found;
+}
+
+void ThreadPool::finish_task(std::exception_ptr error)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (error && !m_error)
+        m_error = error;
+    if (--m_pending == 0)
+        m_idle.notify_all();
+}
+} // namespace cbgb
@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Work-stealing thread pool.
+//!
+//! Every worker owns a task deque. Workers pop from the back of their own
+//! deque, and steal from the front of other deques once theirs runs dry. Tasks
+//! submitted from outside the pool are dealt out round-robin, while tasks
+//! submitted from inside a worker stay on that worker's deque to keep its
+//! caches warm. Workers can optionally be pinned to one core each, taken from
+//! the cores the process may run on, so that `taskset` and cgroup cpusets are
+//! respected. A worker that cannot be pinned logs a warning and runs unpinned.
+
+#ifndef CBGB_THREAD_POOL_HPP
+#define CBGB_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace cbgb {
+class ThreadPool final {
+public:
+    explicit ThreadPool(
+        unsigned int threads = 0, bool pin = false, spdlog::logger* logger = nullptr
+    );
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    void submit(std::function<void()> task);
+    void wait();
+    unsigned int size() const;
+
+private:
+    struct Worker {
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void run(unsigned int index, bool pin);
+    void pin_worker(unsigned int index);
+    bool try_pop(unsigned int index, std::function<void()>& task);
+    void finish_task(std::exception_ptr error);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::vector<unsigned int> m_cores;
+    spdlog::logger& m_logger;
+    std::mutex m_lock;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::atomic<unsigned int> m_next;
+    size_t m_queued;
+    size_t m_pending;
+    bool m_stop;
+    std::exception_ptr m_error;
+};
+
+std::vector<unsigned int> get_allowed_cores();
+bool pin_current_thread(unsigned int core);
+} // namespace cbgb
+
+#endif // CBGB_THREAD_POOL_HPP
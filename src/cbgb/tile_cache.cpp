@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "cbgb/memory.hpp"
+#include "cbgb/tile_cache.hpp"
+#include "cbgb/video.hpp"
+
+namespace cbgb {
+TileCache::TileCache()
+    : m_colors()
+    , m_generation(0)
+{
+}
+
+// Takes VRAM from $8000 on. Tile data covers the first 384 bits of the
+// bitmap, the tile maps after it are of no concern here.
+void TileCache::update(const uint8_t* vram, const VramBitmap& dirty)
+{
+    bool changed = false;
+    for (size_t word = 0; word < TILE_COUNT / 64; ++word) {
+        uint64_t bits = dirty[word];
+        for (size_t bit = 0; bits != 0; ++bit, bits >>= 1) {
+            if ((bits & 1) != 0)
+                changed |= decode(vram, word * 64 + bit);
+        }
+    }
+    if (changed)
+        ++m_generation;
+}
+
+const uint8_t* TileCache::get_tile(size_t index) const
+{
+    return &m_colors[index * 64];
+}
+
+const uint8_t* TileCache::get_row(size_t index, unsigned int row) const
+{
+    return &m_colors[index * 64 + row * 8];
+}
+
+uint64_t TileCache::get_generation() const
+{
+    return m_generation;
+}
+
+// All 8 rows of a tile go through the decoder at once, as if they were 8
+// tiles side by side. Returns whether the tile came out any different.
+bool TileCache::decode(const uint8_t* vram, size_t index)
+{
+    std::array<uint8_t, 8> low = {};
+    std::array<uint8_t, 8> high = {};
+    const uint8_t* tile = vram + index * 16;
+    for (size_t row = 0; row < 8; ++row) {
+        low[row] = tile[row * 2];
+        high[row] = tile[row * 2 + 1];
+    }
+    std::array<uint8_t, 64> colors = {};
+    decode_tiles(low.data(), high.data(), 8, colors.data());
+    uint8_t* cached = &m_colors[index * 64];
+    if (std::equal(colors.begin(), colors.end(), cached))
+        return false;
+    std::copy(colors.begin(), colors.end(), cached);
+    return true;
+}
+
+// Index of the tile a tile map entry points to. Objects, and the background
+// with LCDC bit 4 set, index tiles unsigned from $8000. Otherwise indices are
+// signed, relative to $9000.
+size_t tile_index(uint8_t entry, bool unsigned_index)
+{
+    if (unsigned_index)
+        return entry;
+    return static_cast<size_t>(256 + static_cast<int8_t>(entry));
+}
+} // namespace cbgb
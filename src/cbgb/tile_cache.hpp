@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Decoded tile cache.
+//!
+//! Tile data in VRAM holds 384 tiles of 8x8 pixels, every row of which is
+//! stored as two bit planes \[[1]\]. Games draw the same tiles over and over,
+//! while rewriting their data only once in a while, so rather than decoding
+//! bit planes again for every scanline, every tile is kept decoded into one
+//! color index per byte. Only tiles written since the last update are decoded
+//! again, as told by the VRAM bitmap of the memory bus.
+//!
+//! [1]: https://gbdev.io/pandocs/Tile_Data.html
+
+#ifndef CBGB_TILE_CACHE_HPP
+#define CBGB_TILE_CACHE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "cbgb/memory.hpp"
+
+namespace cbgb {
+inline constexpr size_t TILE_COUNT = 384;
+
+/// @brief Color indices of every tile in VRAM, 64 bytes per tile.
+///
+/// Rows are 8 bytes each, leftmost pixel first. The generation counts updates
+/// that actually changed a tile, so that anyone showing the tiles can tell
+/// when to look again, even though restoring a snapshot rewrites all of VRAM.
+class TileCache final {
+public:
+    TileCache();
+    void update(const uint8_t* vram, const VramBitmap& dirty);
+    const uint8_t* get_tile(size_t index) const;
+    const uint8_t* get_row(size_t index, unsigned int row) const;
+    uint64_t get_generation() const;
+
+private:
+    bool decode(const uint8_t* vram, size_t index);
+
+    alignas(CACHE_LINE_SIZE) std::array<uint8_t, TILE_COUNT * 64> m_colors;
+    uint64_t m_generation;
+};
+
+size_t tile_index(uint8_t entry, bool unsigned_index);
+} // namespace cbgb
+
+#endif // CBGB_TILE_CACHE_HPP
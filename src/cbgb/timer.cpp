@@ -0,0 +1,215 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <cstdint>
+#include <limits>
+
+#include <spdlog/logger.h>
+
+#include "cbgb/memory.hpp"
+#include "cbgb/timer.hpp"
+
+namespace cbgb {
+constexpr uint8_t TIMER_ENABLE = 1 << 2;
+constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+// TIMA is reloaded one M-cycle after it overflows.
+constexpr uint64_t RELOAD_DELAY = 4;
+
+// The boot ROM hands over with DIV at $AB, and its lower byte at $CC.
+constexpr uint64_t BOOT_COUNTER = 0xABCC;
+
+Timer::Timer(spdlog::logger& logger, MemoryBus& bus)
+    : m_logger(logger)
+    , m_bus(bus)
+    , m_clock(BOOT_COUNTER)
+    , m_origin(0)
+    , m_tima_clock(BOOT_COUNTER)
+    , m_reload_clock(NEVER)
+    , m_reloaded_clock(NEVER)
+    , m_event(NEVER)
+    , m_tima(0)
+    , m_tma(0)
+    , m_tac(0)
+    , m_reload(false)
+{
+    m_bus.store(TAC, 0xF8);
+    m_logger.trace("Construct new timer");
+}
+
+// Nothing happens until the next scheduled overflow comes due.
+void Timer::advance(unsigned int mcycles)
+{
+    m_clock += mcycles * 4;
+    if (m_clock >= m_event) {
+        sync();
+        schedule();
+    }
+}
+
+uint8_t Timer::read(uint16_t address)
+{
+    switch (address) {
+    case DIV:
+        return static_cast<uint8_t>((m_clock - m_origin) >> 8);
+    case TIMA:
+        sync();
+        schedule();
+        return m_tima;
+    case TMA:
+        return m_tma;
+    default:
+        return static_cast<uint8_t>(0xF8 | m_tac);
+    }
+}
+
+// Pan Docs: https://gbdev.io/pandocs/Timer_Obscure_Behaviour.html
+void Timer::write(uint16_t address, uint8_t value)
+{
+    sync();
+    switch (address) {
+    case DIV: {
+        bool signal = get_signal();
+        m_origin = m_clock;
+        if (signal)
+            increment();
+        break;
+    }
+    case TIMA:
+        // Writes in the M-cycle before the reload cancel it, writes in the
+        // M-cycle of the reload lose out to TMA.
+        if (m_reloaded_clock != m_clock) {
+            m_tima = value;
+            m_reload = false;
+        }
+        break;
+    case TMA:
+        m_tma = value;
+        if (m_reloaded_clock == m_clock)
+            m_tima = value;
+        break;
+    default: {
+        bool signal = get_signal();
+        m_tac = value & 0x07;
+        if (signal && !get_signal())
+            increment();
+        break;
+    }
+    }
+    schedule();
+
+    // Keeps the raw view of memory close to what the registers read as.
+    m_bus.store(address, read(address));
+}
+
+void Timer::save_state(TimerSnapshot& snapshot) const
+{
+    snapshot.clock = m_clock;
+    snapshot.origin = m_origin;
+    snapshot.tima_clock = m_tima_clock;
+    snapshot.reload_clock = m_reload_clock;
+    snapshot.reloaded_clock = m_reloaded_clock;
+    snapshot.tima = m_tima;
+    snapshot.tma = m_tma;
+    snapshot.tac = m_tac;
+    snapshot.reload = m_reload;
+}
+
+void Timer::load_state(const TimerSnapshot& snapshot)
+{
+    m_clock = snapshot.clock;
+    m_origin = snapshot.origin;
+    m_tima_clock = snapshot.tima_clock;
+    m_reload_clock = snapshot.reload_clock;
+    m_reloaded_clock = snapshot.reloaded_clock;
+    m_tima = snapshot.tima;
+    m_tma = snapshot.tma;
+    m_tac = snapshot.tac;
+    m_reload = snapshot.reload;
+    schedule();
+}
+
+// Brings TIMA up to the present, one overflow at a time. The selected bit
+// falls every time the counter reaches a multiple of twice its value, so the
+// edges between two points in time are the difference of both divided by
+// that period.
+void Timer::sync()
+{
+    while (true) {
+        if (m_reload && m_reload_clock <= m_clock) {
+            m_tima = m_tma;
+            m_reload = false;
+            m_reloaded_clock = m_reload_clock;
+            m_tima_clock = m_reload_clock;
+            m_bus.request_interrupt(INTERRUPT_TIMER);
+        }
+
+        // No edge of any bit comes before a pending reload.
+        if ((m_tac & TIMER_ENABLE) == 0 || m_reload) {
+            m_tima_clock = m_clock;
+            return;
+        }
+
+        unsigned int shift = get_shift();
+        uint64_t first = (m_tima_clock - m_origin) >> shift;
+        uint64_t edges = ((m_clock - m_origin) >> shift) - first;
+        if (m_tima + edges <= 0xFF) {
+            m_tima = static_cast<uint8_t>(m_tima + edges);
+            m_tima_clock = m_clock;
+            return;
+        }
+
+        uint64_t overflow = ((first + 0x100 - m_tima) << shift) + m_origin;
+        m_tima = 0;
+        m_reload = true;
+        m_reload_clock = overflow + RELOAD_DELAY;
+        m_tima_clock = overflow;
+    }
+}
+
+// Next time anything observable happens on its own, which is the interrupt
+// after the next overflow.
+void Timer::schedule()
+{
+    if (m_reload) {
+        m_event = m_reload_clock;
+        return;
+    }
+    if ((m_tac & TIMER_ENABLE) == 0) {
+        m_event = NEVER;
+        return;
+    }
+
+    unsigned int shift = get_shift();
+    uint64_t first = (m_tima_clock - m_origin) >> shift;
+    m_event = ((first + 0x100 - m_tima) << shift) + m_origin + RELOAD_DELAY;
+}
+
+// One extra edge, from a write that pulled the signal low.
+void Timer::increment()
+{
+    if (m_tima < 0xFF) {
+        ++m_tima;
+        return;
+    }
+    m_tima = 0;
+    m_reload = true;
+    m_reload_clock = m_clock + RELOAD_DELAY;
+}
+
+// Selected bit of the counter, ANDed with the enable bit.
+bool Timer::get_signal() const
+{
+    if ((m_tac & TIMER_ENABLE) == 0)
+        return false;
+    return (((m_clock - m_origin) >> (get_shift() - 1)) & 1) != 0;
+}
+
+// Period of TIMA as a power of two, which is twice the selected bit: bit 9,
+// 3, 5 or 7 of the counter for 4096, 262144, 65536 or 16384 Hz.
+unsigned int Timer::get_shift() const
+{
+    constexpr unsigned int shifts[] = { 10, 4, 6, 8 };
+    return shifts[m_tac & 0x03];
+}
+} // namespace cbgb
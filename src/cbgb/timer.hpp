@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief GameBoy timer and divider.
+//!
+//! DIV is the upper byte of a 16-bit system counter that counts every
+//! T-cycle. TIMA counts the falling edges of one bit of that counter, picked
+//! by TAC, ANDed with the enable bit of TAC \[[1]\]. Once TIMA overflows it
+//! reads as zero for one M-cycle, after which it is reloaded from TMA and the
+//! timer interrupt is requested.
+//!
+//! Nothing here ticks. The system counter is the difference between the cycle
+//! counter and the time DIV was last reset, and the edges TIMA counted since
+//! it was last looked at follow from dividing both ends by the period of the
+//! selected bit. The only thing that needs to happen at a given time is the
+//! interrupt, which is scheduled for the next overflow and checked for with a
+//! single comparison per instruction.
+//!
+//! Because the counter is ANDed with the enable bit before the edge detector,
+//! writes to DIV and TAC that drop that signal from high to low count as an
+//! edge too \[[2]\].
+//!
+//! [1]: https://gbdev.io/pandocs/Timer_and_Divider_Registers.html
+//! [2]: https://gbdev.io/pandocs/Timer_Obscure_Behaviour.html
+
+#ifndef CBGB_TIMER_HPP
+#define CBGB_TIMER_HPP
+
+#include <cstdint>
+
+#include <spdlog/logger.h>
+
+#include "cbgb/memory.hpp"
+
+namespace cbgb {
+inline constexpr uint16_t DIV = 0xFF04;
+inline constexpr uint16_t TIMA = 0xFF05;
+inline constexpr uint16_t TMA = 0xFF06;
+inline constexpr uint16_t TAC = 0xFF07;
+
+/// @brief Plain copy of timer state.
+struct TimerSnapshot {
+    uint64_t clock;
+    uint64_t origin;
+    uint64_t tima_clock;
+    uint64_t reload_clock;
+    uint64_t reloaded_clock;
+    uint8_t tima;
+    uint8_t tma;
+    uint8_t tac;
+    bool reload;
+};
+
+/// @brief Timer computed from the cycle counter on demand.
+///
+/// Clocks are counted in T-cycles. Reads and writes land at the start of the
+/// instruction doing them, the same as for every other peripheral.
+class Timer final {
+public:
+    Timer(spdlog::logger& logger, MemoryBus& bus);
+    void advance(unsigned int mcycles);
+    uint8_t read(uint16_t address);
+    void write(uint16_t address, uint8_t value);
+    void save_state(TimerSnapshot& snapshot) const;
+    void load_state(const TimerSnapshot& snapshot);
+
+private:
+    void sync();
+    void schedule();
+    void increment();
+    bool get_signal() const;
+    unsigned int get_shift() const;
+
+    spdlog::logger& m_logger;
+    MemoryBus& m_bus;
+    uint64_t m_clock;
+    uint64_t m_origin;
+    uint64_t m_tima_clock;
+    uint64_t m_reload_clock;
+    uint64_t m_reloaded_clock;
+    uint64_t m_event;
+    uint8_t m_tima;
+    uint8_t m_tma;
+    uint8_t m_tac;
+    bool m_reload;
+};
+} // namespace cbgb
+
+#endif // CBGB_TIMER_HPP
@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "cbgb/json.hpp"
+#include "cbgb/trace.hpp"
+
+namespace cbgb {
+// Blocks of events are allocated as a thread needs them, so that threads which
+// record a few events only ever hold a few.
+constexpr size_t TRACE_BLOCK_SIZE = 4096;
+
+struct TraceEvent {
+    const char* name;
+    TraceClock::time_point start;
+    TraceClock::time_point end;
+};
+
+using TraceBlock = std::array<TraceEvent, TRACE_BLOCK_SIZE>;
+
+// Events of one thread. Only that thread writes them, and only ever past the
+// count it published last, so exporting can read everything before the count
+// while recording goes on. The lock guards the list of blocks and the name.
+struct TraceBuffer {
+    std::mutex lock;
+    std::vector<std::unique_ptr<TraceBlock>> blocks;
+    std::atomic<size_t> count;
+    std::string name;
+    size_t id;
+};
+
+// Buffers are never freed, so that events of threads long gone still make it
+// into the export.
+struct TraceRegistry {
+    std::mutex lock;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+};
+
+static TraceRegistry& get_registry()
+{
+    static TraceRegistry registry;
+    return registry;
+}
+
+static TraceBuffer& get_buffer()
+{
+    thread_local TraceBuffer* buffer = nullptr;
+    if (buffer != nullptr)
+        return *buffer;
+
+    TraceRegistry& registry = get_registry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    auto created = std::make_unique<TraceBuffer>();
+    created->count = 0;
+    created->id = registry.buffers.size() + 1;
+    created->name = fmt::format("Thread {}", created->id);
+    buffer = created.get();
+    registry.buffers.push_back(std::move(created));
+    return *buffer;
+}
+
+// Records one event on the current thread, or drops it once the thread has
+// recorded as many as it may.
+void trace_event(const char* name, TraceClock::time_point start, TraceClock::time_point end)
+{
+    TraceBuffer& buffer = get_buffer();
+    size_t count = buffer.count.load(std::memory_order_relaxed);
+    if (count == TRACE_MAX_EVENTS)
+        return;
+    if (count % TRACE_BLOCK_SIZE == 0) {
+        std::lock_guard<std::mutex> guard(buffer.lock);
+        buffer.blocks.push_back(std::make_unique<TraceBlock>());
+    }
+    (*buffer.blocks[count / TRACE_BLOCK_SIZE])[count % TRACE_BLOCK_SIZE] = { name, start, end };
+    buffer.count.store(count + 1, std::memory_order_release);
+}
+
+// Name the current thread shows up under, instead of its number.
+void set_trace_thread_name(const char* name)
+{
+    TraceBuffer& buffer = get_buffer();
+    std::lock_guard<std::mutex> guard(buffer.lock);
+    buffer.name = name;
+}
+
+static const TraceEvent& get_event(const TraceBuffer& buffer, size_t index)
+{
+    return (*buffer.blocks[index / TRACE_BLOCK_SIZE])[index % TRACE_BLOCK_SIZE];
+}
+
+// Timestamps are in microseconds since the earliest event, with nanoseconds in
+// the fraction. Every event is a complete one, and every thread gets its name
+// as metadata.
+void write_chrome_trace(std::ostream& out)
+{
+    TraceRegistry& registry = get_registry();
+    std::lock_guard<std::mutex> registry_guard(registry.lock);
+    TraceClock::time_point epoch = TraceClock::time_point::max();
+    for (const std::unique_ptr<TraceBuffer>& buffer : registry.buffers) {
+        std::lock_guard<std::mutex> guard(buffer->lock);
+        if (buffer->count.load(std::memory_order_acquire) != 0)
+            epoch = std::min(epoch, get_event(*buffer, 0).start);
+    }
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    const char* separator = "\n";
+    for (const std::unique_ptr<TraceBuffer>& buffer : registry.buffers) {
+        std::lock_guard<std::mutex> guard(buffer->lock);
+        out << separator
+            << fmt::format(
+                   "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                   "\"args\":{{\"name\":\"{}\"}}}}",
+                   buffer->id,
+                   escape_json(buffer->name)
+               );
+        separator = ",\n";
+
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent& event = get_event(*buffer, i);
+            std::chrono::duration<double, std::micro> start = event.start - epoch;
+            std::chrono::duration<double, std::micro> duration = event.end - event.start;
+            out << separator
+                << fmt::format(
+                       "{{\"name\":\"{}\",\"cat\":\"cbgb\",\"ph\":\"X\",\"ts\":{:.3f},"
+                       "\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                       escape_json(event.name),
+                       start.count(),
+                       duration.count(),
+                       buffer->id
+                   );
+        }
+    }
+    out << "\n]}\n";
+}
+
+TraceScope::TraceScope(const char* name)
+    : m_name(name)
+    , m_start(TraceClock::now())
+{
+}
+
+TraceScope::~TraceScope()
+{
+    trace_event(m_name, m_start, TraceClock::now());
+}
+} // namespace cbgb
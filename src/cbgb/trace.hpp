@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Timeline of host-side phases, in Chrome's trace event format.
+//!
+//! Scoped markers record how long each major phase took, and on which thread,
+//! so that a stutter can be followed across threads, from the CPU running a
+//! frame to it being presented. Every thread records into a buffer of its own,
+//! without locking, and the lot is exported as JSON that Perfetto and
+//! chrome://tracing open as is.
+//!
+//! Markers cost a clock read on either end, so they are compiled out unless the
+//! build defines CBGB_TRACING, which the ENABLE_TRACING option does. Recording
+//! and exporting stay available either way.
+//!
+//! - https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+//! - https://ui.perfetto.dev
+
+#ifndef CBGB_TRACE_HPP
+#define CBGB_TRACE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+
+namespace cbgb {
+#if defined(CBGB_TRACING)
+inline constexpr bool TRACING_ENABLED = true;
+#else
+inline constexpr bool TRACING_ENABLED = false;
+#endif
+
+/// @brief Most events a single thread records, after which it drops the rest.
+inline constexpr size_t TRACE_MAX_EVENTS = size_t(1) << 20;
+
+using TraceClock = std::chrono::steady_clock;
+
+void trace_event(const char* name, TraceClock::time_point start, TraceClock::time_point end);
+void set_trace_thread_name(const char* name);
+void write_chrome_trace(std::ostream& out);
+
+/// @brief Records its own lifetime as one event on the current thread.
+///
+/// The name is kept as a pointer, so it has to outlive the trace, which a
+/// string literal does.
+class TraceScope final {
+public:
+    explicit TraceScope(const char* name);
+    ~TraceScope();
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    TraceClock::time_point m_start;
+};
+} // namespace cbgb
+
+#define CBGB_TRACE_CONCAT_IMPL(left, right) left##right
+#define CBGB_TRACE_CONCAT(left, right) CBGB_TRACE_CONCAT_IMPL(left, right)
+
+#if defined(CBGB_TRACING)
+#define CBGB_TRACE_SCOPE(name) \
+    const cbgb::TraceScope CBGB_TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define CBGB_TRACE_THREAD(name) cbgb::set_trace_thread_name(name)
+#else
+#define CBGB_TRACE_SCOPE(name) static_cast<void>(0)
+#define CBGB_TRACE_THREAD(name) static_cast<void>(0)
+#endif
+
+#endif // CBGB_TRACE_HPP
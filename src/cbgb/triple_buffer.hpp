@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Lock-free triple buffer.
+//!
+//! Hands the latest of a stream of large values, such as completed frames,
+//! from one thread to another. The writer always has a slot of its own to fill,
+//! the reader always has a slot of its own to look at, and the third slot
+//! holds whatever was published last. Publishing and picking up swap a slot
+//! with the middle one in a single atomic exchange, so neither side ever waits
+//! on the other, and values the reader was too slow for are simply skipped.
+
+#ifndef CBGB_TRIPLE_BUFFER_HPP
+#define CBGB_TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "cbgb/memory.hpp"
+
+namespace cbgb {
+/// @brief Triple buffer between exactly one writer and one reader thread.
+///
+/// Large enough for most uses that it should live on the heap.
+template <typename T>
+class TripleBuffer final {
+public:
+    TripleBuffer()
+        : m_slots()
+        , m_middle(1)
+        , m_back(0)
+        , m_front(2)
+    {
+    }
+
+    /// @brief Slot to fill with the next value. Writer only.
+    T& get_write()
+    {
+        return m_slots[m_back].value;
+    }
+
+    /// @brief Makes the filled slot the latest value. Writer only.
+    void publish()
+    {
+        uint8_t fresh = static_cast<uint8_t>(m_back | FRESH);
+        uint8_t middle = m_middle.exchange(fresh, std::memory_order_acq_rel);
+        m_back = static_cast<uint8_t>(middle & SLOT);
+    }
+
+    /// @brief Picks up the latest value, if one was published since the last
+    /// call. Reader only.
+    bool update()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0)
+            return false;
+        uint8_t middle = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = static_cast<uint8_t>(middle & SLOT);
+        return true;
+    }
+
+    /// @brief Value picked up last. Reader only.
+    const T& get_read() const
+    {
+        return m_slots[m_front].value;
+    }
+
+private:
+    static constexpr uint8_t SLOT = 0x03;
+    static constexpr uint8_t FRESH = 0x04;
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        T value;
+    };
+
+    std::array<Slot, 3> m_slots;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint8_t> m_middle;
+    alignas(CACHE_LINE_SIZE) uint8_t m_back;
+    alignas(CACHE_LINE_SIZE) uint8_t m_front;
+};
+} // namespace cbgb
+
+#endif // CBGB_TRIPLE_BUFFER_HPP
@@ -0,0 +1,233 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/format.h>
+#include <spdlog/logger.h>
+
+#include "cbgb/arena.hpp"
+#include "cbgb/cpu.hpp"
+#include "cbgb/gameboy.hpp"
+#include "cbgb/memory.hpp"
+#include "cbgb/vector_env.hpp"
+#include "cbgb/video.hpp"
+
+namespace cbgb {
+// Every chunk of machines is packed into an arena of its own, allocated on the
+// pinned worker that steps the chunk, as cocoboy-headless does for every run.
+// All machines start out from one shared power on snapshot that every reset
+// restores. Snapshots leave the PPU accuracy alone, so whatever the game
+// database picked for the first machine is handed on to the others as well.
+VectorEnv::VectorEnv(
+    spdlog::logger& logger,
+    size_t count,
+    const uint8_t* rom,
+    size_t size,
+    unsigned int threads
+)
+    : m_pool(threads, true, &logger)
+    , m_memories(std::min<size_t>(count, m_pool.size()))
+    , m_machines(count)
+    , m_initial(std::make_unique<Snapshot>())
+    , m_scalers()
+    , m_observation(Observation::FRAME)
+    , m_address(0)
+    , m_size(SCREEN_WIDTH * SCREEN_HEIGHT)
+    , m_reward()
+    , m_done()
+{
+    for_each_chunk([this, &logger](size_t chunk, size_t begin, size_t end) {
+        m_memories[chunk] = std::make_unique<ArenaMemory>(Arena::required<GameBoy>(end - begin));
+        Arena arena(m_memories[chunk]->data(), m_memories[chunk]->size());
+        for (size_t i = begin; i < end; ++i)
+            m_machines[i] = arena.create<GameBoy>(logger);
+    });
+    if (count == 0)
+        return;
+
+    m_machines.front()->load_rom(rom, size);
+    m_machines.front()->save_state(*m_initial);
+    PpuAccuracy accuracy = m_machines.front()->get_ppu().get_accuracy();
+    for_each_chunk([this, accuracy](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            m_machines[i]->get_ppu().set_accuracy(accuracy);
+            m_machines[i]->load_state(*m_initial);
+        }
+    });
+}
+
+void VectorEnv::observe_frame()
+{
+    m_scalers.clear();
+    m_observation = Observation::FRAME;
+    m_address = 0;
+    m_size = SCREEN_WIDTH * SCREEN_HEIGHT;
+}
+
+void VectorEnv::observe_memory(uint16_t address, size_t size)
+{
+    if (static_cast<size_t>(address) + size > sizeof(MemoryImage)) {
+        throw std::out_of_range(
+            fmt::format("Memory observation ${0:04X}+{1} exceeds address space", address, size)
+        );
+    }
+    m_scalers.clear();
+    m_observation = Observation::MEMORY;
+    m_address = address;
+    m_size = size;
+}
+
+void VectorEnv::observe_scaled(unsigned int width, unsigned int height, PixelFormat format)
+{
+    std::vector<Downscaler> scalers(m_machines.size(), Downscaler(width, height, format));
+    for (size_t i = 0; i < m_machines.size(); ++i)
+        scalers[i].scale_frame(m_machines[i]->get_frame().data());
+
+    m_scalers = std::move(scalers);
+    m_observation = Observation::SCALED;
+    m_address = 0;
+    m_size = static_cast<size_t>(width) * height;
+}
+
+void VectorEnv::set_reward(RewardFunction reward)
+{
+    m_reward = std::move(reward);
+}
+
+void VectorEnv::set_done(DoneFunction done)
+{
+    m_done = std::move(done);
+}
+
+void VectorEnv::reset(uint8_t* observations)
+{
+    for_each_chunk([this, observations](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            restart(i);
+            write_observation(i, observations);
+        }
+    });
+}
+
+// Rewards and dones are optional, either may be null.
+void VectorEnv::step(
+    const uint8_t* actions,
+    unsigned int frames,
+    uint8_t* observations,
+    float* rewards,
+    uint8_t* dones
+)
+{
+    for_each_chunk([=](size_t, size_t begin, size_t end) {
+        step_chunk(begin, end, actions, frames, observations, rewards, dones);
+    });
+}
+
+size_t VectorEnv::get_observation_size() const
+{
+    return m_size;
+}
+
+size_t VectorEnv::size() const
+{
+    return m_machines.size();
+}
+
+GameBoy& VectorEnv::get_machine(size_t index)
+{
+    return *m_machines[index];
+}
+
+void VectorEnv::step_chunk(
+    size_t begin,
+    size_t end,
+    const uint8_t* actions,
+    unsigned int frames,
+    uint8_t* observations,
+    float* rewards,
+    uint8_t* dones
+)
+{
+    for (size_t i = begin; i < end; ++i) {
+        GameBoy& machine = *m_machines[i];
+        machine.set_joypad(actions != nullptr ? actions[i] : 0);
+
+        bool halted = false;
+        try {
+            for (unsigned int frame = 0; frame < frames; ++frame) {
+                bool last = frame + 1 == frames;
+                if (last && !m_scalers.empty())
+                    machine.set_downscaler(&m_scalers[i]);
+                machine.set_render_skip(!last || m_observation == Observation::MEMORY);
+                machine.step_frame();
+            }
+        }
+        catch (const UndefinedOpcode&) {
+            halted = true;
+        }
+        machine.set_downscaler(nullptr);
+        machine.set_render_skip(false);
+
+        const MemoryImage& memory = machine.get_memory().get_image();
+        float reward = m_reward ? m_reward(i, memory) : 0.0F;
+        bool done = halted || (m_done && m_done(i, memory));
+        if (rewards != nullptr)
+            rewards[i] = reward;
+        if (dones != nullptr)
+            dones[i] = done ? 1 : 0;
+
+        if (done)
+            restart(i);
+        write_observation(i, observations);
+    }
+}
+
+void VectorEnv::restart(size_t index)
+{
+    m_machines[index]->load_state(*m_initial);
+    if (!m_scalers.empty())
+        m_scalers[index].scale_frame(m_initial->ppu.frame.data());
+}
+
+void VectorEnv::write_observation(size_t index, uint8_t* observations)
+{
+    if (observations == nullptr)
+        return;
+
+    uint8_t* output = observations + index * m_size;
+    GameBoy& machine = *m_machines[index];
+    switch (m_observation) {
+    case Observation::FRAME:
+        std::memcpy(output, machine.get_frame().data(), m_size);
+        break;
+    case Observation::MEMORY:
+        std::memcpy(output, machine.get_memory().get_image().data() + m_address, m_size);
+        break;
+    case Observation::SCALED:
+        std::memcpy(output, m_scalers[index].data(), m_size);
+        break;
+    }
+}
+
+void VectorEnv::for_each_chunk(
+    const std::function<void(size_t chunk, size_t begin, size_t end)>& task
+)
+{
+    size_t count = m_machines.size();
+    size_t chunks = std::min<size_t>(count, m_pool.size());
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        size_t begin = count * chunk / chunks;
+        size_t end = count * (chunk + 1) / chunks;
+        m_pool.submit([&task, chunk, begin, end] { task(chunk, begin, end); });
+    }
+    m_pool.wait();
+}
+} // namespace cbgb
@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Vectorized environment over many machines.
+//!
+//! Steps a fixed set of machines running the same ROM with one call, in the
+//! style of reinforcement learning vector environments. Every call takes one
+//! joypad mask per machine, and writes one observation per machine into a
+//! single contiguous caller owned array, laid out as `[machine][row][column]`
+//! for frame observations. Rewards and episode ends come from callbacks that
+//! read machine memory, so game specific logic stays out of the core.
+//!
+//! Machines are split into contiguous chunks, one per worker thread, so every
+//! worker writes to its own contiguous slice of the output arrays. Workers are
+//! pinned, and every chunk is packed into its own arena, allocated by the
+//! worker it is dealt to, so first touch keeps it on that worker's node.
+//!
+//! Only the last frame of a step is drawn, and scaled observations are
+//! produced while it is. Memory observations have no frame drawn at all.
+
+#ifndef CBGB_VECTOR_ENV_HPP
+#define CBGB_VECTOR_ENV_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <spdlog/logger.h>
+
+#include "cbgb/arena.hpp"
+#include "cbgb/gameboy.hpp"
+#include "cbgb/memory.hpp"
+#include "cbgb/thread_pool.hpp"
+#include "cbgb/video.hpp"
+
+namespace cbgb {
+enum class Observation {
+    FRAME,
+    MEMORY,
+    SCALED,
+};
+
+/// @brief Computes the reward of a machine after a step.
+///
+/// Called concurrently for different machines, which are told apart by index.
+using RewardFunction = std::function<float(size_t index, const MemoryImage& memory)>;
+
+/// @brief Decides whether the episode of a machine ended after a step.
+using DoneFunction = std::function<bool(size_t index, const MemoryImage& memory)>;
+
+/// @brief Thread pooled vector environment.
+///
+/// Machines whose episode ended, or that hit an undefined opcode, are reset to
+/// their power on state right away. The observation written for them is the
+/// first one of their next episode.
+class VectorEnv final {
+public:
+    VectorEnv(
+        spdlog::logger& logger,
+        size_t count,
+        const uint8_t* rom,
+        size_t size,
+        unsigned int threads = 0
+    );
+    void observe_frame();
+    void observe_memory(uint16_t address, size_t size);
+    void observe_scaled(unsigned int width, unsigned int height, PixelFormat format);
+    void set_reward(RewardFunction reward);
+    void set_done(DoneFunction done);
+    void reset(uint8_t* observations);
+    void step(
+        const uint8_t* actions,
+        unsigned int frames,
+        uint8_t* observations,
+        float* rewards,
+        uint8_t* dones
+    );
+    size_t get_observation_size() const;
+    size_t size() const;
+    GameBoy& get_machine(size_t index);
+
+private:
+    void step_chunk(
+        size_t begin,
+        size_t end,
+        const uint8_t* actions,
+        unsigned int frames,
+        uint8_t* observations,
+        float* rewards,
+        uint8_t* dones
+    );
+    void restart(size_t index);
+    void write_observation(size_t index, uint8_t* observations);
+    void for_each_chunk(
+        const std::function<void(size_t chunk, size_t begin, size_t end)>& task
+    );
+
+    ThreadPool m_pool;
+    std::vector<std::unique_ptr<ArenaMemory>> m_memories;
+    std::vector<ArenaPtr<GameBoy>> m_machines;
+    std::unique_ptr<Snapshot> m_initial;
+    std::vector<Downscaler> m_scalers;
+    Observation m_observation;
+    uint16_t m_address;
+    size_t m_size;
+    RewardFunction m_reward;
+    DoneFunction m_done;
+};
+} // namespace cbgb
+
+#endif // CBGB_VECTOR_ENV_HPP
@@ -0,0 +1,329 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CBGB_HAVE_SSE2 1
+#include <emmintrin.h>
+#else
+#define CBGB_HAVE_SSE2 0
+#endif
+
+#include <fmt/format.h>
+
+#include "cbgb/ppu.hpp"
+#include "cbgb/video.hpp"
+
+namespace cbgb {
+// Weights are Q8 fixed point, and every output pixel's weights add up to
+// exactly 256. A 16-bit accumulator then tops out at 255 * 256, which fits.
+constexpr unsigned int WEIGHT_ONE = 256;
+constexpr uint8_t GRAY_STEP = 85;
+
+// Walks every overlap between `count` source pixels and the `scaled` output
+// pixels they are squeezed into, calling back with output index, source index,
+// and Q8 weight. Cumulative rounding keeps the weights of every output pixel
+// summing to exactly WEIGHT_ONE.
+template <typename Callback>
+void for_each_overlap(unsigned int count, unsigned int scaled, Callback&& callback)
+{
+    for (unsigned int output = 0; output < scaled; ++output) {
+        unsigned int begin = output * count;
+        unsigned int end = begin + count;
+        unsigned int covered = 0;
+        unsigned int assigned = 0;
+        for (unsigned int source = begin / scaled; source * scaled < end; ++source) {
+            unsigned int overlap
+                = std::min((source + 1) * scaled, end) - std::max(source * scaled, begin);
+            covered += overlap;
+            unsigned int total = (covered * WEIGHT_ONE + count / 2) / count;
+            callback(output, source, static_cast<uint16_t>(total - assigned));
+            assigned = total;
+        }
+    }
+}
+
+Downscaler::Downscaler(unsigned int width, unsigned int height, PixelFormat format)
+    : m_width(width)
+    , m_height(height)
+    , m_format(format)
+    , m_lines(SCREEN_HEIGHT, LineWeights { { -1, -1 }, { 0, 0 }, -1, -1 })
+    , m_tap_start(width + 1, 0)
+    , m_taps()
+    , m_columns(width, 0)
+    , m_rows()
+    , m_output(static_cast<size_t>(width) * height, 0)
+{
+    if (width == 0 || height == 0 || width > SCREEN_WIDTH || height > SCREEN_HEIGHT) {
+        throw std::invalid_argument(fmt::format(
+            "Cannot downscale to {0}x{1}, must be within {2}x{3}",
+            width,
+            height,
+            SCREEN_WIDTH,
+            SCREEN_HEIGHT
+        ));
+    }
+
+    auto add_line = [this](unsigned int row, unsigned int line, uint16_t weight) {
+        LineWeights& entry = m_lines[line];
+        size_t slot = entry.rows[0] < 0 ? 0 : 1;
+        entry.rows[slot] = static_cast<int>(row);
+        entry.weights[slot] = weight;
+    };
+    for_each_overlap(SCREEN_HEIGHT, height, add_line);
+    // A row is finished by the last line touching it. When downscaling, no line
+    // can be the last one for both of the rows it touches.
+    for (unsigned int line = 0; line < SCREEN_HEIGHT; ++line) {
+        LineWeights& entry = m_lines[line];
+        for (int row : entry.rows) {
+            bool next = line + 1 < SCREEN_HEIGHT
+                && (m_lines[line + 1].rows[0] == row || m_lines[line + 1].rows[1] == row);
+            if (row >= 0 && !next)
+                entry.finished = row;
+        }
+    }
+
+    auto add_tap = [this](unsigned int column, unsigned int source, uint16_t weight) {
+        m_taps.push_back({ static_cast<uint16_t>(source), weight });
+        m_tap_start[column + 1] = static_cast<uint16_t>(m_taps.size());
+    };
+    for_each_overlap(SCREEN_WIDTH, width, add_tap);
+
+    for (unsigned int row = 0; row < height; ++row)
+        m_lines[(2 * row + 1) * SCREEN_HEIGHT / (2 * height)].sampled = static_cast<int>(row);
+    for (unsigned int column = 0; column < width; ++column)
+        m_columns[column] = static_cast<uint16_t>((2 * column + 1) * SCREEN_WIDTH / (2 * width));
+
+    for (auto& row : m_rows)
+        row.assign(SCREEN_WIDTH, 0);
+}
+
+// Blends one scanline of shades into a row accumulator as gray levels. A
+// scanline is a whole number of SSE2 registers wide, so there is no tail.
+static void accumulate_gray(const uint8_t* shades, uint16_t weight, uint16_t* row)
+{
+    size_t column = 0;
+#if CBGB_HAVE_SSE2
+    static_assert(SCREEN_WIDTH % 8 == 0, "Scanlines must fill whole SSE2 registers");
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_set1_epi16(3);
+    const __m128i white = _mm_set1_epi16(255);
+    const __m128i step = _mm_set1_epi16(GRAY_STEP);
+    const __m128i scale = _mm_set1_epi16(static_cast<short>(weight));
+    for (; column + 8 <= SCREEN_WIDTH; column += 8) {
+        __m128i shade = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(shades + column));
+        shade = _mm_and_si128(_mm_unpacklo_epi8(shade, zero), mask);
+        __m128i gray = _mm_sub_epi16(white, _mm_mullo_epi16(shade, step));
+        __m128i* target = reinterpret_cast<__m128i*>(row + column);
+        __m128i sum = _mm_add_epi16(_mm_loadu_si128(target), _mm_mullo_epi16(gray, scale));
+        _mm_storeu_si128(target, sum);
+    }
+#else
+    for (; column < SCREEN_WIDTH; ++column) {
+        unsigned int gray = 255U - GRAY_STEP * (shades[column] & 3U);
+        row[column] = static_cast<uint16_t>(row[column] + gray * weight);
+    }
+#endif
+}
+
+void Downscaler::push_line(unsigned int line, const uint8_t* shades)
+{
+    if (line >= SCREEN_HEIGHT)
+        return;
+
+    const LineWeights& entry = m_lines[line];
+    if (m_format == PixelFormat::SHADE) {
+        if (entry.sampled < 0)
+            return;
+        uint8_t* output = &m_output[static_cast<size_t>(entry.sampled) * m_width];
+        for (unsigned int column = 0; column < m_width; ++column)
+            output[column] = shades[m_columns[column]] & 3;
+        return;
+    }
+
+    // Full size grayscale has nothing to average.
+    if (m_width == SCREEN_WIDTH && m_height == SCREEN_HEIGHT) {
+        shades_to_gray(shades, &m_output[static_cast<size_t>(line) * m_width], SCREEN_WIDTH);
+        return;
+    }
+
+    if (line == 0) {
+        for (auto& row : m_rows)
+            std::fill(row.begin(), row.end(), 0);
+    }
+    for (size_t slot = 0; slot < entry.rows.size(); ++slot) {
+        if (entry.rows[slot] >= 0 && entry.weights[slot] != 0) {
+            auto row = static_cast<unsigned int>(entry.rows[slot]);
+            accumulate_gray(shades, entry.weights[slot], m_rows[row & 1].data());
+        }
+    }
+    if (entry.finished >= 0)
+        finish_row(static_cast<unsigned int>(entry.finished));
+}
+
+// Shades are expected as a whole frame, row by row.
+void Downscaler::scale_frame(const uint8_t* shades)
+{
+    for (unsigned int line = 0; line < SCREEN_HEIGHT; ++line)
+        push_line(line, shades + static_cast<size_t>(line) * SCREEN_WIDTH);
+}
+
+const uint8_t* Downscaler::data() const
+{
+    return m_output.data();
+}
+
+size_t Downscaler::size() const
+{
+    return m_output.size();
+}
+
+unsigned int Downscaler::get_width() const
+{
+    return m_width;
+}
+
+unsigned int Downscaler::get_height() const
+{
+    return m_height;
+}
+
+PixelFormat Downscaler::get_format() const
+{
+    return m_format;
+}
+
+// Horizontal pass. Runs once per output row rather than once per scanline, so
+// it stays scalar.
+void Downscaler::finish_row(unsigned int row)
+{
+    std::vector<uint16_t>& sums = m_rows[row & 1];
+    uint8_t* output = &m_output[static_cast<size_t>(row) * m_width];
+    for (unsigned int column = 0; column < m_width; ++column) {
+        uint32_t total = 0;
+        for (uint16_t tap = m_tap_start[column]; tap < m_tap_start[column + 1]; ++tap)
+            total += static_cast<uint32_t>(sums[m_taps[tap].column]) * m_taps[tap].weight;
+        output[column] = static_cast<uint8_t>((total + WEIGHT_ONE * WEIGHT_ONE / 2) >> 16);
+    }
+    std::fill(sums.begin(), sums.end(), 0);
+}
+
+// Low plane holds bit 0 and high plane bit 1 of every color, leftmost pixel in
+// bit 7. Each plane byte is broadcast over 8 lanes and tested against one bit
+// per lane, for two tile rows per 16-byte vector.
+void decode_tiles(const uint8_t* low, const uint8_t* high, size_t count, uint8_t* colors)
+{
+    size_t tile = 0;
+#if CBGB_HAVE_SSE2
+    const __m128i bits = _mm_set1_epi64x(0x0102040810204080);
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i two = _mm_set1_epi8(2);
+    for (; tile + 2 <= count; tile += 2) {
+        uint32_t packed = low[tile] | (low[tile + 1] << 8U) | (high[tile] << 16U)
+            | (static_cast<uint32_t>(high[tile + 1]) << 24U);
+        __m128i planes = _mm_cvtsi32_si128(static_cast<int>(packed));
+        planes = _mm_unpacklo_epi8(planes, planes);
+        planes = _mm_unpacklo_epi16(planes, planes);
+        __m128i low_bits = _mm_unpacklo_epi32(planes, planes);
+        __m128i high_bits = _mm_unpackhi_epi32(planes, planes);
+        low_bits = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(low_bits, bits), bits), one);
+        high_bits = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(high_bits, bits), bits), two);
+        __m128i* output = reinterpret_cast<__m128i*>(colors + tile * 8);
+        _mm_storeu_si128(output, _mm_or_si128(low_bits, high_bits));
+    }
+#endif
+    for (; tile < count; ++tile) {
+        for (unsigned int pixel = 0; pixel < 8; ++pixel) {
+            unsigned int shift = 7 - pixel;
+            unsigned int color = ((low[tile] >> shift) & 1U) | (((high[tile] >> shift) & 1U) << 1);
+            colors[tile * 8 + pixel] = static_cast<uint8_t>(color);
+        }
+    }
+}
+
+// Palettes hold the shade of color N in bits 2N and 2N+1. Without a byte
+// shuffle, each color is matched and selected separately.
+void apply_palette(const uint8_t* colors, uint8_t palette, uint8_t* shades, size_t count)
+{
+    size_t index = 0;
+#if CBGB_HAVE_SSE2
+    __m128i lookup[4];
+    for (unsigned int color = 0; color < 4; ++color)
+        lookup[color] = _mm_set1_epi8(static_cast<char>((palette >> (2 * color)) & 3));
+    for (; index + 16 <= count; index += 16) {
+        __m128i color = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colors + index));
+        __m128i shade = _mm_setzero_si128();
+        for (unsigned int match = 0; match < 4; ++match) {
+            __m128i hit = _mm_cmpeq_epi8(color, _mm_set1_epi8(static_cast<char>(match)));
+            shade = _mm_or_si128(shade, _mm_and_si128(hit, lookup[match]));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(shades + index), shade);
+    }
+#endif
+    for (; index < count; ++index)
+        shades[index] = static_cast<uint8_t>((palette >> (2 * (colors[index] & 3))) & 3);
+}
+
+// Shade 0 is white and shade 3 is black, in even steps.
+void shades_to_gray(const uint8_t* shades, uint8_t* gray, size_t count)
+{
+    size_t index = 0;
+#if CBGB_HAVE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_set1_epi8(3);
+    const __m128i white = _mm_set1_epi16(255);
+    const __m128i step = _mm_set1_epi16(GRAY_STEP);
+    for (; index + 16 <= count; index += 16) {
+        __m128i shade = _mm_loadu_si128(reinterpret_cast<const __m128i*>(shades + index));
+        shade = _mm_and_si128(shade, mask);
+        __m128i low = _mm_sub_epi16(white, _mm_mullo_epi16(_mm_unpacklo_epi8(shade, zero), step));
+        __m128i high = _mm_sub_epi16(white, _mm_mullo_epi16(_mm_unpackhi_epi8(shade, zero), step));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(gray + index), _mm_packus_epi16(low, high));
+    }
+#endif
+    for (; index < count; ++index)
+        gray[index] = static_cast<uint8_t>(255U - GRAY_STEP * (shades[index] & 3U));
+}
+
+// Widens 16 shades at a time to 32-bit lanes, and selects the color of each
+// the same way palettes are applied.
+void shades_to_argb(
+    const uint8_t* shades, const std::array<uint32_t, 4>& colors, uint32_t* pixels, size_t count
+)
+{
+    size_t index = 0;
+#if CBGB_HAVE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_set1_epi8(3);
+    __m128i lookup[4];
+    for (unsigned int shade = 0; shade < 4; ++shade)
+        lookup[shade] = _mm_set1_epi32(static_cast<int>(colors[shade]));
+    for (; index + 16 <= count; index += 16) {
+        __m128i shade = _mm_loadu_si128(reinterpret_cast<const __m128i*>(shades + index));
+        shade = _mm_and_si128(shade, mask);
+        __m128i low = _mm_unpacklo_epi8(shade, zero);
+        __m128i high = _mm_unpackhi_epi8(shade, zero);
+        __m128i quads[4] = { _mm_unpacklo_epi16(low, zero),
+                             _mm_unpackhi_epi16(low, zero),
+                             _mm_unpacklo_epi16(high, zero),
+                             _mm_unpackhi_epi16(high, zero) };
+        for (size_t quad = 0; quad < 4; ++quad) {
+            __m128i pixel = zero;
+            for (int match = 0; match < 4; ++match) {
+                __m128i hit = _mm_cmpeq_epi32(quads[quad], _mm_set1_epi32(match));
+                pixel = _mm_or_si128(pixel, _mm_and_si128(hit, lookup[match]));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + index + quad * 4), pixel);
+        }
+    }
+#endif
+    for (; index < count; ++index)
+        pixels[index] = colors[shades[index] & 3U];
+}
+} // namespace cbgb
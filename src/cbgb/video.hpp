@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Pixel conversion kernels.
+//!
+//! Tiles are stored as two bit planes per row of 8 pixels \[[1]\]. Decoding a
+//! row means spreading both plane bytes out over 8 pixels, which is done with
+//! SIMD masks and compares for two tile rows at a time instead of bit by bit.
+//!
+//! The PPU produces 2-bit shades, darkest being 3 \[[2]\]. Everything else a
+//! consumer might want, like grayscale, or a smaller frame for a neural
+//! network, is derived from those shades here, one scanline at a time, as the
+//! lines come out of the PPU. That way a full resolution copy of the frame in
+//! some wider pixel format never has to exist. Frontends likewise convert
+//! shades to 32-bit color straight into the memory of a streaming texture.
+//!
+//! [1]: https://gbdev.io/pandocs/Tile_Data.html
+//! [2]: https://gbdev.io/pandocs/Palettes.html
+
+#ifndef CBGB_VIDEO_HPP
+#define CBGB_VIDEO_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cbgb {
+enum class PixelFormat {
+    /// Shade index from 0 to 3, as the PPU outputs it.
+    SHADE,
+    /// Gray level from 0 to 255, white being 255.
+    GRAYSCALE,
+};
+
+/// @brief Streaming frame downscaler.
+///
+/// Takes scanlines of shades in order, and produces a smaller frame in the
+/// requested format. Grayscale output is area averaged: every scanline is
+/// converted and blended into at most two 16-bit row accumulators with SIMD
+/// multiply-adds, and a row is only reduced horizontally once all of its
+/// scanlines have arrived. Shade output cannot be averaged, so it is sampled
+/// at the nearest source pixel instead.
+///
+/// @invariant Output is never larger than the screen in either dimension.
+class Downscaler final {
+public:
+    Downscaler(unsigned int width, unsigned int height, PixelFormat format);
+    void push_line(unsigned int line, const uint8_t* shades);
+    void scale_frame(const uint8_t* shades);
+    const uint8_t* data() const;
+    size_t size() const;
+    unsigned int get_width() const;
+    unsigned int get_height() const;
+    PixelFormat get_format() const;
+
+private:
+    struct LineWeights {
+        std::array<int, 2> rows;
+        std::array<uint16_t, 2> weights;
+        int finished;
+        int sampled;
+    };
+
+    struct Tap {
+        uint16_t column;
+        uint16_t weight;
+    };
+
+    void finish_row(unsigned int row);
+
+    unsigned int m_width;
+    unsigned int m_height;
+    PixelFormat m_format;
+    std::vector<LineWeights> m_lines;
+    std::vector<uint16_t> m_tap_start;
+    std::vector<Tap> m_taps;
+    std::vector<uint16_t> m_columns;
+    std::array<std::vector<uint16_t>, 2> m_rows;
+    std::vector<uint8_t> m_output;
+};
+
+void decode_tiles(const uint8_t* low, const uint8_t* high, size_t count, uint8_t* colors);
+void apply_palette(const uint8_t* colors, uint8_t palette, uint8_t* shades, size_t count);
+void shades_to_gray(const uint8_t* shades, uint8_t* gray, size_t count);
+void shades_to_argb(
+    const uint8_t* shades, const std::array<uint32_t, 4>& colors, uint32_t* pixels, size_t count
+);
+} // namespace cbgb
+
+#endif // CBGB_VIDEO_HPP
@@ -0,0 +1,301 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "cbgb/cpu.hpp"
+#include "cbgb/memory.hpp"
+#include "cbgb/workload.hpp"
+
+namespace cbgb {
+// Where the prologue points the stack and the pointer pairs. Both bytes of
+// each are the same, and so are those of every address stored to directly,
+// which reads the same whichever byte of an immediate comes first.
+constexpr uint16_t WORKLOAD_SP = 0xDFDF;
+constexpr uint16_t WORKLOAD_BC = 0xC1C1;
+constexpr uint16_t WORKLOAD_DE = 0xC2C2;
+constexpr uint16_t WORKLOAD_HL = 0xC8C8;
+
+// Every HL+ or HL- moves H by one page at most. HL is pointed back at its
+// start after this many, which keeps it within 0xB800 to 0xD8FF, clear of the
+// code below and the stack above.
+constexpr unsigned int MAX_HL_DRIFT = 16;
+
+// Pushes outstanding at most, which keeps the stack within 8 bytes of its top.
+constexpr unsigned int MAX_STACK_DEPTH = 4;
+
+// Direct stores go to 0xC0C0 up to 0xDEDE in work RAM, or to high RAM.
+constexpr uint8_t WRAM_STORE_START = 0xC0;
+constexpr uint8_t WRAM_STORE_COUNT = 0x1F;
+constexpr uint8_t HIGH_STORE_START = 0x80;
+constexpr uint8_t HIGH_STORE_COUNT = 0x7F;
+
+// Room kept at the end of a program for the longest instruction, along with
+// a reload of the pair it goes through, and the pops that balance the stack.
+constexpr size_t END_RESERVE = MAX_STACK_DEPTH + 6;
+
+constexpr size_t PROLOGUE_SIZE = 12;
+constexpr uint16_t ROM_ENTRY = 0x0100;
+constexpr size_t ROM_SIZE = 0x8000;
+constexpr uint8_t LD_A_A = 0x7F;
+
+static bool is_stack(uint8_t opcode)
+{
+    return (opcode & 0xCB) == 0xC1;
+}
+
+static bool moves_hl(uint8_t opcode)
+{
+    return opcode == 0x22 || opcode == 0x2A || opcode == 0x32 || opcode == 0x3A;
+}
+
+static bool uses_hl(uint8_t opcode)
+{
+    if (moves_hl(opcode) || opcode == 0x34 || opcode == 0x35 || opcode == 0x36)
+        return true;
+    if ((opcode & 0xC0) == 0x40)
+        return (opcode & 0x07) == 6 || (opcode & 0x38) == 0x30;
+    return (opcode & 0xC0) == 0x80 && (opcode & 0x07) == 6;
+}
+
+static bool is_load(uint8_t opcode)
+{
+    switch (opcode) {
+    case 0x02:
+    case 0x0A:
+    case 0x12:
+    case 0x1A:
+    case 0xE0:
+    case 0xE2:
+    case 0xEA:
+    case 0xF0:
+    case 0xF2:
+    case 0xFA:
+        return true;
+    default:
+        return (opcode & 0xC0) == 0x40 || (opcode & 0xC7) == 0x06 || (opcode & 0xCF) == 0x01;
+    }
+}
+
+static WorkloadMix classify(uint8_t opcode)
+{
+    if (is_stack(opcode) || opcode == 0x08)
+        return WorkloadMix::STACK;
+    if (uses_hl(opcode))
+        return WorkloadMix::INDIRECT;
+    if (is_load(opcode) || opcode == 0xF8 || opcode == 0xF9)
+        return WorkloadMix::LOAD_STORE;
+    return WorkloadMix::ALU;
+}
+
+// Unsafe are opcodes that overwrite B, D, H, or SP, other than pops, after which
+// the pair is loaded again, and stores through C, whose port could be anywhere.
+static bool is_safe(uint8_t opcode)
+{
+    auto writes = [](unsigned int target) { return target == 0 || target == 2 || target == 4; };
+    unsigned int target = (opcode >> 3) & 0x07;
+    if ((opcode & 0xC0) == 0x40 && opcode != 0x76)
+        return !writes(target);
+    if ((opcode & 0xC7) == 0x06 || (opcode & 0xC6) == 0x04)
+        return !writes(target);
+    return (opcode & 0xCF) != 0x01 && opcode != 0xE2 && opcode != 0xF8 && opcode != 0xF9;
+}
+
+// Every opcode the generator can emit gets a weight, four times as much in all
+// for the chosen kind as for all the others together.
+OpcodeHistogram get_workload_histogram(WorkloadMix mix)
+{
+    uint32_t inside = 0;
+    uint32_t outside = 0;
+    for (unsigned int opcode = 0; opcode <= 0xFF; ++opcode) {
+        auto value = static_cast<uint8_t>(opcode);
+        if (get_opcode_length(value) == 0 || !is_safe(value))
+            continue;
+        if (classify(value) == mix)
+            ++inside;
+        else
+            ++outside;
+    }
+
+    OpcodeHistogram histogram = {};
+    for (unsigned int opcode = 0; opcode <= 0xFF; ++opcode) {
+        auto value = static_cast<uint8_t>(opcode);
+        if (get_opcode_length(value) == 0 || !is_safe(value))
+            continue;
+        histogram[opcode] = classify(value) == mix ? 4 * outside : inside;
+    }
+    return histogram;
+}
+
+WorkloadGenerator::WorkloadGenerator(const OpcodeHistogram& histogram, uint32_t seed)
+    : m_cumulative()
+    , m_random(seed)
+    , m_depth(0)
+    , m_drift(0)
+    , m_bc_known(false)
+    , m_de_known(false)
+    , m_hl_known(false)
+{
+    uint64_t total = 0;
+    for (size_t opcode = 0; opcode < histogram.size(); ++opcode) {
+        auto value = static_cast<uint8_t>(opcode);
+        if (get_opcode_length(value) != 0 && is_safe(value))
+            total += histogram[opcode];
+        m_cumulative[opcode] = total;
+    }
+    if (total == 0)
+        throw std::invalid_argument("Histogram has no opcode that can be generated");
+}
+
+// Fills exactly `size` bytes, starting with the prologue, and padding the end
+// with LD A, A. Pushes are all popped again by the end, so that programs can
+// be run one after another.
+std::vector<uint8_t> WorkloadGenerator::generate(size_t size)
+{
+    if (size < PROLOGUE_SIZE + END_RESERVE)
+        throw std::invalid_argument(fmt::format("Workload of {} bytes is too small", size));
+
+    std::vector<uint8_t> program = { 0x31, WORKLOAD_SP & 0xFF, WORKLOAD_SP >> 8 };
+    program.reserve(size);
+    m_depth = 0;
+    m_bc_known = false;
+    m_de_known = false;
+    m_hl_known = false;
+    reload(program, 0x01);
+    reload(program, 0x11);
+    reload(program, 0x21);
+    while (program.size() + END_RESERVE <= size)
+        emit(program, pick_opcode());
+    while (m_depth > 0)
+        emit_stack(program, 0xF1);
+    program.resize(size, LD_A_A);
+    return program;
+}
+
+// Takes up the whole 32 KiB of ROM from the entry point on, for
+// GameBoy::load_rom. The header is whatever code happens to land there.
+std::vector<uint8_t> WorkloadGenerator::generate_rom()
+{
+    std::vector<uint8_t> rom(ROM_ENTRY, LD_A_A);
+    std::vector<uint8_t> program = generate(ROM_SIZE - ROM_ENTRY);
+    rom.insert(rom.end(), program.begin(), program.end());
+    return rom;
+}
+
+// Programs only stay clear of their own code below video RAM.
+void WorkloadGenerator::load(MemoryBus& bus, uint16_t address, size_t size)
+{
+    if (static_cast<size_t>(address) + size > ROM_SIZE) {
+        throw std::invalid_argument(
+            fmt::format("Workload of {} bytes at {:04X} overlaps RAM", size, address)
+        );
+    }
+    std::vector<uint8_t> program = generate(size);
+    bus.load(address, program.data(), program.size());
+}
+
+// Reduces the state of the engine with a plain modulo, unlike the standard
+// distributions, whose output differs between standard libraries.
+uint8_t WorkloadGenerator::pick_opcode()
+{
+    uint64_t high = m_random();
+    uint64_t low = m_random();
+    uint64_t target = (high << 32 | low) % m_cumulative.back();
+    auto found = std::upper_bound(m_cumulative.begin(), m_cumulative.end(), target);
+    return static_cast<uint8_t>(found - m_cumulative.begin());
+}
+
+// A pair that was popped, or HL after enough HL+ and HL-, is loaded again
+// right before the next access through it.
+void WorkloadGenerator::emit(std::vector<uint8_t>& program, uint8_t opcode)
+{
+    if (is_stack(opcode)) {
+        emit_stack(program, opcode);
+        return;
+    }
+    if ((opcode == 0x02 || opcode == 0x0A) && !m_bc_known)
+        reload(program, 0x01);
+    if ((opcode == 0x12 || opcode == 0x1A) && !m_de_known)
+        reload(program, 0x11);
+    if (uses_hl(opcode) && (!m_hl_known || (moves_hl(opcode) && m_drift == MAX_HL_DRIFT)))
+        reload(program, 0x21);
+    if (moves_hl(opcode))
+        ++m_drift;
+
+    program.push_back(opcode);
+    emit_operands(program, opcode);
+}
+
+// Pushes and pops keep the stack balanced, whichever was drawn. A pop with
+// nothing pushed turns into a push, and a push with the stack full into a pop.
+// Popped pairs hold whatever was on the stack, so they count as unknown.
+void WorkloadGenerator::emit_stack(std::vector<uint8_t>& program, uint8_t opcode)
+{
+    bool push = (opcode & 0x04) != 0 ? m_depth < MAX_STACK_DEPTH : m_depth == 0;
+    if (push) {
+        program.push_back(static_cast<uint8_t>(opcode | 0x04));
+        ++m_depth;
+        return;
+    }
+
+    auto popped = static_cast<uint8_t>(opcode & ~0x04);
+    program.push_back(popped);
+    --m_depth;
+    if (popped == 0xC1)
+        m_bc_known = false;
+    else if (popped == 0xD1)
+        m_de_known = false;
+    else if (popped == 0xE1)
+        m_hl_known = false;
+}
+
+// Direct stores get addresses they can safely write to, every other operand
+// is random.
+void WorkloadGenerator::emit_operands(std::vector<uint8_t>& program, uint8_t opcode)
+{
+    switch (opcode) {
+    case 0x08:
+    case 0xEA: {
+        auto page = static_cast<uint8_t>(WRAM_STORE_START + m_random() % WRAM_STORE_COUNT);
+        program.insert(program.end(), { page, page });
+        return;
+    }
+    case 0xE0:
+        program.push_back(static_cast<uint8_t>(HIGH_STORE_START + m_random() % HIGH_STORE_COUNT));
+        return;
+    default:
+        for (unsigned int i = 1; i < get_opcode_length(opcode); ++i)
+            program.push_back(static_cast<uint8_t>(m_random()));
+        return;
+    }
+}
+
+// Points one of the pairs back where the prologue did, given its LD rr, nn.
+void WorkloadGenerator::reload(std::vector<uint8_t>& program, uint8_t opcode)
+{
+    uint16_t value = WORKLOAD_HL;
+    if (opcode == 0x01) {
+        value = WORKLOAD_BC;
+        m_bc_known = true;
+    }
+    else if (opcode == 0x11) {
+        value = WORKLOAD_DE;
+        m_de_known = true;
+    }
+    else {
+        m_hl_known = true;
+        m_drift = 0;
+    }
+    auto low = static_cast<uint8_t>(value);
+    auto high = static_cast<uint8_t>(value >> 8);
+    program.insert(program.end(), { opcode, low, high });
+}
+} // namespace cbgb
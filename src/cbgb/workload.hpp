@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Synthetic SM83 programs for benchmarks and stress tests.
+//!
+//! Draws random instructions by weight from an opcode histogram, either one of
+//! the preset mixes, or counts taken off a real game, which reproduces its
+//! instruction mix without shipping the game itself. Programs are plain
+//! straight-line code, since the CPU has no jumps yet.
+//!
+//! Whatever the mix, programs leave their own code alone, and never read an
+//! undefined opcode. A short prologue points the stack at the top of work RAM,
+//! and BC, DE, and HL at pages below it. Instructions that would overwrite B,
+//! D, H, or SP are never drawn, so that stores through those pairs stay in RAM.
+//! A pair is pointed back before the next access through it once a pop left it
+//! unknown, or HL+ and HL- might have moved it too far. Pushes and pops stay
+//! balanced, and direct stores only get addresses in RAM.
+
+#ifndef CBGB_WORKLOAD_HPP
+#define CBGB_WORKLOAD_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "cbgb/memory.hpp"
+
+namespace cbgb {
+/// @brief Relative weight of every opcode, indexed by opcode.
+using OpcodeHistogram = std::array<uint32_t, 256>;
+
+/// @brief Preset instruction mixes, with about 80% of instructions of one kind.
+enum class WorkloadMix : uint8_t {
+    /// Arithmetic and logic on registers and immediates.
+    ALU,
+    /// Loads between registers, immediates, and memory, other than through HL.
+    LOAD_STORE,
+    /// Loads, stores, and arithmetic through (HL).
+    INDIRECT,
+    /// Pushes and pops.
+    STACK,
+};
+
+OpcodeHistogram get_workload_histogram(WorkloadMix mix);
+
+/// @brief Generates valid SM83 programs from an opcode histogram.
+///
+/// The same seed and histogram give the same programs, in the same order, on
+/// any platform. Opcodes that are undefined, or that could not be emitted
+/// safely, keep no weight.
+class WorkloadGenerator final {
+public:
+    WorkloadGenerator(const OpcodeHistogram& histogram, uint32_t seed);
+    std::vector<uint8_t> generate(size_t size);
+    std::vector<uint8_t> generate_rom();
+    void load(MemoryBus& bus, uint16_t address, size_t size);
+
+private:
+    uint8_t pick_opcode();
+    void emit(std::vector<uint8_t>& program, uint8_t opcode);
+    void emit_stack(std::vector<uint8_t>& program, uint8_t opcode);
+    void emit_operands(std::vector<uint8_t>& program, uint8_t opcode);
+    void reload(std::vector<uint8_t>& program, uint8_t opcode);
+
+    std::array<uint64_t, 256> m_cumulative;
+    std::mt19937 m_random;
+    unsigned int m_depth;
+    unsigned int m_drift;
+    bool m_bc_known;
+    bool m_de_known;
+    bool m_hl_known;
+};
+} // namespace cbgb
+
+#endif // CBGB_WORKLOAD_HPP
@@ -0,0 +1,363 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cxxopts.hpp>
+#include <fmt/format.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+
+#include "cbgb/arena.hpp"
+#include "cbgb/gameboy.hpp"
+#include "cbgb/json.hpp"
+#include "cbgb/link.hpp"
+#include "cbgb/memory.hpp"
+#include "cbgb/ppu.hpp"
+#include "cbgb/thread_pool.hpp"
+#include "cocoboy/config.hpp"
+
+struct RunConfig {
+    uint64_t frames;
+    uint64_t mcycles;
+    bool random_input;
+    bool pixel_fifo;
+    bool no_render;
+    std::string link_path;
+    cbgb::LinkRole link_role;
+};
+
+struct RunResult {
+    std::string rom;
+    uint64_t seed;
+    uint64_t frames;
+    uint64_t mcycles;
+    uint64_t frame_hash;
+    double seconds;
+    std::string serial;
+    std::string error;
+};
+
+// The seed stands in for the random contents work RAM and high RAM hold at
+// power on, and optionally drives a random button sequence as well.
+cbgb::ArenaPtr<cbgb::GameBoy> new_machine(
+    cbgb::Arena& arena,
+    spdlog::logger& logger,
+    const std::vector<uint8_t>& rom,
+    const RunConfig& config,
+    std::mt19937_64& random
+)
+{
+    cbgb::ArenaPtr<cbgb::GameBoy> gameboy = arena.create<cbgb::GameBoy>(logger);
+    if (config.pixel_fifo)
+        gameboy->get_ppu().set_accuracy(cbgb::PpuAccuracy::PIXEL_FIFO);
+    gameboy->load_rom(rom.data(), rom.size());
+
+    std::vector<uint8_t> noise(0x2000);
+    for (uint8_t& byte : noise)
+        byte = static_cast<uint8_t>(random());
+    gameboy->get_memory().load(0xC000, noise.data(), noise.size());
+    gameboy->get_memory().load(0xFF80, noise.data(), 0x7F);
+    return gameboy;
+}
+
+void collect_result(cbgb::GameBoy& gameboy, double seconds, RunResult& result)
+{
+    result.frames = gameboy.get_frame_count();
+    result.mcycles = gameboy.get_mcycle_count();
+    result.frame_hash = cbgb::hash_frame(gameboy.get_frame());
+    result.seconds = seconds;
+    result.serial = gameboy.get_serial().get_output();
+}
+
+// Each run lives in its own arena, allocated on the worker that executes it so
+// that its memory stays local to the worker's core.
+void run_rom(
+    spdlog::logger& logger,
+    const std::vector<uint8_t>& rom,
+    const RunConfig& config,
+    RunResult& result
+)
+{
+    cbgb::ArenaMemory memory(cbgb::Arena::required<cbgb::GameBoy>());
+    cbgb::Arena arena(memory.data(), memory.size());
+    std::mt19937_64 random(result.seed);
+    cbgb::ArenaPtr<cbgb::GameBoy> gameboy = new_machine(arena, logger, rom, config, random);
+
+    // Runs that only look at memory and serial output need no pixels, except
+    // for those of the last frame that goes into the frame hash. Runs linked
+    // to another process go window by window, and always by frames.
+    auto start = std::chrono::steady_clock::now();
+    try {
+        if (!config.link_path.empty()) {
+            cbgb::LinkSocket link(*gameboy, config.link_path, config.link_role);
+            link.step_frames(config.frames);
+        }
+        else if (config.mcycles != 0) {
+            gameboy->set_render_skip(config.no_render);
+            uint64_t frame = gameboy->get_frame_count();
+            if (config.random_input)
+                gameboy->set_joypad(static_cast<uint8_t>(random()));
+            while (gameboy->get_mcycle_count() < config.mcycles) {
+                gameboy->step();
+                if (config.random_input && gameboy->get_frame_count() != frame) {
+                    frame = gameboy->get_frame_count();
+                    gameboy->set_joypad(static_cast<uint8_t>(random()));
+                }
+            }
+        }
+        else {
+            for (uint64_t i = 0; i < config.frames; ++i) {
+                if (config.random_input)
+                    gameboy->set_joypad(static_cast<uint8_t>(random()));
+                gameboy->set_render_skip(config.no_render && i + 1 < config.frames);
+                gameboy->step_frame();
+            }
+        }
+    }
+    catch (const std::exception& error) {
+        result.error = error.what();
+    }
+    auto stop = std::chrono::steady_clock::now();
+    collect_result(*gameboy, std::chrono::duration<double>(stop - start).count(), result);
+}
+
+// Linked machines only stop between windows, which end partway into a frame.
+// A frame gets its buttons once the window it starts in is over, and drawing
+// comes back on a frame early, so that the last frame is drawn whole.
+void start_linked_frame(
+    cbgb::GameBoy& gameboy,
+    const RunConfig& config,
+    uint64_t end,
+    std::mt19937_64& random
+)
+{
+    if (config.random_input)
+        gameboy.set_joypad(static_cast<uint8_t>(random()));
+    gameboy.set_render_skip(config.no_render && gameboy.get_frame_count() + 2 < end);
+}
+
+// Both sides of a pair share one arena and one seed, and are linked in
+// process for as many frames as a single run would take.
+void run_pair(
+    spdlog::logger& logger,
+    const std::vector<uint8_t>& left_rom,
+    const std::vector<uint8_t>& right_rom,
+    const RunConfig& config,
+    RunResult& left_result,
+    RunResult& right_result
+)
+{
+    cbgb::ArenaMemory memory(cbgb::Arena::required<cbgb::GameBoy>(2));
+    cbgb::Arena arena(memory.data(), memory.size());
+    std::mt19937_64 random(left_result.seed);
+    cbgb::ArenaPtr<cbgb::GameBoy> left = new_machine(arena, logger, left_rom, config, random);
+    cbgb::ArenaPtr<cbgb::GameBoy> right = new_machine(arena, logger, right_rom, config, random);
+
+    auto start = std::chrono::steady_clock::now();
+    try {
+        uint64_t left_end = left->get_frame_count() + config.frames;
+        uint64_t right_end = right->get_frame_count() + config.frames;
+        cbgb::LinkCable cable(*left, *right);
+        start_linked_frame(*left, config, left_end, random);
+        start_linked_frame(*right, config, right_end, random);
+        while (left->get_frame_count() < left_end || right->get_frame_count() < right_end) {
+            uint64_t left_frame = left->get_frame_count();
+            uint64_t right_frame = right->get_frame_count();
+            cable.step_window();
+            if (left->get_frame_count() != left_frame)
+                start_linked_frame(*left, config, left_end, random);
+            if (right->get_frame_count() != right_frame)
+                start_linked_frame(*right, config, right_end, random);
+        }
+    }
+    catch (const std::exception& error) {
+        left_result.error = error.what();
+        right_result.error = error.what();
+    }
+    auto stop = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    collect_result(*left, seconds, left_result);
+    collect_result(*right, seconds, right_result);
+}
+
+int main(int argc, char** argv)
+try {
+    std::unique_ptr<cxxopts::Options> parser
+        = std::make_unique<cxxopts::Options>(argv[0], "- headless batch runner");
+    bool version = false;
+    std::vector<std::string> rom_paths;
+    RunConfig config = { 0, 0, false, false, false, "", cbgb::LinkRole::LISTEN };
+    uint64_t seeds = 1;
+    bool link = false;
+    std::string listen_path;
+    std::string connect_path;
+    unsigned int jobs = 0;
+    bool pin = false;
+    std::string output_path;
+    constexpr size_t max_width = 90;
+    auto& options = *parser;
+    options.set_width(max_width).set_tab_expansion().add_options()(
+        "v,version", "version info", cxxopts::value<bool>(version)
+    )(
+        "f,frames",
+        "frames to run per ROM",
+        cxxopts::value<uint64_t>(config.frames)->default_value("600")
+    )(
+        "c,cycles",
+        "M-cycles to run per ROM, overrides --frames",
+        cxxopts::value<uint64_t>(config.mcycles)->default_value("0")
+    )(
+        "s,seeds",
+        "runs per ROM, each with its own seed",
+        cxxopts::value<uint64_t>(seeds)->default_value("1")
+    )(
+        "random-input",
+        "press random buttons every frame",
+        cxxopts::value<bool>(config.random_input)
+    )(
+        "pixel-fifo",
+        "draw dot by dot, for mid-line raster effects",
+        cxxopts::value<bool>(config.pixel_fifo)
+    )(
+        "no-render",
+        "draw only the last frame, or none with --cycles",
+        cxxopts::value<bool>(config.no_render)
+    )(
+        "link",
+        "run ROMs in linked pairs, the first with the second and so on",
+        cxxopts::value<bool>(link)
+    )(
+        "link-listen",
+        "link the run to another process that connects to this socket",
+        cxxopts::value<std::string>(listen_path)
+    )(
+        "link-connect",
+        "link the run to another process listening on this socket",
+        cxxopts::value<std::string>(connect_path)
+    )(
+        "j,jobs",
+        "worker threads, 0 for one per core",
+        cxxopts::value<unsigned int>(jobs)->default_value("0")
+    )(
+        "pin", "pin each worker thread to its own core", cxxopts::value<bool>(pin)
+    )(
+        "o,output",
+        "write results to file instead of stdout",
+        cxxopts::value<std::string>(output_path)
+    )("roms", "ROMs to run", cxxopts::value<std::vector<std::string>>(rom_paths));
+    options.parse_positional({ "roms" });
+    options.positional_help("ROM...");
+    auto result = options.parse(argc, argv);
+
+    if (result.count("version") != 0U) {
+        fmt::print("{}\n", cocoboy::PROGRAM_VERSION);
+        return 0;
+    }
+
+    if (rom_paths.empty()) {
+        fmt::print("{}\n", options.help());
+        return 1;
+    }
+
+    std::shared_ptr<spdlog::logger> logger = spdlog::stderr_color_mt("cbgb");
+    logger->set_level(spdlog::level::warn);
+
+    std::vector<std::vector<uint8_t>> roms;
+    for (const std::string& path : rom_paths)
+        roms.push_back(cbgb::read_rom(path));
+
+    if (!listen_path.empty() || !connect_path.empty()) {
+        bool both = !listen_path.empty() && !connect_path.empty();
+        if (roms.size() != 1 || seeds != 1 || link || both)
+            throw std::invalid_argument("Linking to another process takes one ROM and one seed");
+        if (config.mcycles != 0 || config.random_input || config.no_render) {
+            throw std::invalid_argument(
+                "Linking to another process runs by frames, with no input, drawing every frame"
+            );
+        }
+        config.link_path = listen_path.empty() ? connect_path : listen_path;
+        config.link_role = listen_path.empty() ? cbgb::LinkRole::CONNECT : cbgb::LinkRole::LISTEN;
+    }
+    if (link && roms.size() % 2 != 0)
+        throw std::invalid_argument("Linked pairs need an even number of ROMs");
+    if (link && config.mcycles != 0)
+        throw std::invalid_argument("Linked pairs run by frames, not by M-cycles");
+
+    std::vector<RunResult> results(roms.size() * seeds);
+    for (size_t i = 0; i < roms.size(); ++i) {
+        for (uint64_t seed = 0; seed < seeds; ++seed) {
+            results[i * seeds + seed].rom = rom_paths[i];
+            results[i * seeds + seed].seed = seed;
+        }
+    }
+
+    cbgb::ThreadPool pool(jobs, pin, logger.get());
+    for (size_t i = 0; i < roms.size(); i += link ? 2 : 1) {
+        for (uint64_t seed = 0; seed < seeds; ++seed) {
+            RunResult& run = results[i * seeds + seed];
+            const std::vector<uint8_t>& rom = roms[i];
+            if (!link) {
+                pool.submit([&logger, &rom, &config, &run] { run_rom(*logger, rom, config, run); });
+                continue;
+            }
+
+            RunResult& partner = results[(i + 1) * seeds + seed];
+            const std::vector<uint8_t>& partner_rom = roms[i + 1];
+            pool.submit([&logger, &rom, &partner_rom, &config, &run, &partner] {
+                run_pair(*logger, rom, partner_rom, config, run, partner);
+            });
+        }
+    }
+    pool.wait();
+
+    std::FILE* output = stdout;
+    if (!output_path.empty()) {
+        output = std::fopen(output_path.c_str(), "w");
+        if (output == nullptr)
+            throw std::runtime_error(fmt::format("Cannot open output '{}'", output_path));
+    }
+
+    for (const RunResult& run : results) {
+        double mcycles_per_second
+            = run.seconds > 0.0 ? static_cast<double>(run.mcycles) / run.seconds : 0.0;
+        fmt::print(
+            output,
+            "{{\"rom\":\"{}\",\"seed\":{},\"frames\":{},\"mcycles\":{},\"frame_hash\":\"{:016x}\","
+            "\"mcycles_per_second\":{:.0f},\"serial\":\"{}\",\"error\":\"{}\"}}\n",
+            cbgb::escape_json(run.rom),
+            run.seed,
+            run.frames,
+            run.mcycles,
+            run.frame_hash,
+            mcycles_per_second,
+            cbgb::escape_json(run.serial),
+            cbgb::escape_json(run.error)
+        );
+    }
+
+    if (output != stdout)
+        std::fclose(output);
+
+    return 0;
+}
+catch (const spdlog::spdlog_ex& error) {
+    fmt::print("{}\n", error.what());
+    return 1;
+}
+catch (const cxxopts::exceptions::exception& error) {
+    fmt::print("{}\n", error.what());
+    return 1;
+}
+catch (const std::exception& error) {
+    fmt::print("{}\n", error.what());
+    return 1;
+}
@@ -0,0 +1,288 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include <spdlog/logger.h>
+
+#include "cbgb/apu.hpp"
+#include "cbgb/cpu.hpp"
+#include "cbgb/gameboy.hpp"
+#include "cbgb/pacing.hpp"
+#include "cbgb/ppu.hpp"
+#include "cbgb/trace.hpp"
+#include "cocoboy/emulation_thread.hpp"
+
+namespace cocoboy {
+// The GameBoy refreshes every 70224 dots of its 4 MiHz clock, at about 59.73
+// frames per second.
+constexpr std::chrono::nanoseconds FRAME_PERIOD(
+    static_cast<int64_t>(cbgb::DOTS_PER_LINE) * cbgb::LINES_PER_FRAME * 1000000000 / 4194304
+);
+
+// A frame comes to about 800 samples at 48 kHz.
+constexpr size_t AUDIO_CHUNK = 1024;
+
+// Fill of the audio ring right after a frame's samples went in, which is one
+// frame plus about 6 ms of margin against the jitter of the host. Rate control
+// stretches audio by up to half a percent, in proportion to how far the fill
+// is off target.
+constexpr size_t AUDIO_TARGET = 1100;
+constexpr double MAX_RATE_ADJUSTMENT = 0.005;
+
+// Emulating at the display rate instead of the GameBoy's own plays back that
+// much faster, so fewer samples per emulated second come out at the same pitch.
+static double get_sample_rate(double display_rate)
+{
+    double speed = display_rate > 0.0 ? display_rate / REFRESH_RATE : 1.0;
+    return cbgb::APU_SAMPLE_RATE / speed;
+}
+
+EmulationThread::EmulationThread(
+    spdlog::logger& logger,
+    std::unique_ptr<cbgb::GameBoy> gameboy,
+    unsigned int run_ahead,
+    double display_rate
+)
+    : m_logger(logger)
+    , m_gameboy(std::move(gameboy))
+    , m_run_ahead(run_ahead)
+    , m_frames(std::make_unique<cbgb::TripleBuffer<EmulatedFrame>>())
+    , m_tiles(std::make_unique<cbgb::TripleBuffer<cbgb::TileCache>>())
+    , m_tile_generation(~uint64_t(0))
+    , m_commands()
+    , m_audio()
+    , m_timings()
+    , m_pacer(FRAME_PERIOD)
+    , m_meter()
+    , m_speed()
+    , m_sample_rate(get_sample_rate(display_rate))
+    , m_vsync(display_rate > 0.0)
+    , m_multiplier(1)
+    , m_mutex()
+    , m_condition()
+    , m_ticks(0)
+    , m_published(0)
+    , m_stop(false)
+    , m_thread(&EmulationThread::run, this)
+{
+}
+
+EmulationThread::~EmulationThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+}
+
+// Fails if the emulation thread fell too far behind to take more, in which
+// case the caller tries again later.
+bool EmulationThread::send(const Command& command)
+{
+    return m_commands.push(command);
+}
+
+// Picks up the latest frame, returns true if there was a new one.
+bool EmulationThread::update()
+{
+    return m_frames->update();
+}
+
+const EmulatedFrame& EmulationThread::get_frame() const
+{
+    return m_frames->get_read();
+}
+
+// Picks up the latest tiles, returns true if they changed since last time.
+bool EmulationThread::update_tiles()
+{
+    return m_tiles->update();
+}
+
+const cbgb::TileCache& EmulationThread::get_tiles() const
+{
+    return m_tiles->get_read();
+}
+
+// Takes up to `count` samples, oldest first. Meant for the audio device's
+// thread, the one consumer of the ring.
+size_t EmulationThread::read_audio(StereoSample* samples, size_t count)
+{
+    return m_audio.pop(samples, count);
+}
+
+// Takes up to `count` timings, oldest first. Timings of frames the frontend
+// did not get around to reading are dropped, like samples.
+size_t EmulationThread::read_timings(FrameTiming* timings, size_t count)
+{
+    return m_timings.pop(timings, count);
+}
+
+// Asks for the next frame when locked to the display, does nothing otherwise.
+void EmulationThread::tick()
+{
+    if (!m_vsync)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_ticks;
+    }
+    m_condition.notify_all();
+}
+
+// Waits for the frame asked for by the last tick, so that it can be presented
+// in the same refresh. Gives up after the timeout, rather than missing vsync.
+bool EmulationThread::wait_frame(std::chrono::microseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_condition.wait_for(lock, timeout, [this] {
+        return m_published >= m_ticks || m_stop;
+    });
+}
+
+// Latest speed measured, which is updated about twice a second.
+cbgb::EmulationSpeed EmulationThread::get_speed()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_speed;
+}
+
+// After an undefined opcode, the last frame stays up until the thread stops.
+//
+// Fast forward does not wait for the display. It keeps the frame count level
+// with the ticks instead, so that the frontend never waits for a frame, and
+// the next tick after fast forward asks for a fresh one.
+void EmulationThread::run()
+{
+    CBGB_TRACE_THREAD("Emulation");
+    bool halted = false;
+    uint64_t frames = 0;
+    while (!m_stop) {
+        bool locked = m_vsync && m_multiplier == 1;
+        if (locked && !wait_tick(frames))
+            break;
+        apply_commands();
+        if (!halted) {
+            try {
+                auto start = std::chrono::steady_clock::now();
+                publish_frame(m_run_ahead.step_frame(*m_gameboy));
+                push_audio();
+                auto end = std::chrono::steady_clock::now();
+                m_timings.push({ m_gameboy->get_frame_count(), end - start });
+                measure_speed(end);
+            }
+            catch (const cbgb::UndefinedOpcode& error) {
+                m_logger.error("Emulation halted: {}", error.what());
+                halted = true;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            frames = m_vsync && m_multiplier != 1 ? m_ticks : frames + 1;
+            m_published = frames;
+        }
+        m_condition.notify_all();
+        if (!locked)
+            m_pacer.wait();
+    }
+}
+
+// Waits for the frontend to ask for the frame after the given number of them,
+// or returns false once the thread is to stop. Ticks missed past
+// cbgb::MAX_LAG_FRAMES are dropped instead of caught up on.
+bool EmulationThread::wait_tick(uint64_t& frames)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this, frames] { return m_ticks > frames || m_stop; });
+    if (m_ticks - frames > cbgb::MAX_LAG_FRAMES)
+        frames = m_ticks - 1;
+    return !m_stop;
+}
+
+// Applies everything the frontend sent since the last frame, in order.
+void EmulationThread::apply_commands()
+{
+    Command command = {};
+    while (m_commands.pop(command)) {
+        switch (command.kind) {
+        case CommandKind::JOYPAD:
+            m_gameboy->set_joypad(command.value);
+            break;
+        case CommandKind::RUN_AHEAD:
+            m_run_ahead.set_frames(command.value);
+            break;
+        case CommandKind::SPEED:
+            m_multiplier = command.value;
+            m_pacer.set_speed(command.value);
+            m_meter.reset();
+            break;
+        }
+    }
+}
+
+// The frame goes straight from the PPU, or run-ahead, into its slot. Tiles
+// are only copied out when the PPU decoded any that changed, which most frames
+// it does not.
+void EmulationThread::publish_frame(const cbgb::FrameBuffer& shown)
+{
+    EmulatedFrame& frame = m_frames->get_write();
+    frame.frame = shown;
+    frame.number = m_gameboy->get_frame_count();
+    m_frames->publish();
+
+    const cbgb::TileCache& tiles = m_gameboy->get_ppu().get_tiles();
+    if (tiles.get_generation() != m_tile_generation) {
+        m_tile_generation = tiles.get_generation();
+        m_tiles->get_write() = tiles;
+        m_tiles->publish();
+    }
+}
+
+// Samples the audio device has no room for are dropped, rather than holding up
+// emulation. So are all samples of fast forward, which would only come out
+// garbled at any rate that keeps up.
+void EmulationThread::push_audio()
+{
+    cbgb::Apu& apu = m_gameboy->get_apu();
+    std::array<int16_t, AUDIO_CHUNK * 2> interleaved = {};
+    std::array<StereoSample, AUDIO_CHUNK> samples = {};
+    size_t count = 0;
+    do {
+        count = apu.read_samples(interleaved.data(), AUDIO_CHUNK);
+        if (m_multiplier != 1)
+            continue;
+        for (size_t i = 0; i < count; ++i)
+            samples[i] = { interleaved[i * 2], interleaved[i * 2 + 1] };
+        m_audio.push(samples.data(), count);
+    } while (count == AUDIO_CHUNK);
+
+    double target = static_cast<double>(AUDIO_TARGET);
+    double error = std::clamp((target - static_cast<double>(m_audio.size())) / target, -1.0, 1.0);
+    double rate = m_sample_rate * (1.0 + MAX_RATE_ADJUSTMENT * error);
+    apu.set_sample_rate(static_cast<uint32_t>(std::lround(rate)));
+}
+
+// Instructions count every frame run-ahead emulated, emulated time only the
+// frames committed, so MIPS tell how hard the host works, and the percentage
+// how fast the game runs.
+void EmulationThread::measure_speed(std::chrono::steady_clock::time_point now)
+{
+    uint64_t mcycles = m_gameboy->get_mcycle_count();
+    if (!m_meter.add_frame(now, mcycles, m_gameboy->get_instruction_count()))
+        return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_speed = m_meter.get_speed();
+}
+} // namespace cocoboy
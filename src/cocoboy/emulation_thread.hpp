@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Emulation on a thread of its own.
+//!
+//! The frontend thread handles SDL events, ImGui, and presenting, any of which
+//! can take longer than a frame now and then, vsync included. Emulation runs
+//! on a dedicated thread instead, paced by the refresh rate of the GameBoy
+//! itself. Completed frames come back through a triple buffer, and decoded
+//! tiles through another one whenever any of them changed. Input and settings
+//! go the other way through a single producer, single consumer queue, so
+//! neither thread ever waits on the other. Samples go to the audio device
+//! through a ring buffer of their own, which the device's thread drains.
+//!
+//! Emulation either paces itself, or locks to the display when its refresh
+//! rate is close enough to that of the GameBoy. In the latter case the
+//! frontend asks for every frame right before presenting it, which keeps video
+//! latency under a frame. Either way, the host's audio clock never quite
+//! agrees with the emulated one, so dynamic rate control stretches the output
+//! by a fraction of a percent to keep the audio ring at a small, steady fill.
+//!
+//! Fast forward runs at a multiple of the normal rate, or as fast as the host
+//! can, ignoring the display either way. Audio is dropped meanwhile. How fast
+//! emulation actually runs is measured all the time, and read back by the
+//! frontend, along with how long every frame took to emulate.
+
+#ifndef COCOBOY_EMULATION_THREAD_HPP
+#define COCOBOY_EMULATION_THREAD_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <spdlog/logger.h>
+
+#include "cbgb/gameboy.hpp"
+#include "cbgb/pacing.hpp"
+#include "cbgb/ppu.hpp"
+#include "cbgb/run_ahead.hpp"
+#include "cbgb/spsc_queue.hpp"
+#include "cbgb/tile_cache.hpp"
+#include "cbgb/triple_buffer.hpp"
+
+namespace cocoboy {
+/// @brief Frames per second the GameBoy displays, about 59.73.
+inline constexpr double REFRESH_RATE
+    = 4194304.0 / (cbgb::DOTS_PER_LINE * cbgb::LINES_PER_FRAME);
+
+/// @brief Everything the frontend shows of one emulated frame, other than tiles.
+struct EmulatedFrame {
+    cbgb::FrameBuffer frame;
+    uint64_t number;
+};
+
+enum class CommandKind : uint8_t {
+    JOYPAD,
+    RUN_AHEAD,
+    /// Multiple of the normal speed, zero for uncapped.
+    SPEED,
+};
+
+/// @brief Left and right sample of one point in time.
+using StereoSample = std::array<int16_t, 2>;
+
+/// @brief How long the emulation thread spent on one frame, run-ahead included.
+struct FrameTiming {
+    uint64_t number;
+    std::chrono::nanoseconds emulation;
+};
+
+/// @brief Message from the frontend to the emulation thread.
+struct Command {
+    CommandKind kind;
+    uint8_t value;
+};
+
+/// @brief Owns a machine, and runs it on a thread of its own.
+///
+/// A display rate of zero has the thread pace itself. Otherwise it emulates
+/// one frame per tick of the frontend, which is expected to come at that rate.
+class EmulationThread final {
+public:
+    EmulationThread(
+        spdlog::logger& logger,
+        std::unique_ptr<cbgb::GameBoy> gameboy,
+        unsigned int run_ahead,
+        double display_rate = 0.0
+    );
+    ~EmulationThread();
+    EmulationThread(const EmulationThread&) = delete;
+    EmulationThread& operator=(const EmulationThread&) = delete;
+    bool send(const Command& command);
+    bool update();
+    const EmulatedFrame& get_frame() const;
+    bool update_tiles();
+    const cbgb::TileCache& get_tiles() const;
+    size_t read_audio(StereoSample* samples, size_t count);
+    size_t read_timings(FrameTiming* timings, size_t count);
+    void tick();
+    bool wait_frame(std::chrono::microseconds timeout);
+    cbgb::EmulationSpeed get_speed();
+
+private:
+    void run();
+    bool wait_tick(uint64_t& frames);
+    void apply_commands();
+    void publish_frame(const cbgb::FrameBuffer& shown);
+    void push_audio();
+    void measure_speed(std::chrono::steady_clock::time_point now);
+
+    spdlog::logger& m_logger;
+    std::unique_ptr<cbgb::GameBoy> m_gameboy;
+    cbgb::RunAhead m_run_ahead;
+    std::unique_ptr<cbgb::TripleBuffer<EmulatedFrame>> m_frames;
+    std::unique_ptr<cbgb::TripleBuffer<cbgb::TileCache>> m_tiles;
+    uint64_t m_tile_generation;
+    cbgb::SpscQueue<Command, 64> m_commands;
+    cbgb::SpscQueue<StereoSample, 8192> m_audio;
+    cbgb::SpscQueue<FrameTiming, 256> m_timings;
+    cbgb::FramePacer m_pacer;
+    cbgb::SpeedMeter m_meter;
+    cbgb::EmulationSpeed m_speed;
+    double m_sample_rate;
+    bool m_vsync;
+    unsigned int m_multiplier;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    uint64_t m_ticks;
+    uint64_t m_published;
+    std::atomic<bool> m_stop;
+    std::thread m_thread;
+};
+} // namespace cocoboy
+
+#endif // COCOBOY_EMULATION_THREAD_HPP
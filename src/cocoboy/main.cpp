@@ -1,8 +1,19 @@
 // SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
 // SPDX-License-Identifier: MIT
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <exception>
+#include <fstream>
 #include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <SDL3/SDL.h>
 #include <cxxopts.hpp>
@@ -12,18 +23,291 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
+#include "cbgb/apu.hpp"
+#include "cbgb/gameboy.hpp"
+#include "cbgb/memory.hpp"
+#include "cbgb/pacing.hpp"
+#include "cbgb/ppu.hpp"
+#include "cbgb/tile_cache.hpp"
+#include "cbgb/trace.hpp"
+#include "cbgb/video.hpp"
 #include "cocoboy/config.hpp"
+#include "cocoboy/emulation_thread.hpp"
+
+struct KeyBinding {
+    SDL_Scancode key;
+    cbgb::JoypadButton button;
+};
+
+constexpr std::array<KeyBinding, 8> key_bindings = {
+    KeyBinding { SDL_SCANCODE_RIGHT, cbgb::JOYPAD_RIGHT },
+    KeyBinding { SDL_SCANCODE_LEFT, cbgb::JOYPAD_LEFT },
+    KeyBinding { SDL_SCANCODE_UP, cbgb::JOYPAD_UP },
+    KeyBinding { SDL_SCANCODE_DOWN, cbgb::JOYPAD_DOWN },
+    KeyBinding { SDL_SCANCODE_Z, cbgb::JOYPAD_A },
+    KeyBinding { SDL_SCANCODE_X, cbgb::JOYPAD_B },
+    KeyBinding { SDL_SCANCODE_BACKSPACE, cbgb::JOYPAD_SELECT },
+    KeyBinding { SDL_SCANCODE_RETURN, cbgb::JOYPAD_START },
+};
+
+uint8_t poll_joypad()
+{
+    const bool* keys = SDL_GetKeyboardState(nullptr);
+    uint8_t buttons = 0x00;
+    for (const KeyBinding& binding : key_bindings) {
+        if (keys[binding.key])
+            buttons = static_cast<uint8_t>(buttons | binding.button);
+    }
+    return buttons;
+}
+
+// Speeds to pick from, as multiples of the normal one. Zero runs uncapped,
+// which is also what holding the fast forward key does.
+constexpr std::array<unsigned int, 5> speed_multipliers = { 1, 2, 4, 8, 0 };
+constexpr std::array<const char*, 5> speed_names = { "1x", "2x", "4x", "8x", "Uncapped" };
+constexpr SDL_Scancode fast_forward_key = SDL_SCANCODE_TAB;
+
+// Runs on SDL's audio thread whenever the device wants more. Anything the
+// emulation thread has not produced yet plays as silence, instead of waiting.
+void SDLCALL feed_audio(void* userdata, SDL_AudioStream* stream, int additional, int /*total*/)
+{
+    static_assert(sizeof(cocoboy::StereoSample) == 4);
+    auto& emulation = *static_cast<cocoboy::EmulationThread*>(userdata);
+    std::array<cocoboy::StereoSample, 1024> samples = {};
+    size_t wanted = static_cast<size_t>(additional) / sizeof(cocoboy::StereoSample);
+    while (wanted > 0) {
+        size_t count = emulation.read_audio(samples.data(), std::min(wanted, samples.size()));
+        if (count == 0)
+            break;
+        int bytes = static_cast<int>(count * sizeof(cocoboy::StereoSample));
+        SDL_PutAudioStreamData(stream, samples.data(), bytes);
+        wanted -= count;
+    }
+}
+
+// Shades from white to black, in the texture's ARGB8888 format.
+constexpr std::array<uint32_t, 4> shade_colors = { 0xFFFFFFFF, 0xFFAAAAAA, 0xFF555555, 0xFF000000 };
+
+// Converts shades to colors straight into the locked texture, one SIMD pass
+// per row, without staging the frame anywhere in between.
+void upload_frame(SDL_Texture* texture, const cbgb::FrameBuffer& frame)
+{
+    void* pixels = nullptr;
+    int pitch = 0;
+    if (!SDL_LockTexture(texture, nullptr, &pixels, &pitch))
+        return;
+    for (size_t line = 0; line < cbgb::SCREEN_HEIGHT; ++line) {
+        auto* row = static_cast<uint32_t*>(pixels) + line * static_cast<size_t>(pitch) / 4;
+        const uint8_t* shades = &frame[line * cbgb::SCREEN_WIDTH];
+        cbgb::shades_to_argb(shades, shade_colors, row, cbgb::SCREEN_WIDTH);
+    }
+    SDL_UnlockTexture(texture);
+}
+
+// Largest whole multiple of the screen that fits the window, centered.
+void draw_frame(SDL_Renderer* renderer, SDL_Texture* texture)
+{
+    int width = 0;
+    int height = 0;
+    SDL_GetRenderOutputSize(renderer, &width, &height);
+    constexpr int screen_width = static_cast<int>(cbgb::SCREEN_WIDTH);
+    constexpr int screen_height = static_cast<int>(cbgb::SCREEN_HEIGHT);
+    int scale = std::max(1, std::min(width / screen_width, height / screen_height));
+    auto frame_width = static_cast<float>(scale * screen_width);
+    auto frame_height = static_cast<float>(scale * screen_height);
+    SDL_FRect target = { (static_cast<float>(width) - frame_width) / 2,
+                         (static_cast<float>(height) - frame_height) / 2,
+                         frame_width,
+                         frame_height };
+    SDL_RenderTexture(renderer, texture, nullptr, &target);
+}
+
+constexpr int tile_columns = 16;
+constexpr int tile_rows = static_cast<int>(cbgb::TILE_COUNT) / tile_columns;
+
+// Lays out all tiles of VRAM in a 16 tile wide grid, as raw color indices
+// rather than through any palette.
+void upload_tiles(SDL_Texture* texture, const cbgb::TileCache& tiles)
+{
+    void* pixels = nullptr;
+    int pitch = 0;
+    if (!SDL_LockTexture(texture, nullptr, &pixels, &pitch))
+        return;
+    for (size_t tile = 0; tile < cbgb::TILE_COUNT; ++tile) {
+        const uint8_t* indices = tiles.get_tile(tile);
+        size_t left = (tile % tile_columns) * 8;
+        size_t top = (tile / tile_columns) * 8;
+        for (size_t y = 0; y < 8; ++y) {
+            size_t offset = (top + y) * static_cast<size_t>(pitch) / 4 + left;
+            auto* row = static_cast<uint32_t*>(pixels) + offset;
+            cbgb::shades_to_argb(indices + y * 8, shade_colors, row, 8);
+        }
+    }
+    SDL_UnlockTexture(texture);
+}
+
+void draw_tile_viewer(SDL_Texture* texture)
+{
+    constexpr float scale = 2.0F;
+    ImGui::Begin("Tiles");
+    ImGui::Image(
+        reinterpret_cast<ImTextureID>(texture), // NOLINT
+        ImVec2(tile_columns * 8 * scale, tile_rows * 8 * scale)
+    );
+    ImGui::End();
+}
+
+// Frames of history the performance overlay keeps, about two seconds' worth.
+constexpr size_t history_length = 120;
+
+// Durations of the same part of the last so many frames, in milliseconds, for
+// ImGui to plot straight out of the ring.
+struct FrameHistory {
+    std::array<float, history_length> values = {};
+    size_t next = 0;
+
+    void add(std::chrono::nanoseconds duration)
+    {
+        values[next] = std::chrono::duration<float, std::milli>(duration).count();
+        next = (next + 1) % history_length;
+    }
+};
+
+struct PerformanceStats {
+    FrameHistory emulation;
+    FrameHistory render;
+    FrameHistory present;
+    uint64_t last_frame = 0;
+    uint64_t dropped = 0;
+    uint64_t duplicated = 0;
+};
+
+// Takes every timing the emulation thread has queued up since the last
+// refresh, which is more than one per refresh while fast forwarding.
+void collect_timings(cocoboy::EmulationThread& emulation, PerformanceStats& stats)
+{
+    std::array<cocoboy::FrameTiming, 64> timings = {};
+    size_t count = 0;
+    do {
+        count = emulation.read_timings(timings.data(), timings.size());
+        for (size_t i = 0; i < count; ++i)
+            stats.emulation.add(timings[i].emulation);
+    } while (count == timings.size());
+}
+
+// A frame emulated but never presented counts as dropped, a refresh that
+// presents the same frame again as duplicated. Either is a visible stutter.
+void count_frames(const cocoboy::EmulatedFrame& frame, bool fresh, PerformanceStats& stats)
+{
+    if (!fresh) {
+        ++stats.duplicated;
+        return;
+    }
+    if (stats.last_frame != 0 && frame.number > stats.last_frame + 1)
+        stats.dropped += frame.number - stats.last_frame - 1;
+    stats.last_frame = frame.number;
+}
+
+// Scaled to two frames at 60 Hz, so that a bar past the middle took longer than
+// a whole refresh.
+void plot_history(const char* label, const FrameHistory& history)
+{
+    constexpr float max_milliseconds = 33.3F;
+    constexpr float plot_height = 60.0F;
+    float latest = history.values[(history.next + history_length - 1) % history_length];
+    std::array<char, 32> overlay = {};
+    fmt::format_to_n(overlay.data(), overlay.size() - 1, "{:.2f} ms", latest);
+    ImGui::PlotHistogram(
+        label,
+        history.values.data(),
+        static_cast<int>(history_length),
+        static_cast<int>(history.next),
+        overlay.data(),
+        0.0F,
+        max_milliseconds,
+        ImVec2(0.0F, plot_height)
+    );
+}
+
+void draw_performance(const PerformanceStats& stats, const cbgb::EmulationSpeed& speed)
+{
+    ImGui::Begin("Performance");
+    plot_history("Emulation", stats.emulation);
+    plot_history("Render", stats.render);
+    plot_history("Present", stats.present);
+    ImGui::Text("Speed: %.1f%%", speed.percent);
+    ImGui::Text("Frames: %.2f/s", speed.frames_per_second);
+    ImGui::Text("Guest: %.0f M-cycles/s", speed.percent / 100.0 * cbgb::MCYCLE_RATE);
+    ImGui::Text("Guest: %.2f MIPS", speed.mips);
+    ImGui::Text(
+        "Dropped: %llu, duplicated: %llu",
+        static_cast<unsigned long long>(stats.dropped),
+        static_cast<unsigned long long>(stats.duplicated)
+    );
+    ImGui::End();
+}
+
+// Written once every thread that records into the trace has stopped, so that
+// the export catches their last frames as well.
+void write_trace(const std::string& path, spdlog::logger& logger)
+{
+    if (!cbgb::TRACING_ENABLED) {
+        logger.warn("Built without ENABLE_TRACING, not writing trace '{}'", path);
+        return;
+    }
+    std::ofstream file(path);
+    if (!file)
+        throw std::runtime_error(fmt::format("Cannot write trace '{}'", path));
+    cbgb::write_chrome_trace(file);
+    logger.info("Wrote trace '{}'", path);
+}
+
+// Waiting for a frame any longer would miss the next refresh at 60 Hz, after
+// drawing and presenting.
+constexpr std::chrono::microseconds max_frame_wait(10000);
+
+// How far the display may be from the GameBoy's refresh rate to lock onto it.
+constexpr double max_vsync_error = 0.01;
 
 int main(int argc, char** argv)
 try {
     std::unique_ptr<cxxopts::Options> parser
         = std::make_unique<cxxopts::Options>(argv[0], "- testing");
     bool version = false;
+    std::string rom_path;
+    unsigned int run_ahead_frames = 0;
+    bool pixel_fifo = false;
+    bool render_thread = false;
+    bool vsync = false;
+    std::string trace_path;
     constexpr size_t max_width = 90;
     auto& options = *parser;
     options.set_width(max_width).set_tab_expansion().add_options()(
         "v,version", "version info", cxxopts::value<bool>(version)
-    );
+    )(
+        "r,run-ahead",
+        "frames to run ahead of input",
+        cxxopts::value<unsigned int>(run_ahead_frames)->default_value("0")
+    )(
+        "pixel-fifo",
+        "draw dot by dot, for mid-line raster effects",
+        cxxopts::value<bool>(pixel_fifo)
+    )(
+        "render-thread",
+        "draw scanlines on a thread of their own",
+        cxxopts::value<bool>(render_thread)
+    )(
+        "vsync",
+        "lock emulation to the display refresh, stretching audio to match",
+        cxxopts::value<bool>(vsync)
+    )(
+        "trace",
+        "write a Chrome trace of host-side phases to FILE on exit",
+        cxxopts::value<std::string>(trace_path),
+        "FILE"
+    )("rom", "ROM to load", cxxopts::value<std::string>(rom_path));
+    options.parse_positional({ "rom" });
+    options.positional_help("[ROM]");
     auto result = options.parse(argc, argv);
 
     if (result.count("version") != 0U) {
@@ -43,11 +327,50 @@ try {
     logger->error("This is a simple error message");
     logger->critical("This is a simple critical error message");
 
+    // Core logs every bus access at debug level, so keep it quiet by default.
+    std::shared_ptr<spdlog::logger> core_logger = spdlog::stdout_color_mt("cbgb");
+    core_logger->set_level(spdlog::level::info);
+
+    std::unique_ptr<cbgb::GameBoy> gameboy;
+    if (!rom_path.empty()) {
+        std::vector<uint8_t> rom = cbgb::read_rom(rom_path);
+        gameboy = std::make_unique<cbgb::GameBoy>(*core_logger);
+        if (pixel_fifo)
+            gameboy->get_ppu().set_accuracy(cbgb::PpuAccuracy::PIXEL_FIFO);
+        gameboy->get_ppu().set_render_thread(render_thread);
+        gameboy->load_rom(rom.data(), rom.size());
+        logger->info("Loaded ROM '{}'", rom_path);
+    }
+    uint8_t joypad = 0x00;
+    int speed_index = 0;
+    unsigned int speed = 1;
+    PerformanceStats stats;
+
     constexpr int winWidth = 600;
     constexpr int winHeight = 400;
-    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS);
+    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_AUDIO);
     SDL_Window* window = SDL_CreateWindow("cocoboy", winWidth, winHeight, SDL_WINDOW_OPENGL);
     SDL_Renderer* renderer = SDL_CreateRenderer(window, nullptr);
+    SDL_SetRenderVSync(renderer, 1);
+
+    // Locking to the display only works out when audio can be stretched to
+    // match, which rate control does within half a percent.
+    double display_rate = 0.0;
+    if (vsync) {
+        const SDL_DisplayMode* mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(window));
+        double rate = mode != nullptr ? static_cast<double>(mode->refresh_rate) : 0.0;
+        if (std::abs(rate / cocoboy::REFRESH_RATE - 1.0) < max_vsync_error)
+            display_rate = rate;
+        else
+            logger->warn("Cannot lock to a {:.2f} Hz display, pacing emulation instead", rate);
+    }
+
+    std::unique_ptr<cocoboy::EmulationThread> emulation;
+    if (gameboy) {
+        emulation = std::make_unique<cocoboy::EmulationThread>(
+            *core_logger, std::move(gameboy), run_ahead_frames, display_rate
+        );
+    }
 
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -56,6 +379,47 @@ try {
     ImGui_ImplSDL3_InitForSDLRenderer(window, renderer);
     ImGui_ImplSDLRenderer3_Init(renderer);
 
+    SDL_Texture* tile_texture = SDL_CreateTexture(
+        renderer,
+        SDL_PIXELFORMAT_ARGB8888,
+        SDL_TEXTUREACCESS_STREAMING,
+        tile_columns * 8,
+        tile_rows * 8
+    );
+    SDL_SetTextureScaleMode(tile_texture, SDL_SCALEMODE_NEAREST);
+    upload_tiles(tile_texture, cbgb::TileCache());
+
+    // Hash of the last frame uploaded, so that frames that did not change, like
+    // most of those of a paused game or a menu, are not uploaded again.
+    auto blank = std::make_unique<cbgb::FrameBuffer>();
+    uint64_t shown = cbgb::hash_frame(*blank);
+    SDL_Texture* frame_texture = SDL_CreateTexture(
+        renderer,
+        SDL_PIXELFORMAT_ARGB8888,
+        SDL_TEXTUREACCESS_STREAMING,
+        static_cast<int>(cbgb::SCREEN_WIDTH),
+        static_cast<int>(cbgb::SCREEN_HEIGHT)
+    );
+    SDL_SetTextureScaleMode(frame_texture, SDL_SCALEMODE_NEAREST);
+    upload_frame(frame_texture, *blank);
+    blank.reset();
+
+    // Small device buffers keep audio latency down, rate control keeps them
+    // from running dry.
+    SDL_AudioStream* audio = nullptr;
+    if (emulation) {
+        SDL_SetHint(SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES, "256");
+        SDL_AudioSpec spec = { SDL_AUDIO_S16, 2, static_cast<int>(cbgb::APU_SAMPLE_RATE) };
+        audio = SDL_OpenAudioDeviceStream(
+            SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, feed_audio, emulation.get()
+        );
+        if (audio != nullptr)
+            SDL_ResumeAudioStreamDevice(audio);
+        else
+            logger->warn("Cannot open audio device: {}", SDL_GetError());
+    }
+
+    CBGB_TRACE_THREAD("Frontend");
     bool running = true;
     while (running) {
         SDL_Event event;
@@ -66,26 +430,92 @@ try {
             }
         }
 
-        ImGui_ImplSDLRenderer3_NewFrame();
-        ImGui_ImplSDL3_NewFrame();
-        ImGui::NewFrame();
+        // Emulation runs at its own pace, this loop only passes input on and
+        // shows whatever frame came out last. Locked to the display, it asks
+        // for a frame with the latest input instead, and presents it right away.
+        bool fresh = false;
+        if (emulation) {
+            uint8_t buttons = poll_joypad();
+            if (buttons != joypad && emulation->send({ cocoboy::CommandKind::JOYPAD, buttons }))
+                joypad = buttons;
+            bool fast_forward = SDL_GetKeyboardState(nullptr)[fast_forward_key]
+                && !ImGui::GetIO().WantCaptureKeyboard;
+            unsigned int wanted
+                = fast_forward ? 0 : speed_multipliers[static_cast<size_t>(speed_index)];
+            cocoboy::Command command = { cocoboy::CommandKind::SPEED,
+                                         static_cast<uint8_t>(wanted) };
+            if (wanted != speed && emulation->send(command))
+                speed = wanted;
+            emulation->tick();
+            emulation->wait_frame(max_frame_wait);
+            fresh = emulation->update();
+            collect_timings(*emulation, stats);
+            count_frames(emulation->get_frame(), fresh, stats);
+        }
+        auto render_start = std::chrono::steady_clock::now();
+        if (fresh) {
+            const cbgb::FrameBuffer& frame = emulation->get_frame().frame;
+            uint64_t hash = cbgb::hash_frame(frame);
+            if (hash != shown) {
+                shown = hash;
+                upload_frame(frame_texture, frame);
+            }
+        }
+        if (emulation && emulation->update_tiles())
+            upload_tiles(tile_texture, emulation->get_tiles());
+
+        {
+            CBGB_TRACE_SCOPE("ImGui");
+            ImGui_ImplSDLRenderer3_NewFrame();
+            ImGui_ImplSDL3_NewFrame();
+            ImGui::NewFrame();
+
+            if (emulation)
+                draw_tile_viewer(tile_texture);
+            draw_performance(stats, emulation ? emulation->get_speed() : cbgb::EmulationSpeed {});
 
-        bool some_panel = true;
-        ImGui::Begin("Some panel", &some_panel);
-        ImGui::Text("Hello world");
-        ImGui::End();
+            ImGui::Begin("Settings");
+            constexpr int max_run_ahead = 4;
+            int frames = static_cast<int>(run_ahead_frames);
+            if (ImGui::SliderInt("Run-ahead frames", &frames, 0, max_run_ahead)) {
+                cocoboy::Command command = { cocoboy::CommandKind::RUN_AHEAD,
+                                             static_cast<uint8_t>(frames) };
+                if (!emulation || emulation->send(command))
+                    run_ahead_frames = static_cast<unsigned int>(frames);
+            }
+            ImGui::Combo(
+                "Speed", &speed_index, speed_names.data(), static_cast<int>(speed_names.size())
+            );
+            ImGui::TextUnformatted("Hold Tab to fast forward");
+            ImGui::End();
 
-        ImGui::Render();
+            ImGui::Render();
+        }
         SDL_SetRenderDrawColor(renderer, 100, 100, 100, 255); // NOLINT
         SDL_RenderClear(renderer);
+        if (emulation)
+            draw_frame(renderer, frame_texture);
         ImGui_ImplSDLRenderer3_RenderDrawData(ImGui::GetDrawData(), renderer);
+        auto present_start = std::chrono::steady_clock::now();
         SDL_RenderPresent(renderer);
+        auto present_end = std::chrono::steady_clock::now();
+        stats.render.add(present_start - render_start);
+        stats.present.add(present_end - present_start);
+        if constexpr (cbgb::TRACING_ENABLED)
+            cbgb::trace_event("Present", present_start, present_end);
     }
 
+    if (audio != nullptr)
+        SDL_DestroyAudioStream(audio);
+    emulation.reset();
+    if (!trace_path.empty())
+        write_trace(trace_path, *logger);
     ImGui_ImplSDLRenderer3_Shutdown();
     ImGui_ImplSDL3_Shutdown();
     ImGui::DestroyContext();
 
+    SDL_DestroyTexture(frame_texture);
+    SDL_DestroyTexture(tile_texture);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
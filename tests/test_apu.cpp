@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/apu.hpp"
+#include "cbgb/memory.hpp"
+#include "cbgb/ppu.hpp"
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+struct TestApu {
+    TestApu()
+        : bus(logger)
+        , apu(logger, bus)
+    {
+        bus.attach_apu(&apu);
+    }
+
+    spdlog::logger logger { "test" };
+    cbgb::MemoryBus bus;
+    cbgb::Apu apu;
+};
+
+// Channel 1 playing a 512 Hz square wave at full volume, on both sides.
+static void play_square(cbgb::MemoryBus& bus)
+{
+    bus.write(cbgb::NR50, 0x77);
+    bus.write(cbgb::NR51, 0x11);
+    bus.write(cbgb::NR10, 0x00);
+    bus.write(cbgb::NR11, 0x80);
+    bus.write(cbgb::NR12, 0xF0);
+    bus.write(cbgb::NR13, 0x00);
+    bus.write(cbgb::NR14, 0x87);
+}
+
+static std::vector<int16_t> read_frame(cbgb::Apu& apu)
+{
+    std::vector<int16_t> samples(2048 * 2);
+    apu.advance(cbgb::MCYCLES_PER_FRAME);
+    samples.resize(apu.read_samples(samples.data(), 2048) * 2);
+    return samples;
+}
+
+TEST_CASE("size_t Apu::read_samples(int16_t* samples, size_t frames)", "[apu]")
+{
+    auto test = std::make_unique<TestApu>();
+    play_square(test->bus);
+    std::vector<int16_t> samples = read_frame(test->apu);
+    REQUIRE(samples.size() / 2 >= 803);
+    REQUIRE(samples.size() / 2 <= 804);
+
+    bool same = true;
+    for (size_t i = 0; i < samples.size(); i += 2)
+        same = same && samples[i] == samples[i + 1];
+    REQUIRE(same);
+    REQUIRE(*std::max_element(samples.begin(), samples.end()) > 3000);
+    REQUIRE(*std::min_element(samples.begin(), samples.end()) < 0);
+
+    SECTION("Panning silences a side")
+    {
+        // Give the high-pass filter a few frames to settle after the change.
+        test->bus.write(cbgb::NR51, 0x10);
+        for (int i = 0; i < 5; ++i)
+            samples = read_frame(test->apu);
+        int16_t loudest = 0;
+        for (size_t i = 1; i < samples.size(); i += 2)
+            loudest = std::max<int16_t>(loudest, static_cast<int16_t>(std::abs(samples[i])));
+        REQUIRE(loudest < 100);
+    }
+}
+
+TEST_CASE("void Apu::write(uint16_t address, uint8_t value)", "[apu]")
+{
+    auto test = std::make_unique<TestApu>();
+    cbgb::MemoryBus& bus = test->bus;
+    REQUIRE(bus.read(cbgb::NR52) == 0xF1);
+    REQUIRE(bus.read(cbgb::NR13) == 0xFF);
+
+    SECTION("Length runs out after the set number of ticks")
+    {
+        bus.write(cbgb::NR22, 0xF0);
+        bus.write(cbgb::NR21, 0x3E);
+        bus.write(cbgb::NR24, 0xC0);
+        REQUIRE((bus.read(cbgb::NR52) & 0x02) != 0);
+        test->apu.advance(4096);
+        REQUIRE((bus.read(cbgb::NR52) & 0x02) != 0);
+        test->apu.advance(4096);
+        REQUIRE((bus.read(cbgb::NR52) & 0x02) == 0);
+    }
+
+    SECTION("DAC off disables the channel")
+    {
+        bus.write(cbgb::NR30, 0x80);
+        bus.write(cbgb::NR34, 0x80);
+        REQUIRE((bus.read(cbgb::NR52) & 0x04) != 0);
+        bus.write(cbgb::NR30, 0x00);
+        REQUIRE((bus.read(cbgb::NR52) & 0x04) == 0);
+    }
+
+    SECTION("Powering off clears every register but wave RAM")
+    {
+        bus.write(cbgb::WAVE_RAM, 0x12);
+        bus.write(cbgb::NR52, 0x00);
+        REQUIRE(bus.read(cbgb::NR52) == 0x70);
+        REQUIRE(bus.read(cbgb::NR50) == 0x00);
+        REQUIRE(bus.read(cbgb::NR11) == 0x3F);
+        bus.write(cbgb::NR50, 0x77);
+        REQUIRE(bus.read(cbgb::NR50) == 0x00);
+        bus.write(cbgb::WAVE_RAM + 1, 0x34);
+        REQUIRE(bus.read(cbgb::WAVE_RAM) == 0x12);
+        REQUIRE(bus.read(cbgb::WAVE_RAM + 1) == 0x34);
+    }
+}
+
+TEST_CASE("void Apu::load_state(const ApuSnapshot& snapshot)", "[apu]")
+{
+    // Output after a restore picks up right where it was saved, even halfway
+    // through catching up.
+    auto test = std::make_unique<TestApu>();
+    play_square(test->bus);
+    read_frame(test->apu);
+    test->apu.advance(1000);
+
+    auto snapshot = std::make_unique<cbgb::ApuSnapshot>();
+    test->apu.save_state(*snapshot);
+    std::vector<int16_t> expect = read_frame(test->apu);
+    test->apu.load_state(*snapshot);
+    REQUIRE(read_frame(test->apu) == expect);
+}
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/arena.hpp"
+#include "cbgb/gameboy.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("ArenaPtr<T> Arena::create(Args&&... args)", "[arena]")
+{
+    spdlog::logger logger("test");
+    constexpr size_t count = 4;
+    cbgb::ArenaMemory memory(cbgb::Arena::required<cbgb::GameBoy>(count));
+    cbgb::Arena arena(memory.data(), memory.size());
+
+    std::vector<cbgb::ArenaPtr<cbgb::GameBoy>> machines;
+    for (size_t i = 0; i < count; ++i)
+        machines.push_back(arena.create<cbgb::GameBoy>(logger));
+
+    auto base = reinterpret_cast<uintptr_t>(memory.data());
+    for (const auto& machine : machines) {
+        auto address = reinterpret_cast<uintptr_t>(machine.get());
+        REQUIRE(address % cbgb::CACHE_LINE_SIZE == 0);
+        REQUIRE(address >= base);
+        REQUIRE(address + sizeof(cbgb::GameBoy) <= base + memory.size());
+    }
+    REQUIRE(arena.get_used() <= cbgb::Arena::required<cbgb::GameBoy>(count));
+
+    machines[1]->get_memory().write(0xC000, 0x42);
+    REQUIRE(machines[0]->get_memory().read(0xC000) == 0x00);
+    REQUIRE(machines[1]->get_memory().read(0xC000) == 0x42);
+}
+
+TEST_CASE("void* Arena::allocate(size_t size, size_t alignment)", "[arena]")
+{
+    alignas(64) uint8_t buffer[256];
+    cbgb::Arena arena(buffer, sizeof(buffer));
+
+    REQUIRE(arena.allocate(1) == buffer);
+    REQUIRE(arena.allocate(1) == buffer + 64);
+    REQUIRE(arena.allocate(8, 8) == buffer + 72);
+    REQUIRE_THROWS_AS(arena.allocate(256), std::bad_alloc);
+    REQUIRE_THROWS_AS(arena.allocate(std::numeric_limits<size_t>::max()), std::bad_alloc);
+    REQUIRE_THROWS_AS(arena.allocate(1, size_t(1) << 40), std::bad_alloc);
+    REQUIRE_THROWS_AS(arena.allocate(1, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(arena.allocate(1, 48), std::invalid_argument);
+    REQUIRE(arena.get_used() == 80);
+
+    arena.reset();
+    REQUIRE(arena.get_used() == 0);
+    REQUIRE(arena.allocate(256) == buffer);
+}
+
+TEST_CASE("ArenaMemory::ArenaMemory(size_t size)", "[arena]")
+{
+    constexpr size_t huge_page = 2 * 1024 * 1024;
+
+    cbgb::ArenaMemory small(100);
+    REQUIRE(small.size() == 4096);
+    REQUIRE(reinterpret_cast<uintptr_t>(small.data()) % 4096 == 0);
+
+    cbgb::ArenaMemory large(huge_page + 1);
+    REQUIRE(large.size() == 2 * huge_page);
+    REQUIRE(reinterpret_cast<uintptr_t>(large.data()) % huge_page == 0);
+    auto* bytes = static_cast<uint8_t*>(large.data());
+    bytes[0] = 1;
+    bytes[large.size() - 1] = 1;
+    REQUIRE(bytes[1] == 0);
+}
@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/blip_buffer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+TEST_CASE("void BlipBuffer::add_delta(uint32_t time, int32_t delta)", "[blip_buffer]")
+{
+    // Two clocks per sample, with the step right between samples 17 and 18
+    // once delayed by half the kernel.
+    cbgb::BlipBuffer buffer(96000, 48000);
+    buffer.add_delta(21, 10000);
+    buffer.end_frame(200);
+    REQUIRE(buffer.get_available() == 100);
+
+    std::array<int16_t, 100> samples = {};
+    REQUIRE(buffer.read_samples(samples.data(), samples.size(), 1) == 100);
+    REQUIRE(buffer.get_available() == 0);
+
+    SECTION("Step is band-limited, then settles at its level")
+    {
+        REQUIRE(samples[0] == 0);
+        REQUIRE(samples[17] > 4000);
+        REQUIRE(samples[17] < 6000);
+        REQUIRE(samples[30] > 9000);
+        REQUIRE(samples[30] <= 10000);
+    }
+
+    SECTION("High-pass filter pulls the level back to zero")
+    {
+        for (int i = 0; i < 100; ++i) {
+            buffer.end_frame(200);
+            buffer.read_samples(samples.data(), samples.size(), 1);
+        }
+        REQUIRE(samples[99] >= 0);
+        REQUIRE(samples[99] < 10);
+    }
+}
+
+TEST_CASE("void BlipBuffer::end_frame(uint32_t time)", "[blip_buffer]")
+{
+    cbgb::BlipBuffer buffer(4194304, 48000);
+    buffer.end_frame(4194304 / 48000 * 10);
+    REQUIRE(buffer.get_available() == 9);
+    for (int i = 0; i < 100; ++i)
+        buffer.end_frame(8192);
+    REQUIRE(buffer.get_available() == cbgb::BLIP_CAPACITY);
+
+    std::array<int16_t, 16> samples = {};
+    REQUIRE(buffer.read_samples(samples.data(), 8, 2) == 8);
+    REQUIRE(buffer.get_available() == cbgb::BLIP_CAPACITY - 8);
+    REQUIRE_THROWS_AS(cbgb::BlipBuffer(4194304, 200000), std::invalid_argument);
+}
+
+TEST_CASE("void BlipBuffer::load_state(const BlipState& state)", "[blip_buffer]")
+{
+    // Steps still in the tail come back after a restore.
+    cbgb::BlipBuffer buffer(48000, 48000);
+    buffer.add_delta(20, 4000);
+    buffer.end_frame(50);
+    buffer.add_delta(10, -2000);
+    auto state = std::make_unique<cbgb::BlipState>();
+    buffer.save_state(*state);
+    buffer.end_frame(100);
+    std::array<int16_t, 150> expect = {};
+    REQUIRE(buffer.read_samples(expect.data(), expect.size(), 1) == 150);
+
+    cbgb::BlipBuffer restored(48000, 48000);
+    restored.load_state(*state);
+    restored.end_frame(100);
+    std::array<int16_t, 100> samples = {};
+    REQUIRE(restored.read_samples(samples.data(), samples.size(), 1) == 100);
+    REQUIRE(std::equal(samples.begin(), samples.end(), expect.begin() + 50));
+}
+
+TEST_CASE("void BlipBuffer::set_sample_rate(uint32_t sample_rate)", "[blip_buffer]")
+{
+    // Half a percent faster output takes half a percent more samples.
+    cbgb::BlipBuffer buffer(4194304, 48000);
+    for (int i = 0; i < 64; ++i)
+        buffer.end_frame(8192);
+    REQUIRE(buffer.get_available() == 6000);
+    buffer.remove_samples(6000);
+    buffer.set_sample_rate(48240);
+    for (int i = 0; i < 64; ++i)
+        buffer.end_frame(8192);
+    REQUIRE(buffer.get_available() >= 6029);
+    REQUIRE(buffer.get_available() <= 6031);
+    REQUIRE_THROWS_AS(buffer.set_sample_rate(100), std::invalid_argument);
+}
@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb-c/cbgb.h"
+#include "test_rom.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <vector>
+
+TEST_CASE("cbgb_status cbgb_step_frames(cbgb_instance* instance, uint32_t frames)", "[capi]")
+{
+    std::vector<uint8_t> rom = new_test_rom();
+    cbgb_instance* instance = cbgb_create();
+    REQUIRE(instance != nullptr);
+    REQUIRE(cbgb_load_rom(instance, rom.data(), rom.size()) == CBGB_OK);
+
+    const uint8_t* frame = cbgb_get_framebuffer(instance);
+    const uint8_t* memory = cbgb_get_memory(instance);
+    REQUIRE(frame != nullptr);
+    REQUIRE(memory[0x0100] == 0x3C);
+
+    REQUIRE(cbgb_step_frames(instance, 2) == CBGB_OK);
+    REQUIRE(cbgb_get_frame_count(instance) == 2);
+    REQUIRE(cbgb_get_framebuffer(instance) == frame);
+    REQUIRE(cbgb_get_error(instance)[0] == '\0');
+    size_t frames = 0;
+    REQUIRE(cbgb_get_audio(instance, &frames) != nullptr);
+    REQUIRE(frames > 1500);
+    REQUIRE(frames <= 1608);
+
+    REQUIRE(cbgb_step_frames(instance, 10) == CBGB_ERROR_UNDEFINED_OPCODE);
+    REQUIRE(cbgb_get_error(instance)[0] != '\0');
+    REQUIRE(cbgb_step_frames(instance, 1) == CBGB_ERROR_UNDEFINED_OPCODE);
+
+    size_t samples = 1;
+    cbgb_get_audio(instance, &samples);
+    REQUIRE(samples == 0);
+    cbgb_destroy(instance);
+}
+
+TEST_CASE("cbgb_status cbgb_step_frames_batch(...)", "[capi]")
+{
+    constexpr size_t count = 8;
+    std::vector<uint8_t> rom = new_test_rom();
+    std::array<cbgb_instance*, count> instances = {};
+    REQUIRE(cbgb_create_batch(instances.data(), count) == CBGB_OK);
+    REQUIRE(cbgb_load_rom_batch(instances.data(), count, rom.data(), rom.size()) == CBGB_OK);
+
+    std::array<uint8_t, count> buttons = {};
+    buttons[3] = CBGB_BUTTON_START;
+    cbgb_set_input_batch(instances.data(), count, buttons.data());
+
+    std::array<cbgb_status, count> statuses = {};
+    REQUIRE(cbgb_step_frames_batch(instances.data(), count, 3, statuses.data()) == CBGB_OK);
+    std::array<const uint8_t*, count> frames = {};
+    cbgb_get_framebuffer_batch(instances.data(), count, frames.data());
+    for (size_t i = 0; i < count; ++i) {
+        REQUIRE(statuses[i] == CBGB_OK);
+        REQUIRE(cbgb_get_frame_count(instances[i]) == 3);
+        REQUIRE(frames[i] == cbgb_get_framebuffer(instances[i]));
+    }
+
+    REQUIRE(
+        cbgb_step_frames_batch(instances.data(), count, 10, statuses.data())
+        == CBGB_ERROR_UNDEFINED_OPCODE
+    );
+    cbgb_destroy_batch(instances.data(), count);
+    REQUIRE(instances[0] == nullptr);
+}
+
+static float reward_from_rom(size_t /*index*/, const uint8_t* memory, void* user)
+{
+    return static_cast<float>(memory[0x0100]) * *static_cast<float*>(user);
+}
+
+TEST_CASE("cbgb_status cbgb_vector_env_step(...)", "[capi]")
+{
+    constexpr size_t count = 4;
+    std::vector<uint8_t> rom = new_test_rom();
+    cbgb_vector_env* env = cbgb_vector_env_create(count, rom.data(), rom.size(), 2);
+    REQUIRE(env != nullptr);
+
+    float scale = 2.0F;
+    cbgb_vector_env_set_callbacks(env, reward_from_rom, nullptr, &scale);
+    size_t size = cbgb_vector_env_get_observation_size(env);
+    REQUIRE(size == CBGB_SCREEN_WIDTH * CBGB_SCREEN_HEIGHT);
+
+    std::vector<uint8_t> observations(count * size, 0xFF);
+    std::array<uint8_t, count> actions = {};
+    std::array<float, count> rewards = {};
+    std::array<uint8_t, count> dones = {};
+    REQUIRE(cbgb_vector_env_reset(env, observations.data()) == CBGB_OK);
+    REQUIRE(
+        cbgb_vector_env_step(
+            env, actions.data(), 1, observations.data(), rewards.data(), dones.data()
+        )
+        == CBGB_OK
+    );
+    REQUIRE(observations.back() == 0x00);
+    REQUIRE(rewards[3] == 2.0F * 0x3C);
+    REQUIRE(dones[3] == 0);
+
+    REQUIRE(cbgb_vector_env_observe_memory(env, 0xFFFF, 2) == CBGB_ERROR_INVALID_ARGUMENT);
+    REQUIRE(cbgb_vector_env_get_error(env)[0] != '\0');
+    cbgb_vector_env_destroy(env);
+}
@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/game_database.hpp"
+#include "cbgb/gameboy.hpp"
+#include "cbgb/run_ahead.hpp"
+#include "test_rom.hpp"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_CASE("void GameBoy::load_state(const Snapshot& snapshot)", "[gameboy]")
+{
+    auto gameboy = new_test_gameboy();
+    auto snapshot = std::make_unique<cbgb::Snapshot>();
+
+    gameboy->save_state(*snapshot);
+    gameboy->step_frame();
+    uint16_t pc = gameboy->get_cpu().get_state().pc;
+    uint8_t a = gameboy->get_cpu().get_state().a;
+    REQUIRE(gameboy->get_frame_count() == 1);
+
+    gameboy->load_state(*snapshot);
+    REQUIRE(gameboy->get_frame_count() == 0);
+    REQUIRE(gameboy->get_cpu().get_state().pc == 0x0100);
+
+    gameboy->step_frame();
+    REQUIRE(gameboy->get_cpu().get_state().pc == pc);
+    REQUIRE(gameboy->get_cpu().get_state().a == a);
+}
+
+TEST_CASE("const FrameBuffer& RunAhead::step_frame(GameBoy& gameboy)", "[run_ahead]")
+{
+    auto expect = new_test_gameboy();
+    auto gameboy = new_test_gameboy();
+    cbgb::RunAhead run_ahead(2);
+
+    run_ahead.step_frame(*gameboy);
+    expect->step_frame();
+    REQUIRE(gameboy->get_frame_count() == 1);
+    REQUIRE(gameboy->get_cpu().get_state().pc == expect->get_cpu().get_state().pc);
+    REQUIRE(gameboy->get_cpu().get_mcycle_count() == expect->get_cpu().get_mcycle_count());
+}
+
+// INC A, LD (BGP), A, PUSH BC, POP BC from the entry point on, 12 M-cycles a
+// round. Sm83 takes the high byte of the address first. Tile data is all zero, so every line shows whatever shade
+// BGP gives color 0 while it is drawn. A frame is not a whole multiple of four
+// rounds, so that shade differs from one frame to the next for the three and
+// a half frames the ROM lasts.
+static std::vector<uint8_t> new_palette_rom()
+{
+    std::vector<uint8_t> rom(0x8000, 0x00);
+    for (size_t i = 0x0100; i + 6 <= rom.size(); i += 6) {
+        rom[i] = 0x3C;
+        rom[i + 1] = 0xEA;
+        rom[i + 2] = 0xFF;
+        rom[i + 3] = 0x47;
+        rom[i + 4] = 0xC5;
+        rom[i + 5] = 0xC1;
+    }
+    return rom;
+}
+
+TEST_CASE("const FrameBuffer& RunAhead::step_frame(GameBoy& gameboy) presents", "[run_ahead]")
+{
+    // One host frame with N frames of run-ahead shows what plain stepping shows
+    // after 1 + N frames.
+    for (unsigned int frames = 0; frames <= 2; ++frames) {
+        auto expect = new_test_gameboy(new_palette_rom());
+        auto gameboy = new_test_gameboy(new_palette_rom());
+        cbgb::RunAhead run_ahead(frames);
+
+        cbgb::FrameBuffer shown = run_ahead.step_frame(*gameboy);
+        for (unsigned int i = 0; i < 1 + frames; ++i)
+            expect->step_frame();
+        REQUIRE(shown == expect->get_frame());
+        REQUIRE(gameboy->get_frame_count() == 1);
+    }
+
+    auto plain = new_test_gameboy(new_palette_rom());
+    auto ahead = new_test_gameboy(new_palette_rom());
+    cbgb::RunAhead off(0);
+    cbgb::RunAhead on(1);
+    REQUIRE(off.step_frame(*plain) != on.step_frame(*ahead));
+}
+
+TEST_CASE("uint8_t MemoryBus::read(uint16_t address) joypad", "[memory_bus]")
+{
+    auto gameboy = new_test_gameboy();
+    cbgb::MemoryBus& memory = gameboy->get_memory();
+    gameboy->set_joypad(cbgb::JOYPAD_RIGHT | cbgb::JOYPAD_START);
+
+    memory.write(0xFF00, 0x20);
+    REQUIRE(memory.read(0xFF00) == 0xEE);
+
+    memory.write(0xFF00, 0x10);
+    REQUIRE(memory.read(0xFF00) == 0xD7);
+
+    memory.write(0xFF00, 0x30);
+    REQUIRE(memory.read(0xFF00) == 0xFF);
+}
+
+TEST_CASE("void GameBoy::load_rom(const uint8_t* data, size_t size)", "[gameboy]")
+{
+    spdlog::logger logger("test");
+    auto gameboy = std::make_unique<cbgb::GameBoy>(logger);
+    std::vector<uint8_t> rom = new_test_rom();
+    gameboy->load_rom(rom.data(), rom.size());
+    REQUIRE(gameboy->get_ppu().get_accuracy() == cbgb::PpuAccuracy::SCANLINE);
+
+    std::string title = "PREHISTORIK MAN";
+    std::copy(title.begin(), title.end(), rom.begin() + 0x0134);
+    REQUIRE(cbgb::read_game_title(rom.data(), rom.size()) == title);
+    REQUIRE(cbgb::lookup_game_flags(rom.data(), rom.size()) == cbgb::GAME_PIXEL_FIFO);
+    gameboy->load_rom(rom.data(), rom.size());
+    REQUIRE(gameboy->get_ppu().get_accuracy() == cbgb::PpuAccuracy::PIXEL_FIFO);
+}
+
+TEST_CASE("std::vector<uint8_t> read_rom(const std::string& path)", "[gameboy]")
+{
+    std::string path = (std::filesystem::temp_directory_path() / "cbgb-test-rom.gb").string();
+    std::vector<uint8_t> rom = new_test_rom();
+    {
+        std::ofstream file(path, std::ios::binary);
+        auto size = static_cast<std::streamsize>(rom.size());
+        file.write(reinterpret_cast<const char*>(rom.data()), size);
+    }
+    REQUIRE(cbgb::read_rom(path) == rom);
+
+    std::filesystem::remove(path);
+    REQUIRE_THROWS_AS(cbgb::read_rom(path), std::runtime_error);
+}
@@ -0,0 +1,25 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/json.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+TEST_CASE("std::string escape_json(const std::string& text)", "[json]")
+{
+    SECTION("Quotes, backslashes and control characters")
+    {
+        REQUIRE(cbgb::escape_json("say \"hi\"") == "say \\\"hi\\\"");
+        REQUIRE(cbgb::escape_json("C:\\roms") == "C:\\\\roms");
+        REQUIRE(cbgb::escape_json("a\nb") == "a\\nb");
+        REQUIRE(cbgb::escape_json(std::string("\t\x01\x1f")) == "\\u0009\\u0001\\u001f");
+    }
+
+    SECTION("UTF-8 passes through")
+    {
+        std::string path = "roms/\xE3\x83\x9D\xE3\x82\xB1\xE3\x83\xA2\xE3\x83\xB3.gb";
+        REQUIRE(cbgb::escape_json(path) == path);
+        REQUIRE(cbgb::escape_json("\x7F") == "\x7F");
+    }
+}
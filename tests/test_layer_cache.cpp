@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/layer_cache.hpp"
+#include "cbgb/memory.hpp"
+#include "cbgb/ppu.hpp"
+#include "cbgb/tile_cache.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+
+struct LayerFixture {
+    spdlog::logger logger { "test" };
+    std::unique_ptr<cbgb::MemoryBus> bus = std::make_unique<cbgb::MemoryBus>(logger);
+    std::unique_ptr<cbgb::TileCache> tiles = std::make_unique<cbgb::TileCache>();
+    std::unique_ptr<cbgb::LayerCache> layers = std::make_unique<cbgb::LayerCache>();
+
+    void sync()
+    {
+        const uint8_t* vram = &bus->get_image()[cbgb::VRAM];
+        cbgb::VramBitmap dirty = bus->take_dirty_vram();
+        tiles->update(vram, dirty);
+        layers->invalidate(vram, dirty);
+    }
+
+    const uint8_t* row(bool unsigned_index, size_t map, unsigned int y)
+    {
+        return layers->get_row(&bus->get_image()[cbgb::VRAM], *tiles, unsigned_index, map, y);
+    }
+};
+
+TEST_CASE("const uint8_t* LayerCache::get_row(...)", "[layer_cache]")
+{
+    LayerFixture fixture;
+    cbgb::MemoryBus& bus = *fixture.bus;
+
+    // Tile 1 has color 3 in its leftmost column. Signed index 1 is tile 257.
+    for (uint16_t row = 0; row < 8; ++row) {
+        bus.write(static_cast<uint16_t>(0x8010 + row * 2), 0x80);
+        bus.write(static_cast<uint16_t>(0x8011 + row * 2), 0x80);
+    }
+    bus.write(0x9821, 0x01);
+    fixture.sync();
+    REQUIRE(fixture.row(true, 0, 9)[8] == 3);
+    REQUIRE(fixture.row(true, 0, 9)[9] == 0);
+    REQUIRE(fixture.row(false, 0, 9)[8] == 0);
+
+    SECTION("Written tiles are redrawn")
+    {
+        bus.write(0x9010, 0xFF);
+        fixture.sync();
+        REQUIRE(fixture.row(false, 0, 8)[15] == 1);
+        REQUIRE(fixture.row(false, 0, 9)[15] == 0);
+    }
+
+    SECTION("Written map entries are redrawn")
+    {
+        bus.write(0x9C00, 0x01);
+        bus.write(0x9821, 0x00);
+        fixture.sync();
+        REQUIRE(fixture.row(true, 0, 9)[8] == 0);
+        REQUIRE(fixture.row(true, 1, 0)[0] == 3);
+    }
+}
+
+TEST_CASE("bool render_scanline(..., LayerCache* layers)", "[layer_cache]")
+{
+    LayerFixture fixture;
+    cbgb::MemoryBus& bus = *fixture.bus;
+    const cbgb::MemoryImage& memory = bus.get_image();
+    for (uint16_t i = 0; i < 0x1800; ++i)
+        bus.write(static_cast<uint16_t>(cbgb::VRAM + i), static_cast<uint8_t>(i * 7 + i / 13));
+    for (uint16_t i = 0; i < 0x800; ++i)
+        bus.write(static_cast<uint16_t>(0x9800 + i), static_cast<uint8_t>(i * 11));
+    fixture.sync();
+
+    std::array<cbgb::PpuRegisters, 3> cases = {
+        cbgb::PpuRegisters { 0x91, 0, 0, 0xE4, 0, 0, 0, 0 },
+        cbgb::PpuRegisters { 0xE9, 200, 173, 0xE4, 0, 0, 40, 3 },
+        cbgb::PpuRegisters { 0xA1, 77, 250, 0x1B, 0, 0, 0, 100 },
+    };
+    std::array<uint8_t, cbgb::SCREEN_WIDTH> expect = {};
+    std::array<uint8_t, cbgb::SCREEN_WIDTH> shades = {};
+    for (const cbgb::PpuRegisters& registers : cases) {
+        for (unsigned int line = 0; line < cbgb::SCREEN_HEIGHT; line += 13) {
+            const uint8_t* vram = &memory[cbgb::VRAM];
+            const uint8_t* oam = &memory[cbgb::OAM];
+            bool window = cbgb::render_scanline(
+                vram, *fixture.tiles, oam, registers, line, line / 2, expect.data()
+            );
+            bool layered_window = cbgb::render_scanline(
+                vram,
+                *fixture.tiles,
+                oam,
+                registers,
+                line,
+                line / 2,
+                shades.data(),
+                fixture.layers.get()
+            );
+            REQUIRE(window == layered_window);
+            REQUIRE(shades == expect);
+        }
+    }
+}
@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/gameboy.hpp"
+#include "cbgb/link.hpp"
+#include "cbgb/memory.hpp"
+#include "cbgb/serial.hpp"
+#include "test_rom.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// The shared test ROM leaves the serial port to the test. Interrupt flags are
+// cleared, so that any raised afterwards come from transfers.
+static std::unique_ptr<cbgb::GameBoy> new_idle_gameboy()
+{
+    auto gameboy = new_test_gameboy();
+    gameboy->get_memory().write(cbgb::IF, 0x00);
+    return gameboy;
+}
+
+static void start_transfer(cbgb::GameBoy& gameboy, uint8_t data, uint8_t control)
+{
+    gameboy.get_memory().write(cbgb::SB, data);
+    gameboy.get_memory().write(cbgb::SC, control);
+}
+
+static bool has_interrupt(cbgb::GameBoy& gameboy)
+{
+    return (gameboy.get_memory().read(cbgb::IF) & cbgb::INTERRUPT_SERIAL) != 0;
+}
+
+TEST_CASE("void Serial::advance(unsigned int mcycles)", "[link]")
+{
+    // Without a link, the internal clock shifts in ones after 8 bits.
+    auto gameboy = new_idle_gameboy();
+    start_transfer(*gameboy, 'A', 0x81);
+    gameboy->get_serial().advance(255);
+    REQUIRE_FALSE(has_interrupt(*gameboy));
+    gameboy->get_serial().advance(1);
+    REQUIRE(has_interrupt(*gameboy));
+    REQUIRE(gameboy->get_memory().read(cbgb::SB) == 0xFF);
+    REQUIRE(gameboy->get_memory().read(cbgb::SC) == 0x7F);
+    REQUIRE(gameboy->get_serial().get_output() == "A");
+
+    // The external clock never comes.
+    start_transfer(*gameboy, 'B', 0x80);
+    gameboy->get_serial().advance(100000);
+    REQUIRE(gameboy->get_memory().read(cbgb::SC) == 0xFE);
+}
+
+TEST_CASE("void LinkCable::step_window()", "[link]")
+{
+    auto left = new_idle_gameboy();
+    auto right = new_idle_gameboy();
+    cbgb::LinkCable cable(*left, *right, 1024);
+
+    SECTION("Bytes swap between clock and ready side")
+    {
+        start_transfer(*left, 0x12, 0x81);
+        start_transfer(*right, 0x34, 0x80);
+        cable.step_window();
+        REQUIRE(left->get_memory().read(cbgb::SB) == 0x34);
+        REQUIRE(right->get_memory().read(cbgb::SB) == 0x12);
+        REQUIRE(left->get_memory().read(cbgb::SC) == 0x7F);
+        REQUIRE(right->get_memory().read(cbgb::SC) == 0x7E);
+        REQUIRE(has_interrupt(*left));
+        REQUIRE(has_interrupt(*right));
+    }
+
+    SECTION("Transfers wait for the partner rather than the open line")
+    {
+        start_transfer(*left, 0x12, 0x81);
+        cable.step_window();
+        REQUIRE(left->get_memory().read(cbgb::SB) == 0xFF);
+        REQUIRE(has_interrupt(*left));
+        REQUIRE_FALSE(has_interrupt(*right));
+
+        // A transfer started too late into a window finishes in the next.
+        cable.step_window();
+        left->get_memory().write(cbgb::IF, 0x00);
+        while (left->get_mcycle_count() < 3 * 1024 - 100)
+            left->step();
+        start_transfer(*left, 0x56, 0x81);
+        start_transfer(*right, 0x78, 0x80);
+        cable.step_window();
+        REQUIRE_FALSE(has_interrupt(*left));
+        REQUIRE(right->get_memory().read(cbgb::SB) == 0x78);
+        cable.step_window();
+        REQUIRE(has_interrupt(*left));
+        REQUIRE(right->get_memory().read(cbgb::SB) == 0x56);
+    }
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_CASE("void LinkSocket::step_window()", "[link]")
+{
+    std::string path = (std::filesystem::temp_directory_path() / "cbgb-test-link.sock").string();
+    auto left = new_idle_gameboy();
+    auto right = new_idle_gameboy();
+    start_transfer(*left, 0x12, 0x81);
+    start_transfer(*right, 0x34, 0x80);
+
+    std::thread partner([&right, &path] {
+        cbgb::LinkSocket link(*right, path, cbgb::LinkRole::CONNECT, 1024);
+        link.step_frames(2);
+    });
+    {
+        cbgb::LinkSocket link(*left, path, cbgb::LinkRole::LISTEN, 1024);
+        link.step_frames(1);
+    }
+    partner.join();
+
+    REQUIRE(left->get_memory().read(cbgb::SB) == 0x34);
+    REQUIRE(right->get_memory().read(cbgb::SB) == 0x12);
+    REQUIRE(left->get_frame_count() >= 2);
+    REQUIRE(right->get_frame_count() >= 2);
+
+    SECTION("Sides on different windows refuse to link")
+    {
+        bool refused = false;
+        std::thread other([&right, &path, &refused] {
+            try {
+                cbgb::LinkSocket link(*right, path, cbgb::LinkRole::CONNECT, 512);
+            }
+            catch (const std::runtime_error&) {
+                refused = true;
+            }
+        });
+        REQUIRE_THROWS_AS(
+            cbgb::LinkSocket(*left, path, cbgb::LinkRole::LISTEN, 1024), std::runtime_error
+        );
+        other.join();
+        REQUIRE(refused);
+    }
+}
+#endif
@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/gameboy.hpp"
+#include "cbgb/lockstep.hpp"
+#include "cbgb/workload.hpp"
+#include "test_rom.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Register-only instructions, arithmetic and immediate forms included, mixed
+// with a few that the lockstep interpreter has to peel off to the scalar path.
+static std::vector<uint8_t> new_lockstep_rom(uint32_t seed)
+{
+    constexpr std::array<uint8_t, 32> opcodes = {
+        0x48, 0x5A, 0x7B, 0x6F, 0xA0, 0xA9, 0xB2, 0x3C,
+        0x0C, 0x2F, 0x37, 0x3F, 0x80, 0x8B, 0x91, 0x9A,
+        0xBB, 0x87, 0x97, 0x1D, 0x0D, 0x3D, 0xC6, 0xCE,
+        0xD6, 0xDE, 0xEE, 0xF6, 0xFE, 0xE6, 0xC5, 0xBE,
+    };
+    cbgb::OpcodeHistogram histogram = {};
+    for (uint8_t opcode : opcodes)
+        histogram[opcode] = 1;
+    return cbgb::WorkloadGenerator(histogram, seed).generate_rom();
+}
+
+TEST_CASE("void LockstepSm83::step_frame()", "[lockstep]")
+{
+    constexpr unsigned int lanes = 12;
+    std::vector<std::unique_ptr<cbgb::GameBoy>> expect;
+    std::vector<std::unique_ptr<cbgb::GameBoy>> actual;
+    std::vector<cbgb::GameBoy*> machines;
+    for (unsigned int i = 0; i < lanes; ++i) {
+        // Half the lanes share a program, the rest diverge on every opcode.
+        uint32_t seed = i % 2 == 0 ? 0 : i;
+        expect.push_back(new_test_gameboy(new_lockstep_rom(seed)));
+        actual.push_back(new_test_gameboy(new_lockstep_rom(seed)));
+        machines.push_back(actual.back().get());
+    }
+
+    // The second frame starts with every lane on whichever path it ended the
+    // first one on.
+    cbgb::LockstepSm83 lockstep(machines);
+    lockstep.step_frame();
+    lockstep.step_frame();
+    lockstep.sync();
+    for (unsigned int i = 0; i < lanes; ++i) {
+        expect[i]->step_frame();
+        expect[i]->step_frame();
+        cbgb::Sm83Snapshot want = {};
+        cbgb::Sm83Snapshot got = {};
+        expect[i]->get_cpu().save_state(want);
+        actual[i]->get_cpu().save_state(got);
+        REQUIRE(got.pc == want.pc);
+        REQUIRE(got.sp == want.sp);
+        REQUIRE(got.a == want.a);
+        REQUIRE(got.f == want.f);
+        REQUIRE(got.b == want.b);
+        REQUIRE(got.c == want.c);
+        REQUIRE(got.d == want.d);
+        REQUIRE(got.e == want.e);
+        REQUIRE(got.h == want.h);
+        REQUIRE(got.l == want.l);
+        REQUIRE(got.mcycles == want.mcycles);
+        REQUIRE(actual[i]->get_frame_count() == 2);
+        REQUIRE(actual[i]->get_mcycle_count() == expect[i]->get_mcycle_count());
+        REQUIRE(actual[i]->get_instruction_count() == expect[i]->get_instruction_count());
+    }
+    REQUIRE(lockstep.get_vector_count() > 0);
+    REQUIRE(lockstep.get_scalar_count() > 0);
+}
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/pacing.hpp"
+#include "cbgb/ppu.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+
+TEST_CASE("bool SpeedMeter::add_frame(Clock::time_point, uint64_t, uint64_t)", "[pacing]")
+{
+    using namespace std::chrono_literals;
+    cbgb::SpeedMeter meter(100ms);
+    cbgb::SpeedMeter::Clock::time_point start;
+
+    SECTION("Interval")
+    {
+        // The first frame only sets the baseline.
+        REQUIRE_FALSE(meter.add_frame(start, 0, 0));
+        REQUIRE_FALSE(meter.add_frame(start + 50ms, cbgb::MCYCLES_PER_FRAME * 3, 1000));
+
+        // Two frames in 100 ms, but with six frames worth of M-cycles between them.
+        REQUIRE(meter.add_frame(start + 100ms, cbgb::MCYCLES_PER_FRAME * 6, 500000));
+        const cbgb::EmulationSpeed& speed = meter.get_speed();
+        double expected = cbgb::MCYCLES_PER_FRAME * 6 / cbgb::MCYCLE_RATE / 0.1 * 100.0;
+        REQUIRE(speed.percent > expected - 0.01);
+        REQUIRE(speed.percent < expected + 0.01);
+        REQUIRE(speed.frames_per_second > 19.99);
+        REQUIRE(speed.frames_per_second < 20.01);
+        REQUIRE(speed.mips > 4.99);
+        REQUIRE(speed.mips < 5.01);
+    }
+
+    SECTION("Reset")
+    {
+        REQUIRE_FALSE(meter.add_frame(start, 0, 0));
+        meter.reset();
+        REQUIRE_FALSE(meter.add_frame(start + 200ms, 1000, 1000));
+        REQUIRE_FALSE(meter.add_frame(start + 250ms, 2000, 2000));
+        REQUIRE(meter.add_frame(start + 300ms, 1000 + 104858, 1000 + 100000));
+        REQUIRE(meter.get_speed().percent > 99.99);
+        REQUIRE(meter.get_speed().percent < 100.01);
+        REQUIRE(meter.get_speed().frames_per_second > 19.99);
+        REQUIRE(meter.get_speed().frames_per_second < 20.01);
+    }
+}
+
+TEST_CASE("void FramePacer::wait()", "[pacing]")
+{
+    using namespace std::chrono_literals;
+    using Clock = std::chrono::steady_clock;
+    cbgb::FramePacer pacer(2ms);
+
+    SECTION("Paced")
+    {
+        pacer.reset();
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < 5; ++i)
+            pacer.wait();
+        REQUIRE(Clock::now() - start >= 10ms);
+        REQUIRE(pacer.get_margin() >= 200us);
+        REQUIRE(pacer.get_margin() <= 4ms);
+    }
+
+    SECTION("Multiplied")
+    {
+        pacer.set_speed(2.0);
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < 5; ++i)
+            pacer.wait();
+        REQUIRE(Clock::now() - start >= 5ms);
+    }
+
+    SECTION("Uncapped")
+    {
+        pacer.set_speed(0.0);
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < 1000; ++i)
+            pacer.wait();
+        REQUIRE(Clock::now() - start < 1s);
+    }
+
+    SECTION("Invalid")
+    {
+        REQUIRE_THROWS_AS(pacer.set_speed(-1.0), std::invalid_argument);
+        REQUIRE_THROWS_AS(cbgb::FramePacer(0ns), std::invalid_argument);
+    }
+}
@@ -0,0 +1,395 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/memory.hpp"
+#include "cbgb/ppu.hpp"
+#include "cbgb/tile_cache.hpp"
+#include "cbgb/video.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+TEST_CASE("void decode_tiles(const uint8_t* low, const uint8_t* high, ...)", "[video]")
+{
+    // Example row from Pan Docs, followed by two more tiles for the vector path.
+    std::array<uint8_t, 3> low = { 0x3C, 0xFF, 0x81 };
+    std::array<uint8_t, 3> high = { 0x7E, 0x00, 0x81 };
+    std::array<uint8_t, 24> colors = {};
+    cbgb::decode_tiles(low.data(), high.data(), 3, colors.data());
+
+    std::array<uint8_t, 24> expect = { 0, 2, 3, 3, 3, 3, 2, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                       3, 0, 0, 0, 0, 0, 0, 3 };
+    REQUIRE(colors == expect);
+}
+
+TEST_CASE("void apply_palette(const uint8_t* colors, uint8_t palette, ...)", "[video]")
+{
+    std::vector<uint8_t> colors(20);
+    for (size_t i = 0; i < colors.size(); ++i)
+        colors[i] = static_cast<uint8_t>(i & 3);
+    std::vector<uint8_t> shades(colors.size());
+
+    cbgb::apply_palette(colors.data(), 0x1B, shades.data(), shades.size());
+    for (size_t i = 0; i < colors.size(); ++i)
+        REQUIRE(shades[i] == 3 - colors[i]);
+}
+
+struct PpuFixture {
+    spdlog::logger logger { "test" };
+    cbgb::MemoryBus bus { logger };
+    cbgb::TileCache tiles;
+    std::array<uint8_t, cbgb::SCREEN_WIDTH> shades = {};
+
+    // Tile 1 is solid color 3, tile 2 has color 1 in its leftmost column.
+    PpuFixture()
+    {
+        for (uint16_t row = 0; row < 8; ++row) {
+            bus.write(static_cast<uint16_t>(0x8010 + row * 2), 0xFF);
+            bus.write(static_cast<uint16_t>(0x8011 + row * 2), 0xFF);
+            bus.write(static_cast<uint16_t>(0x8020 + row * 2), 0x80);
+        }
+    }
+
+    void render(const cbgb::PpuRegisters& registers, unsigned int line, unsigned int window = 0)
+    {
+        const cbgb::MemoryImage& memory = bus.get_image();
+        tiles.update(&memory[cbgb::VRAM], bus.take_dirty_vram());
+        cbgb::render_scanline(
+            &memory[cbgb::VRAM], tiles, &memory[cbgb::OAM], registers, line, window, shades.data()
+        );
+    }
+};
+
+TEST_CASE("bool render_scanline(...)", "[ppu]")
+{
+    PpuFixture fixture;
+    cbgb::MemoryBus& bus = fixture.bus;
+    cbgb::PpuRegisters registers = { 0x91, 0, 0, 0xE4, 0xE4, 0x1B, 0, 0 };
+
+    SECTION("Background with fine scroll")
+    {
+        bus.write(0x9801, 0x01);
+        registers.scx = 3;
+        fixture.render(registers, 0);
+        for (size_t x = 0; x < 16; ++x)
+            REQUIRE(fixture.shades[x] == (x >= 5 && x < 13 ? 3 : 0));
+    }
+
+    SECTION("Window over background")
+    {
+        bus.write(0x9C00, 0x02);
+        registers.lcdc = 0xF1;
+        registers.wy = 4;
+        registers.wx = 27;
+        fixture.render(registers, 3);
+        REQUIRE(fixture.shades[20] == 0);
+        fixture.render(registers, 4);
+        REQUIRE(fixture.shades[19] == 0);
+        REQUIRE(fixture.shades[20] == 1);
+        REQUIRE(fixture.shades[21] == 0);
+    }
+
+    SECTION("Object priority")
+    {
+        // Object 0 at x 12, object 1 at x 8 wins the overlap despite its
+        // OAM position, object 2 hides behind background colors 1-3.
+        registers.lcdc = 0x93;
+        bus.write(0x9800, 0x02);
+        std::array<uint8_t, 12> oam = { 16, 20, 1, 0x10, 16, 16, 2, 0x00, 16, 8, 1, 0x80 };
+        for (uint16_t i = 0; i < oam.size(); ++i)
+            bus.write(static_cast<uint16_t>(cbgb::OAM + i), oam[i]);
+
+        fixture.render(registers, 0);
+        REQUIRE(fixture.shades[0] == 1);
+        REQUIRE(fixture.shades[1] == 3);
+        REQUIRE(fixture.shades[8] == 1);
+        REQUIRE(fixture.shades[9] == 0);
+        REQUIRE(fixture.shades[12] == 0);
+        REQUIRE(fixture.shades[19] == 0);
+        REQUIRE(fixture.shades[20] == 0);
+    }
+}
+
+TEST_CASE("bool Ppu::advance(unsigned int mcycles)", "[ppu]")
+{
+    spdlog::logger logger("test");
+    auto bus = std::make_unique<cbgb::MemoryBus>(logger);
+    cbgb::Ppu ppu(logger, *bus);
+    const cbgb::MemoryImage& memory = bus->get_image();
+    bus->write(cbgb::LYC, 2);
+    bus->write(cbgb::STAT, 0x40);
+
+    REQUIRE(!ppu.advance(20));
+    REQUIRE((memory[cbgb::STAT] & 3) == cbgb::PPU_DRAWING);
+    REQUIRE(!ppu.advance(114 * 2 - 20));
+    REQUIRE(memory[cbgb::LY] == 2);
+    REQUIRE((memory[cbgb::STAT] & 0x04) != 0);
+    REQUIRE((memory[cbgb::IF] & cbgb::INTERRUPT_LCD) != 0);
+
+    REQUIRE(ppu.advance(114 * 142));
+    REQUIRE(memory[cbgb::LY] == 144);
+    REQUIRE((memory[cbgb::STAT] & 3) == cbgb::PPU_VBLANK);
+    REQUIRE((memory[cbgb::IF] & cbgb::INTERRUPT_VBLANK) != 0);
+    REQUIRE(!ppu.advance(114 * 10 - 1));
+    REQUIRE(ppu.advance(114 * 144 + 1));
+
+    bus->write(cbgb::LCDC, 0x11);
+    REQUIRE(!ppu.advance(114 * 100));
+    REQUIRE(memory[cbgb::LY] == 0);
+    REQUIRE(ppu.advance(114 * 44));
+}
+
+TEST_CASE("unsigned int Ppu::get_mcycles_to_frame() const", "[ppu]")
+{
+    spdlog::logger logger("test");
+    auto bus = std::make_unique<cbgb::MemoryBus>(logger);
+    cbgb::Ppu ppu(logger, *bus);
+
+    REQUIRE(!ppu.advance(100));
+    unsigned int left = ppu.get_mcycles_to_frame();
+    REQUIRE(!ppu.advance(left - 1));
+    REQUIRE(ppu.get_mcycles_to_frame() == 1);
+    REQUIRE(ppu.advance(1));
+    REQUIRE(ppu.get_mcycles_to_frame() == cbgb::MCYCLES_PER_FRAME);
+
+    bus->write(cbgb::LCDC, 0x11);
+    REQUIRE(ppu.get_mcycles_to_frame() == 114 * 144);
+    REQUIRE(!ppu.advance(114 * 144 - 1));
+    REQUIRE(ppu.advance(1));
+}
+
+// Runs a PPU to the start of line 1, and returns how many dots mode 3 of line
+// 0 took, to the nearest M-cycle.
+static unsigned int measure_mode3(cbgb::Ppu& ppu, const cbgb::MemoryImage& memory)
+{
+    unsigned int mcycles = 20;
+    ppu.advance(20);
+    while ((memory[cbgb::STAT] & 3) == cbgb::PPU_DRAWING) {
+        ppu.advance(1);
+        ++mcycles;
+    }
+    ppu.advance(114 - mcycles);
+    return (mcycles - 20) * 4;
+}
+
+TEST_CASE("void Ppu::set_accuracy(PpuAccuracy accuracy)", "[ppu]")
+{
+    PpuFixture fixture;
+    cbgb::MemoryBus& bus = fixture.bus;
+    const cbgb::MemoryImage& memory = bus.get_image();
+    cbgb::Ppu ppu(fixture.logger, bus);
+    ppu.set_accuracy(cbgb::PpuAccuracy::PIXEL_FIFO);
+
+    SECTION("Same picture as the scanline renderer")
+    {
+        // Scrolled checkerboard, window in the bottom right, and a row of
+        // overlapping objects, some behind the background.
+        for (uint16_t i = 0; i < 0x400; ++i)
+            bus.write(static_cast<uint16_t>(0x9800 + i), static_cast<uint8_t>((i + i / 32) & 1));
+        bus.write(0x9C00, 0x02);
+        for (uint16_t i = 0; i < 40; ++i) {
+            auto object = static_cast<uint16_t>(cbgb::OAM + i * 4);
+            bus.write(object, static_cast<uint8_t>(20 + i));
+            bus.write(static_cast<uint16_t>(object + 1), static_cast<uint8_t>(i * 5));
+            bus.write(static_cast<uint16_t>(object + 2), static_cast<uint8_t>(1 + i % 2));
+            bus.write(static_cast<uint16_t>(object + 3), static_cast<uint8_t>(i * 0x10));
+        }
+        bus.write(cbgb::LCDC, 0xF3);
+        bus.write(cbgb::SCX, 13);
+        bus.write(cbgb::SCY, 5);
+        bus.write(cbgb::WX, 90);
+        bus.write(cbgb::WY, 100);
+        bus.write(cbgb::OBP0, 0xE4);
+        bus.write(cbgb::OBP1, 0x1B);
+
+        cbgb::Ppu scanline(fixture.logger, bus);
+        REQUIRE(ppu.advance(114 * 144));
+        REQUIRE(scanline.advance(114 * 144));
+        REQUIRE(ppu.get_frame() == scanline.get_frame());
+    }
+
+    SECTION("Mode 3 length")
+    {
+        REQUIRE(measure_mode3(ppu, memory) == 172);
+        bus.write(cbgb::SCX, 3);
+        REQUIRE(measure_mode3(ppu, memory) == 176);
+        bus.write(cbgb::SCX, 0);
+        bus.write(cbgb::LCDC, 0x93);
+        bus.write(cbgb::OAM, 16);
+        bus.write(cbgb::OAM + 1, 8);
+        REQUIRE(measure_mode3(ppu, memory) == 184);
+
+        ppu.set_accuracy(cbgb::PpuAccuracy::SCANLINE);
+        REQUIRE(measure_mode3(ppu, memory) == 172);
+    }
+
+    SECTION("Palette change in the middle of a line")
+    {
+        for (uint16_t i = 0; i < 32; ++i)
+            bus.write(static_cast<uint16_t>(0x9800 + i), 0x01);
+
+        // 172 dots in, 80 pixels have been drawn.
+        ppu.advance(43);
+        bus.write(cbgb::BGP, 0x00);
+        ppu.advance(114 - 43);
+        for (size_t x = 0; x < cbgb::SCREEN_WIDTH; ++x)
+            REQUIRE(ppu.get_frame()[x] == (x < 80 ? 3 : 0));
+    }
+}
+
+TEST_CASE("void Ppu::set_render_skip(bool skip)", "[ppu]")
+{
+    // Only row 9 of the window map holds the solid tile.
+    PpuFixture fixture;
+    cbgb::MemoryBus& bus = fixture.bus;
+    const cbgb::MemoryImage& memory = bus.get_image();
+    cbgb::Ppu ppu(fixture.logger, bus);
+    for (uint16_t i = 0; i < 32; ++i)
+        bus.write(static_cast<uint16_t>(0x9D20 + i), 0x01);
+    bus.write(cbgb::LCDC, 0xF1);
+    bus.write(cbgb::WX, 7);
+    bus.write(cbgb::LYC, 2);
+    bus.write(cbgb::STAT, 0x40);
+
+    // Timing and interrupts carry on while nothing is drawn.
+    ppu.set_render_skip(true);
+    REQUIRE(!ppu.advance(114 * 2));
+    REQUIRE(memory[cbgb::LY] == 2);
+    REQUIRE((memory[cbgb::IF] & cbgb::INTERRUPT_LCD) != 0);
+    REQUIRE(!ppu.advance(114 * 70));
+    for (uint8_t shade : ppu.get_frame())
+        REQUIRE(shade == 0);
+
+    // Window lines skipped still count, so row 9 lands on line 72.
+    ppu.set_render_skip(false);
+    REQUIRE(ppu.advance(114 * 72));
+    REQUIRE((memory[cbgb::IF] & cbgb::INTERRUPT_VBLANK) != 0);
+    REQUIRE(ppu.get_frame()[71 * cbgb::SCREEN_WIDTH] == 0);
+    REQUIRE(ppu.get_frame()[72 * cbgb::SCREEN_WIDTH] == 3);
+    REQUIRE(ppu.get_frame()[80 * cbgb::SCREEN_WIDTH] == 0);
+}
+
+// Draws a frame of a checkerboard scrolled a little more every line, with an
+// object on top, and tile 1 rewritten partway down if asked to.
+static void draw_scrolling_frame(cbgb::MemoryBus& bus, cbgb::Ppu& ppu, bool rewrite)
+{
+    for (uint16_t i = 0; i < 0x400; ++i)
+        bus.write(static_cast<uint16_t>(0x9800 + i), static_cast<uint8_t>((i + i / 32) & 1));
+    bus.write(cbgb::OAM, 40);
+    bus.write(cbgb::OAM + 1, 20);
+    bus.write(cbgb::OAM + 2, 2);
+    bus.write(cbgb::LCDC, 0x93);
+    for (unsigned int line = 0; line < cbgb::LINES_PER_FRAME; ++line) {
+        bus.write(cbgb::SCX, static_cast<uint8_t>(line * 3));
+        if (rewrite && line == 60)
+            bus.write(0x8011, 0x00);
+        ppu.advance(114);
+    }
+}
+
+TEST_CASE("void Ppu::set_render_thread(bool enabled)", "[ppu]")
+{
+    PpuFixture expect_fixture;
+    cbgb::Ppu expect(expect_fixture.logger, expect_fixture.bus);
+    draw_scrolling_frame(expect_fixture.bus, expect, false);
+
+    PpuFixture fixture;
+    cbgb::MemoryBus& bus = fixture.bus;
+    cbgb::Ppu ppu(fixture.logger, bus);
+    ppu.set_render_thread(true);
+    REQUIRE(ppu.get_render_thread());
+
+    SECTION("Same picture as drawing on the emulation thread")
+    {
+        draw_scrolling_frame(bus, ppu, false);
+        REQUIRE(ppu.get_frame() == expect.get_frame());
+        draw_scrolling_frame(bus, ppu, true);
+        draw_scrolling_frame(expect_fixture.bus, expect, true);
+        REQUIRE(ppu.get_frame() == expect.get_frame());
+    }
+
+    SECTION("Restored state")
+    {
+        auto memory = std::make_unique<cbgb::MemoryImage>();
+        auto snapshot = std::make_unique<cbgb::PpuSnapshot>();
+        bus.save_state(*memory);
+        ppu.save_state(*snapshot);
+        draw_scrolling_frame(bus, ppu, true);
+
+        bus.load_state(*memory);
+        ppu.load_state(*snapshot);
+        draw_scrolling_frame(bus, ppu, false);
+        REQUIRE(ppu.get_frame() == expect.get_frame());
+    }
+
+    ppu.set_render_thread(false);
+    REQUIRE(!ppu.get_render_thread());
+}
+
+TEST_CASE("bool Ppu::advance(unsigned int mcycles) raster effects", "[ppu]")
+{
+    // Map entry 1 is solid tile 1 unsigned, and blank tile 257 signed.
+    PpuFixture fixture;
+    cbgb::MemoryBus& bus = fixture.bus;
+    cbgb::Ppu ppu(fixture.logger, bus);
+    for (uint16_t i = 0; i < 0x400; ++i)
+        bus.write(static_cast<uint16_t>(0x9800 + i), 0x01);
+
+    // Tile addressing flips halfway down, in two frames running.
+    for (int frame = 0; frame < 2; ++frame) {
+        bus.write(cbgb::LCDC, 0x91);
+        ppu.advance(114 * 72);
+        bus.write(cbgb::LCDC, 0x81);
+        REQUIRE(ppu.advance(114 * 72));
+        ppu.advance(114 * 10);
+        for (size_t line = 0; line < cbgb::SCREEN_HEIGHT; line += 8)
+            REQUIRE(ppu.get_frame()[line * cbgb::SCREEN_WIDTH + 3] == (line < 72 ? 3 : 0));
+    }
+}
+
+TEST_CASE("const LineObjects& ObjectLists::get_line(...)", "[ppu]")
+{
+    spdlog::logger logger("test");
+    auto bus = std::make_unique<cbgb::MemoryBus>(logger);
+    const uint8_t* oam = &bus->get_image()[cbgb::OAM];
+    auto lists = std::make_unique<cbgb::ObjectLists>();
+    REQUIRE(bus->take_dirty_oam() == (uint64_t(1) << 40) - 1);
+
+    // 12 objects on line 0, in decreasing X.
+    for (uint16_t i = 0; i < 12; ++i) {
+        bus->write(static_cast<uint16_t>(cbgb::OAM + i * 4), 16);
+        bus->write(static_cast<uint16_t>(cbgb::OAM + i * 4 + 1), static_cast<uint8_t>(100 - i));
+    }
+    lists->update(oam, bus->take_dirty_oam(), 0x91);
+    const cbgb::LineObjects& line = lists->get_line(oam, 0);
+    REQUIRE(line.count == 10);
+    REQUIRE(line.indices[0] == 9);
+    REQUIRE(line.indices[9] == 0);
+    REQUIRE(lists->get_line(oam, 8).count == 0);
+
+    // Moving object 3 down frees a slot for object 10.
+    bus->write(cbgb::OAM + 12, 20);
+    REQUIRE(bus->take_dirty_oam() == 1U << 3);
+    lists->update(oam, 1U << 3, 0x91);
+    REQUIRE(lists->get_line(oam, 0).indices[0] == 10);
+    REQUIRE(lists->get_line(oam, 8).count == 1);
+    REQUIRE(lists->get_line(oam, 16).count == 0);
+
+    // Tall objects reach further down, and DMA rewrites all of OAM.
+    lists->update(oam, 0, 0x95);
+    REQUIRE(lists->get_line(oam, 16).count == 1);
+    for (uint16_t i = 0; i < 0xA0; ++i)
+        bus->write(static_cast<uint16_t>(0xC000 + i), static_cast<uint8_t>(i * 37 % 170));
+    bus->write(cbgb::DMA, 0xC0);
+    lists->update(oam, bus->take_dirty_oam(), 0x95);
+    for (unsigned int y = 0; y < cbgb::SCREEN_HEIGHT; ++y) {
+        cbgb::LineObjects expect = cbgb::select_objects(oam, 0x95, y);
+        const cbgb::LineObjects& objects = lists->get_line(oam, y);
+        REQUIRE(objects.count == expect.count);
+        for (size_t i = 0; i < expect.count; ++i)
+            REQUIRE(objects.indices[i] == expect.indices[i]);
+    }
+}
@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+//! @brief Test ROM shared by the test cases of whole machines.
+
+#ifndef CBGB_TEST_ROM_HPP
+#define CBGB_TEST_ROM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <spdlog/logger.h>
+
+#include "cbgb/gameboy.hpp"
+
+// INC A, PUSH BC, POP BC from the entry point on, which keeps the stack
+// balanced for about five frames, until the CPU runs off the end of the ROM
+// into opcodes the core does not implement.
+inline std::vector<uint8_t> new_test_rom()
+{
+    std::vector<uint8_t> rom(0x8000, 0x00);
+    for (size_t i = 0x0100; i + 3 <= rom.size(); i += 3) {
+        rom[i] = 0x3C;
+        rom[i + 1] = 0xC5;
+        rom[i + 2] = 0xC1;
+    }
+    return rom;
+}
+
+inline std::unique_ptr<cbgb::GameBoy> new_test_gameboy(
+    const std::vector<uint8_t>& rom = new_test_rom()
+)
+{
+    static spdlog::logger logger("test");
+    auto gameboy = std::make_unique<cbgb::GameBoy>(logger);
+    gameboy->load_rom(rom.data(), rom.size());
+    return gameboy;
+}
+
+#endif // CBGB_TEST_ROM_HPP
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/spsc_queue.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <thread>
+
+TEST_CASE("bool SpscQueue::push(const T& item)", "[spsc_queue]")
+{
+    cbgb::SpscQueue<int, 4> queue;
+    REQUIRE(queue.push(1));
+    REQUIRE(queue.push(2));
+    REQUIRE(queue.push(3));
+    REQUIRE(!queue.push(4));
+
+    int item = 0;
+    REQUIRE(queue.pop(item));
+    REQUIRE(item == 1);
+    REQUIRE(queue.push(4));
+    for (int expect = 2; expect <= 4; ++expect) {
+        REQUIRE(queue.pop(item));
+        REQUIRE(item == expect);
+    }
+    REQUIRE(!queue.pop(item));
+}
+
+TEST_CASE("bool SpscQueue::pop(T& item) across threads", "[spsc_queue]")
+{
+    // Every item arrives exactly once, and in order.
+    constexpr uint32_t count = 100000;
+    cbgb::SpscQueue<uint32_t, 64> queue;
+    std::thread producer([&queue] {
+        for (uint32_t i = 0; i < count;) {
+            if (queue.push(i))
+                ++i;
+        }
+    });
+
+    bool ordered = true;
+    for (uint32_t expect = 0; expect < count;) {
+        uint32_t item = 0;
+        if (!queue.pop(item))
+            continue;
+        ordered = ordered && item == expect;
+        ++expect;
+    }
+    producer.join();
+    REQUIRE(ordered);
+}
+
+TEST_CASE("size_t SpscQueue::push(const T* items, size_t count)", "[spsc_queue]")
+{
+    // Bulk transfers wrap around the end of the ring, and stop when full.
+    cbgb::SpscQueue<int, 8> queue;
+    std::array<int, 8> items = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    REQUIRE(queue.push(items.data(), 5) == 5);
+    REQUIRE(queue.size() == 5);
+
+    std::array<int, 8> out = {};
+    REQUIRE(queue.pop(out.data(), 3) == 3);
+    REQUIRE(out[0] == 1);
+    REQUIRE(out[2] == 3);
+    REQUIRE(queue.push(items.data(), items.size()) == 5);
+    REQUIRE(queue.size() == 7);
+
+    REQUIRE(queue.pop(out.data(), out.size()) == 7);
+    std::array<int, 8> expect = { 4, 5, 1, 2, 3, 4, 5, 0 };
+    out[7] = 0;
+    REQUIRE(out == expect);
+    REQUIRE(queue.pop(out.data(), out.size()) == 0);
+}
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/thread_pool.hpp"
+
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("void ThreadPool::wait()", "[thread_pool]")
+{
+    cbgb::ThreadPool pool(4);
+    std::atomic<unsigned int> count(0);
+    for (unsigned int i = 0; i < 1000; ++i)
+        pool.submit([&count] { ++count; });
+    pool.wait();
+    REQUIRE(count == 1000);
+
+    // Tasks spawned from inside a worker are waited on as well.
+    for (unsigned int i = 0; i < 10; ++i) {
+        pool.submit([&pool, &count] {
+            for (unsigned int j = 0; j < 10; ++j)
+                pool.submit([&count] { ++count; });
+        });
+    }
+    pool.wait();
+    REQUIRE(count == 1100);
+}
+
+TEST_CASE("void ThreadPool::wait() rethrows", "[thread_pool]")
+{
+    cbgb::ThreadPool pool(2);
+    pool.submit([] { throw std::runtime_error("task failed"); });
+    REQUIRE_THROWS_AS(pool.wait(), std::runtime_error);
+
+    std::atomic<unsigned int> count(0);
+    pool.submit([&count] { ++count; });
+    REQUIRE_NOTHROW(pool.wait());
+    REQUIRE(count == 1);
+}
+
+TEST_CASE("std::vector<unsigned int> get_allowed_cores()", "[thread_pool]")
+{
+    // Every core listed is one the current thread may actually be pinned to.
+    std::vector<unsigned int> cores = cbgb::get_allowed_cores();
+    REQUIRE(!cores.empty());
+#if defined(__linux__)
+    bool pinned = true;
+    std::thread worker([&cores, &pinned] {
+        for (unsigned int core : cores)
+            pinned = pinned && cbgb::pin_current_thread(core);
+    });
+    worker.join();
+    REQUIRE(pinned);
+#endif
+}
+
+TEST_CASE("ThreadPool::ThreadPool(unsigned int, bool, spdlog::logger*)", "[thread_pool]")
+{
+    // More workers than cores wrap around the allowed cores.
+    std::size_t threads = cbgb::get_allowed_cores().size() + 1;
+    cbgb::ThreadPool pool(static_cast<unsigned int>(threads), true);
+    std::atomic<unsigned int> count(0);
+    for (unsigned int i = 0; i < 100; ++i)
+        pool.submit([&count] { ++count; });
+    pool.wait();
+    REQUIRE(count == 100);
+}
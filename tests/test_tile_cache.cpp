@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/memory.hpp"
+#include "cbgb/ppu.hpp"
+#include "cbgb/tile_cache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+
+TEST_CASE("VramBitmap MemoryBus::take_dirty_vram()", "[memory_bus]")
+{
+    spdlog::logger logger("test");
+    auto bus = std::make_unique<cbgb::MemoryBus>(logger);
+    cbgb::VramBitmap dirty = bus->take_dirty_vram();
+    REQUIRE(dirty[0] == ~uint64_t(0));
+    REQUIRE(dirty[7] == ~uint64_t(0));
+
+    bus->write(0x8021, 0xFF);
+    bus->write(0x9FFF, 0xFF);
+    bus->write(0xC000, 0xFF);
+    dirty = bus->take_dirty_vram();
+    REQUIRE(dirty == cbgb::VramBitmap { 1U << 2, 0, 0, 0, 0, 0, 0, uint64_t(1) << 63 });
+    REQUIRE(bus->take_dirty_vram() == cbgb::VramBitmap {});
+
+    std::array<uint8_t, 0x20> data = {};
+    bus->load(0x97F0, data.data(), data.size());
+    dirty = bus->take_dirty_vram();
+    REQUIRE(dirty[5] == uint64_t(1) << 63);
+    REQUIRE(dirty[6] == 1);
+}
+
+TEST_CASE("void TileCache::update(const uint8_t* vram, const VramBitmap& dirty)", "[tile_cache]")
+{
+    spdlog::logger logger("test");
+    auto bus = std::make_unique<cbgb::MemoryBus>(logger);
+    const cbgb::MemoryImage& memory = bus->get_image();
+    cbgb::TileCache tiles;
+    tiles.update(&memory[cbgb::VRAM], bus->take_dirty_vram());
+    REQUIRE(tiles.get_generation() == 0);
+
+    // Last tile, row 7 is the example row from Pan Docs.
+    bus->write(0x97FE, 0x3C);
+    bus->write(0x97FF, 0x7E);
+    std::array<uint8_t, 8> expect = { 0, 2, 3, 3, 3, 3, 2, 0 };
+    std::array<uint8_t, 8> blank = {};
+    std::array<uint8_t, 8> row = {};
+    std::copy_n(tiles.get_row(383, 7), 8, row.begin());
+    REQUIRE(row == blank);
+
+    tiles.update(&memory[cbgb::VRAM], bus->take_dirty_vram());
+    std::copy_n(tiles.get_row(383, 7), 8, row.begin());
+    REQUIRE(row == expect);
+    std::copy_n(tiles.get_tile(383) + 56, 8, row.begin());
+    REQUIRE(row == expect);
+    std::copy_n(tiles.get_row(383, 6), 8, row.begin());
+    REQUIRE(row == blank);
+    REQUIRE(tiles.get_generation() == 1);
+
+    // Tiles written again with what they held already change nothing.
+    cbgb::VramBitmap all = {};
+    all.fill(~uint64_t(0));
+    tiles.update(&memory[cbgb::VRAM], all);
+    REQUIRE(tiles.get_generation() == 1);
+}
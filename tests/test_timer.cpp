@@ -0,0 +1,170 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/memory.hpp"
+#include "cbgb/timer.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+
+struct TestTimer {
+    TestTimer()
+        : bus(logger)
+        , timer(logger, bus)
+    {
+        bus.attach_timer(&timer);
+    }
+
+    bool take_interrupt()
+    {
+        bool requested = (bus.read(cbgb::IF) & cbgb::INTERRUPT_TIMER) != 0;
+        bus.write(cbgb::IF, 0x00);
+        return requested;
+    }
+
+    spdlog::logger logger { "test" };
+    cbgb::MemoryBus bus;
+    cbgb::Timer timer;
+};
+
+// TIMA counting at 262144 Hz from a freshly reset DIV, so that it goes up
+// every 4 M-cycles.
+static void start_fast(cbgb::MemoryBus& bus, uint8_t tima, uint8_t tma)
+{
+    bus.write(cbgb::DIV, 0x00);
+    bus.write(cbgb::TIMA, tima);
+    bus.write(cbgb::TMA, tma);
+    bus.write(cbgb::TAC, 0x05);
+    bus.write(cbgb::IF, 0x00);
+}
+
+TEST_CASE("uint8_t Timer::read(uint16_t address)", "[timer]")
+{
+    auto test = std::make_unique<TestTimer>();
+    cbgb::MemoryBus& bus = test->bus;
+    REQUIRE(bus.read(cbgb::DIV) == 0xAB);
+    REQUIRE(bus.read(cbgb::TAC) == 0xF8);
+
+    SECTION("DIV goes up every 64 M-cycles")
+    {
+        bus.write(cbgb::DIV, 0x12);
+        REQUIRE(bus.read(cbgb::DIV) == 0x00);
+        test->timer.advance(63);
+        REQUIRE(bus.read(cbgb::DIV) == 0x00);
+        test->timer.advance(1);
+        REQUIRE(bus.read(cbgb::DIV) == 0x01);
+        test->timer.advance(64 * 255);
+        REQUIRE(bus.read(cbgb::DIV) == 0x00);
+    }
+
+    SECTION("TIMA counts at the rate picked by TAC")
+    {
+        start_fast(bus, 0x00, 0x00);
+        test->timer.advance(40);
+        REQUIRE(bus.read(cbgb::TIMA) == 10);
+        bus.write(cbgb::TAC, 0x04);
+        test->timer.advance(215);
+        REQUIRE(bus.read(cbgb::TIMA) == 10);
+        test->timer.advance(1);
+        REQUIRE(bus.read(cbgb::TIMA) == 11);
+    }
+
+    SECTION("TIMA reads zero for one M-cycle after overflowing")
+    {
+        start_fast(bus, 0xFE, 0xF0);
+        test->timer.advance(8);
+        REQUIRE(bus.read(cbgb::TIMA) == 0x00);
+        REQUIRE_FALSE(test->take_interrupt());
+        test->timer.advance(1);
+        REQUIRE(test->take_interrupt());
+        REQUIRE(bus.read(cbgb::TIMA) == 0xF0);
+    }
+}
+
+TEST_CASE("void Timer::advance(unsigned int mcycles)", "[timer]")
+{
+    // Interrupts come at the right time without anything reading TIMA.
+    auto test = std::make_unique<TestTimer>();
+    start_fast(test->bus, 0x00, 0x00);
+    test->timer.advance(1024);
+    REQUIRE_FALSE(test->take_interrupt());
+    test->timer.advance(1);
+    REQUIRE(test->take_interrupt());
+    test->timer.advance(1023);
+    REQUIRE_FALSE(test->take_interrupt());
+    test->timer.advance(1);
+    REQUIRE(test->take_interrupt());
+
+    test->bus.write(cbgb::TAC, 0x01);
+    test->timer.advance(4096);
+    REQUIRE_FALSE(test->take_interrupt());
+}
+
+TEST_CASE("void Timer::write(uint16_t address, uint8_t value)", "[timer]")
+{
+    auto test = std::make_unique<TestTimer>();
+    cbgb::MemoryBus& bus = test->bus;
+    start_fast(bus, 0x00, 0x00);
+
+    SECTION("Resetting DIV while the selected bit is set counts an edge")
+    {
+        test->timer.advance(3);
+        bus.write(cbgb::DIV, 0x00);
+        REQUIRE(bus.read(cbgb::TIMA) == 1);
+        test->timer.advance(1);
+        bus.write(cbgb::DIV, 0x00);
+        REQUIRE(bus.read(cbgb::TIMA) == 1);
+        test->timer.advance(4);
+        REQUIRE(bus.read(cbgb::TIMA) == 2);
+    }
+
+    SECTION("Changing TAC from a set bit to a clear one counts an edge")
+    {
+        test->timer.advance(3);
+        bus.write(cbgb::TAC, 0x04);
+        REQUIRE(bus.read(cbgb::TIMA) == 1);
+        bus.write(cbgb::TAC, 0x05);
+        bus.write(cbgb::TAC, 0x01);
+        REQUIRE(bus.read(cbgb::TIMA) == 2);
+    }
+
+    SECTION("Writing TIMA right after overflowing cancels the reload")
+    {
+        bus.write(cbgb::TIMA, 0xFF);
+        test->timer.advance(4);
+        bus.write(cbgb::TIMA, 0x42);
+        test->timer.advance(1);
+        REQUIRE_FALSE(test->take_interrupt());
+        REQUIRE(bus.read(cbgb::TIMA) == 0x42);
+    }
+
+    SECTION("Writing TMA while reloading goes through to TIMA")
+    {
+        bus.write(cbgb::TIMA, 0xFF);
+        test->timer.advance(5);
+        bus.write(cbgb::TMA, 0x33);
+        bus.write(cbgb::TIMA, 0x42);
+        REQUIRE(test->take_interrupt());
+        REQUIRE(bus.read(cbgb::TIMA) == 0x33);
+    }
+}
+
+TEST_CASE("void Timer::load_state(const TimerSnapshot& snapshot)", "[timer]")
+{
+    // A restored overflow still comes due, even when saved before it was seen.
+    auto test = std::make_unique<TestTimer>();
+    start_fast(test->bus, 0xF0, 0x80);
+    test->timer.advance(50);
+
+    cbgb::TimerSnapshot snapshot {};
+    test->timer.save_state(snapshot);
+    test->timer.advance(1000);
+    REQUIRE(test->take_interrupt());
+    test->timer.load_state(snapshot);
+    test->timer.advance(14);
+    REQUIRE_FALSE(test->take_interrupt());
+    test->timer.advance(1);
+    REQUIRE(test->take_interrupt());
+    REQUIRE(test->bus.read(cbgb::TIMA) == 0x80);
+}
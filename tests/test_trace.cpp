@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/trace.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// Events recorded by other test cases stay in the trace as well, so these only
+// look for what they added themselves.
+TEST_CASE("void write_chrome_trace(std::ostream&)", "[trace]")
+{
+    using namespace std::chrono_literals;
+    cbgb::TraceClock::time_point start = cbgb::TraceClock::now();
+
+    SECTION("Events of every thread")
+    {
+        cbgb::trace_event("Test main", start, start + 1500ns);
+        std::thread worker([start] {
+            cbgb::set_trace_thread_name("Test \"worker\"");
+            cbgb::trace_event("Test worker", start + 1us, start + 3us);
+        });
+        worker.join();
+
+        std::ostringstream out;
+        cbgb::write_chrome_trace(out);
+        std::string trace = out.str();
+        REQUIRE(trace.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0) == 0);
+        std::string event = "\"name\":\"Test main\",\"cat\":\"cbgb\",\"ph\":\"X\"";
+        REQUIRE(trace.find(event) != std::string::npos);
+        REQUIRE(trace.find("\"dur\":1.500") != std::string::npos);
+        REQUIRE(trace.find("\"name\":\"Test worker\"") != std::string::npos);
+        REQUIRE(trace.find("\"dur\":2.000") != std::string::npos);
+        REQUIRE(trace.find("\"args\":{\"name\":\"Test \\\"worker\\\"\"}") != std::string::npos);
+        REQUIRE(trace.substr(trace.size() - 4) == "\n]}\n");
+    }
+
+    SECTION("Scopes")
+    {
+        {
+            cbgb::TraceScope scope("Test scope");
+            std::this_thread::sleep_for(1ms);
+        }
+        std::ostringstream out;
+        cbgb::write_chrome_trace(out);
+        std::string trace = out.str();
+        size_t event = trace.find("\"name\":\"Test scope\"");
+        REQUIRE(event != std::string::npos);
+        size_t duration = trace.find("\"dur\":", event);
+        REQUIRE(std::stod(trace.substr(duration + 6)) >= 1000.0);
+    }
+}
@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/triple_buffer.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+TEST_CASE("bool TripleBuffer::update()", "[triple_buffer]")
+{
+    auto buffer = std::make_unique<cbgb::TripleBuffer<int>>();
+    REQUIRE(!buffer->update());
+
+    buffer->get_write() = 1;
+    buffer->publish();
+    buffer->get_write() = 2;
+    buffer->publish();
+    REQUIRE(buffer->update());
+    REQUIRE(buffer->get_read() == 2);
+    REQUIRE(!buffer->update());
+    REQUIRE(buffer->get_read() == 2);
+
+    buffer->get_write() = 3;
+    buffer->publish();
+    REQUIRE(buffer->update());
+    REQUIRE(buffer->get_read() == 3);
+}
+
+TEST_CASE("const T& TripleBuffer::get_read() const across threads", "[triple_buffer]")
+{
+    // Values are only ever seen whole, and never older than one seen before.
+    using Value = std::array<uint32_t, 256>;
+    constexpr uint32_t count = 20000;
+    auto buffer = std::make_unique<cbgb::TripleBuffer<Value>>();
+    std::thread writer([&buffer] {
+        for (uint32_t i = 1; i <= count; ++i) {
+            buffer->get_write().fill(i);
+            buffer->publish();
+        }
+    });
+
+    bool whole = true;
+    bool newer = true;
+    uint32_t last = 0;
+    while (last < count) {
+        if (!buffer->update())
+            continue;
+        const Value& value = buffer->get_read();
+        for (uint32_t item : value)
+            whole = whole && item == value[0];
+        newer = newer && value[0] > last;
+        last = value[0];
+    }
+    writer.join();
+    REQUIRE(whole);
+    REQUIRE(newer);
+}
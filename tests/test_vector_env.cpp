@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/vector_env.hpp"
+#include "test_rom.hpp"
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_CASE("void VectorEnv::step(...)", "[vector_env]")
+{
+    static spdlog::logger logger("test");
+    constexpr size_t count = 6;
+    std::vector<uint8_t> rom = new_test_rom();
+    cbgb::VectorEnv env(logger, count, rom.data(), rom.size(), 3);
+    REQUIRE(env.size() == count);
+
+    env.observe_memory(0x0100, 4);
+    env.set_reward([](size_t index, const cbgb::MemoryImage& memory) {
+        return static_cast<float>(memory[0x0100] + index);
+    });
+    env.set_done([](size_t index, const cbgb::MemoryImage&) { return index == 2; });
+
+    std::vector<uint8_t> observations(count * env.get_observation_size());
+    std::array<uint8_t, count> actions = {};
+    std::array<float, count> rewards = {};
+    std::array<uint8_t, count> dones = {};
+    env.reset(observations.data());
+    env.step(actions.data(), 2, observations.data(), rewards.data(), dones.data());
+    for (size_t i = 0; i < count; ++i) {
+        REQUIRE(observations[i * 4] == 0x3C);
+        REQUIRE(observations[i * 4 + 1] == 0xC5);
+        REQUIRE(rewards[i] == static_cast<float>(0x3C + i));
+        REQUIRE(dones[i] == (i == 2 ? 1 : 0));
+        REQUIRE(env.get_machine(i).get_frame_count() == (i == 2 ? 0 : 2));
+    }
+
+    // Running off the end of the test ROM ends every episode.
+    env.step(actions.data(), 10, nullptr, nullptr, dones.data());
+    for (size_t i = 0; i < count; ++i) {
+        REQUIRE(dones[i] == 1);
+        REQUIRE(env.get_machine(i).get_frame_count() == 0);
+    }
+
+    env.observe_frame();
+    REQUIRE(env.get_observation_size() == cbgb::SCREEN_WIDTH * cbgb::SCREEN_HEIGHT);
+    REQUIRE_THROWS_AS(env.observe_memory(0xFFFF, 2), std::out_of_range);
+}
+
+TEST_CASE("void VectorEnv::observe_scaled(...)", "[vector_env]")
+{
+    static spdlog::logger logger("test");
+    constexpr size_t count = 3;
+    std::vector<uint8_t> rom = new_test_rom();
+    cbgb::VectorEnv env(logger, count, rom.data(), rom.size(), 2);
+    env.observe_scaled(84, 84, cbgb::PixelFormat::GRAYSCALE);
+    REQUIRE(env.get_observation_size() == 84 * 84);
+
+    std::vector<uint8_t> observations(count * env.get_observation_size());
+    std::array<uint8_t, count> actions = {};
+    env.reset(observations.data());
+    env.step(actions.data(), 2, observations.data(), nullptr, nullptr);
+    REQUIRE(std::all_of(observations.begin(), observations.end(), [](uint8_t pixel) {
+        return pixel == 255;
+    }));
+}
+
+TEST_CASE("VectorEnv::VectorEnv(...) game database", "[vector_env]")
+{
+    static spdlog::logger logger("test");
+    std::vector<uint8_t> rom = new_test_rom();
+    std::string title = "PREHISTORIK MAN";
+    std::copy(title.begin(), title.end(), rom.begin() + 0x0134);
+    cbgb::VectorEnv env(logger, 3, rom.data(), rom.size(), 2);
+
+    env.reset(nullptr);
+    for (size_t i = 0; i < env.size(); ++i)
+        REQUIRE(env.get_machine(i).get_ppu().get_accuracy() == cbgb::PpuAccuracy::PIXEL_FIFO);
+}
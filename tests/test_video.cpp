@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/gameboy.hpp"
+#include "cbgb/video.hpp"
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+static std::vector<uint8_t> new_random_frame()
+{
+    std::mt19937 random(1234);
+    std::vector<uint8_t> frame(cbgb::SCREEN_WIDTH * cbgb::SCREEN_HEIGHT);
+    for (uint8_t& pixel : frame)
+        pixel = static_cast<uint8_t>(random() & 3);
+    return frame;
+}
+
+// Area average of the gray level over a source rectangle, done the slow way.
+static double reference_gray(
+    const std::vector<uint8_t>& frame, unsigned int width, unsigned int height, unsigned int x,
+    unsigned int y
+)
+{
+    double left = static_cast<double>(x) * cbgb::SCREEN_WIDTH / width;
+    double right = static_cast<double>(x + 1) * cbgb::SCREEN_WIDTH / width;
+    double top = static_cast<double>(y) * cbgb::SCREEN_HEIGHT / height;
+    double bottom = static_cast<double>(y + 1) * cbgb::SCREEN_HEIGHT / height;
+    double total = 0.0;
+    for (unsigned int row = 0; row < cbgb::SCREEN_HEIGHT; ++row) {
+        double rows = std::min<double>(row + 1, bottom) - std::max<double>(row, top);
+        if (rows <= 0.0)
+            continue;
+        for (unsigned int column = 0; column < cbgb::SCREEN_WIDTH; ++column) {
+            double columns = std::min<double>(column + 1, right) - std::max<double>(column, left);
+            if (columns <= 0.0)
+                continue;
+            double gray = 255.0 - 85.0 * frame[row * cbgb::SCREEN_WIDTH + column];
+            total += gray * rows * columns;
+        }
+    }
+    return total / ((right - left) * (bottom - top));
+}
+
+TEST_CASE("void Downscaler::push_line(unsigned int line, const uint8_t* shades)", "[video]")
+{
+    std::vector<uint8_t> frame = new_random_frame();
+
+    SECTION("Area averaged grayscale")
+    {
+        for (auto [width, height] : { std::pair(84U, 84U), std::pair(80U, 72U) }) {
+            cbgb::Downscaler scaler(width, height, cbgb::PixelFormat::GRAYSCALE);
+            scaler.scale_frame(frame.data());
+            REQUIRE(scaler.size() == width * height);
+            for (unsigned int y = 0; y < height; ++y) {
+                for (unsigned int x = 0; x < width; ++x) {
+                    double expect = reference_gray(frame, width, height, x, y);
+                    REQUIRE(std::abs(scaler.data()[y * width + x] - expect) <= 1.5);
+                }
+            }
+        }
+    }
+
+    SECTION("Nearest shade")
+    {
+        cbgb::Downscaler scaler(80, 72, cbgb::PixelFormat::SHADE);
+        scaler.scale_frame(frame.data());
+        REQUIRE(scaler.data()[0] == frame[cbgb::SCREEN_WIDTH + 1]);
+        REQUIRE(scaler.data()[80 * 71 + 79] == frame.back());
+    }
+
+    SECTION("Full size grayscale")
+    {
+        cbgb::Downscaler scaler(
+            cbgb::SCREEN_WIDTH, cbgb::SCREEN_HEIGHT, cbgb::PixelFormat::GRAYSCALE
+        );
+        scaler.scale_frame(frame.data());
+        for (size_t i = 0; i < frame.size(); ++i)
+            REQUIRE(scaler.data()[i] == 255 - 85 * frame[i]);
+    }
+
+    REQUIRE_THROWS_AS(cbgb::Downscaler(161, 84, cbgb::PixelFormat::SHADE), std::invalid_argument);
+}
+
+TEST_CASE("void shades_to_argb(const uint8_t* shades, ...)", "[video]")
+{
+    // Odd count to cover the scalar tail, upper bits of shades are ignored.
+    constexpr std::array<uint32_t, 4> colors = { 0xFFE0F8D0, 0xFF88C070, 0xFF346856, 0xFF081820 };
+    std::vector<uint8_t> frame = new_random_frame();
+    frame[5] = 0xFE;
+    std::vector<uint32_t> pixels(frame.size() - 3);
+    cbgb::shades_to_argb(frame.data(), colors, pixels.data(), pixels.size());
+    for (size_t i = 0; i < pixels.size(); ++i)
+        REQUIRE(pixels[i] == colors[frame[i] & 3]);
+}
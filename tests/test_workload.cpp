@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2025 Jason Pena <jasonpena@awkless.com>
+// SPDX-License-Identifier: MIT
+
+#include "cbgb/cpu.hpp"
+#include "cbgb/memory.hpp"
+#include "cbgb/workload.hpp"
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+constexpr size_t PROGRAM_SIZE = 0x4000;
+
+TEST_CASE("std::vector<uint8_t> WorkloadGenerator::generate(size_t size)", "[workload]")
+{
+    SECTION("Runs through without touching its own code")
+    {
+        const std::array<cbgb::WorkloadMix, 4> mixes = {
+            cbgb::WorkloadMix::ALU,
+            cbgb::WorkloadMix::LOAD_STORE,
+            cbgb::WorkloadMix::INDIRECT,
+            cbgb::WorkloadMix::STACK,
+        };
+        for (cbgb::WorkloadMix mix : mixes) {
+            spdlog::logger logger("test");
+            auto bus = std::make_unique<cbgb::MemoryBus>(logger);
+            cbgb::WorkloadGenerator generator(cbgb::get_workload_histogram(mix), 1234);
+            std::vector<uint8_t> program = generator.generate(PROGRAM_SIZE);
+            REQUIRE(program.size() == PROGRAM_SIZE);
+            bus->load(0x0000, program.data(), program.size());
+
+            cbgb::Sm83 cpu(logger, *bus);
+            cbgb::Sm83Snapshot start = {};
+            cpu.save_state(start);
+            start.pc = 0x0000;
+            cpu.load_state(start);
+            while (cpu.get_state().pc < PROGRAM_SIZE)
+                REQUIRE_NOTHROW(cpu.step());
+
+            REQUIRE(cpu.get_state().sp == 0xDFDF);
+            const cbgb::MemoryImage& image = bus->get_image();
+            REQUIRE(std::equal(program.begin(), program.end(), image.begin()));
+        }
+    }
+
+    SECTION("Repeatable")
+    {
+        cbgb::OpcodeHistogram histogram = cbgb::get_workload_histogram(cbgb::WorkloadMix::ALU);
+        cbgb::WorkloadGenerator first(histogram, 42);
+        cbgb::WorkloadGenerator second(histogram, 42);
+        cbgb::WorkloadGenerator other(histogram, 43);
+        std::vector<uint8_t> program = first.generate(PROGRAM_SIZE);
+        REQUIRE(program == second.generate(PROGRAM_SIZE));
+        REQUIRE(program != other.generate(PROGRAM_SIZE));
+        REQUIRE(program != first.generate(PROGRAM_SIZE));
+    }
+
+    SECTION("Custom histogram")
+    {
+        // INC A alone, along with LD B, n, which the generator never emits.
+        cbgb::OpcodeHistogram histogram = {};
+        histogram[0x3C] = 10;
+        histogram[0x06] = 1000;
+        cbgb::WorkloadGenerator generator(histogram, 7);
+        std::vector<uint8_t> program = generator.generate(64);
+        REQUIRE(std::all_of(program.begin() + 12, program.end(), [](uint8_t opcode) {
+            return opcode == 0x3C || opcode == 0x7F;
+        }));
+        REQUIRE(std::count(program.begin(), program.end(), 0x3C) >= 40);
+    }
+
+    SECTION("Invalid")
+    {
+        cbgb::OpcodeHistogram histogram = {};
+        histogram[0x06] = 1;
+        histogram[0xD3] = 1;
+        REQUIRE_THROWS_AS(cbgb::WorkloadGenerator(histogram, 0), std::invalid_argument);
+
+        histogram[0x3C] = 1;
+        cbgb::WorkloadGenerator generator(histogram, 0);
+        REQUIRE_THROWS_AS(generator.generate(8), std::invalid_argument);
+    }
+}
+
+TEST_CASE(
+    "void WorkloadGenerator::load(MemoryBus& bus, uint16_t address, size_t size)", "[workload]"
+)
+{
+    spdlog::logger logger("test");
+    auto bus = std::make_unique<cbgb::MemoryBus>(logger);
+    cbgb::OpcodeHistogram histogram = cbgb::get_workload_histogram(cbgb::WorkloadMix::STACK);
+    cbgb::WorkloadGenerator generator(histogram, 99);
+    cbgb::WorkloadGenerator expect(histogram, 99);
+
+    generator.load(*bus, 0x0100, 0x1000);
+    std::vector<uint8_t> program = expect.generate(0x1000);
+    const cbgb::MemoryImage& image = bus->get_image();
+    REQUIRE(std::equal(program.begin(), program.end(), image.begin() + 0x0100));
+    REQUIRE_THROWS_AS(generator.load(*bus, 0x7000, 0x2000), std::invalid_argument);
+}